@@ -0,0 +1,124 @@
+#!/bin/bash
+echo "Running examples, a moment please..."
+
+# Prepare environment.
+if [[ "$OSTYPE" != "linux-gnu"* ]]; then
+  echo "Unsupported OS: $OSTYPE"
+  exit 1
+fi
+if [[ "$(uname -m)" == "x86_64" ]]; then
+  bin="gbbasic/x64_release"
+else
+  bin="gbbasic/x86_release"
+fi
+examples="gbbasic/examples"
+out="output/runner"
+
+# Colorizer.
+color_echo() {
+  local color=$1
+  local message=$2
+  local reset='\033[0m'
+
+  case $color in
+    "2F")
+      echo -e "\033[42;37m${message}${reset}"
+      ;;
+    "3F")
+      echo -e "\033[46;37m${message}${reset}"
+      ;;
+    "4F")
+      echo -e "\033[41;37m${message}${reset}"
+      ;;
+    *)
+      echo -e "${message}"
+      ;;
+  esac
+}
+
+# To clear run cache only.
+if [ "$1" == "clear" ]; then
+  echo "Cleaning run artifacts..."
+  rm -rf "$out"
+  echo "Clean done."
+  exit 0
+fi
+
+# Get the run options.
+# Usage: gbbrunner.sh [FRAMES] [BASELINE_DIR]
+#   FRAMES        frames to run for each example, defaults to 600; each one
+#                 runs twice to verify that it's deterministic
+#   BASELINE_DIR  a previous "output/runner" to compare the reports with,
+#                 everything but the timing is compared
+frames=600
+if [ -n "$1" ]; then
+  frames=$1
+fi
+baseline=""
+if [ -n "$2" ]; then
+  baseline=$2
+fi
+
+if [ ! -x "$bin/gbbasic" ] || [ ! -x "$bin/gbbrunner" ]; then
+  echo "Build \"gbbasic\" and \"gbbrunner\" with \"gbbasic.linux/CMakeLists.txt\" first."
+  exit 1
+fi
+if [ ! -d "$examples" ]; then
+  echo "$examples doesn't exist."
+  exit 1
+fi
+
+# Run.
+color_echo "2F" "Running..."
+mkdir -p "$out"
+
+failed=0
+changed=0
+total=0
+for src in "$examples"/*.gbb; do
+  name=$(basename "$src" .gbb)
+  rom="$out/$name.gb"
+  report="$out/$name.txt"
+  total=$((total + 1))
+
+  color_echo "3F" "$total. $name"
+  rm -f "$rom" "$report"
+  "$bin/gbbasic" "$src" -L -o "$rom" > "$out/$name.log" 2>&1
+  if [ ! -f "$rom" ]; then
+    color_echo "4F" "Compiling failed, see $out/$name.log."
+    failed=$((failed + 1))
+    continue
+  fi
+  "$bin/gbbrunner" "$rom" -f "$frames" -e 60 -r c0dc:0800 -v > "$report"
+  ret=$?
+  if [ $ret -eq 3 ]; then
+    color_echo "4F" "Two runs diverged, see $report."
+    failed=$((failed + 1))
+    continue
+  elif [ $ret -ne 0 ]; then
+    color_echo "4F" "Running failed, see $report."
+    failed=$((failed + 1))
+    continue
+  fi
+  grep "^busy ticks:\|^lag frames:\|^time:" "$report"
+
+  if [ -n "$baseline" ]; then
+    if [ ! -f "$baseline/$name.txt" ]; then
+      echo "No baseline."
+    elif ! diff <(grep -v "^time:" "$baseline/$name.txt") <(grep -v "^time:" "$report") > /dev/null; then
+      color_echo "4F" "Differs from baseline."
+      changed=$((changed + 1))
+    else
+      echo "Same as baseline."
+    fi
+  fi
+done
+echo
+
+# Finish.
+echo "Examples: $total, failed: $failed, differs: $changed."
+if [ $failed -ne 0 ] || [ $changed -ne 0 ]; then
+  exit 1
+fi
+echo "Running done!"
+exit 0
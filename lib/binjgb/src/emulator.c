@@ -725,6 +725,7 @@ struct Emulator {
   PaletteRGBA sgb_pal[4];
   CgbColorCurve cgb_color_curve;
   ApuLog apu_log;
+  u32 halt_count; /* HALT instructions executed, not a part of the state. */ // GBB EXTENSION.
 #ifdef RGBDS_LIVE
   Bool breakpoint[0x10000];
 #endif
@@ -4546,7 +4547,7 @@ static void execute_instruction(Emulator* e) {
     case 0x73: LD_MR_R(HL, E); break;
     case 0x74: LD_MR_R(HL, H); break;
     case 0x75: LD_MR_R(HL, L); break;
-    case 0x76: HALT; break;
+    case 0x76: HALT; e->halt_count++; break; // GBB EXTENSION.
     case 0x77: LD_MR_R(HL, A); break;
     LD_R_OPS(0x78, A)
     REG_OPS(0x80, ADD)
@@ -4911,6 +4912,10 @@ void emulator_set_duty_ticks(Emulator* e, Ticks ticks) {
   e->state.duty_tick = ticks;
 }
 
+u32 emulator_get_halt_count(Emulator* e) { // GBB EXTENSION.
+  return e->halt_count;
+}
+
 u32 emulator_get_ppu_frame(Emulator* e) {
   return PPU.frame;
 }
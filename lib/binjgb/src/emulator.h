@@ -215,6 +215,7 @@ AudioBuffer* emulator_get_audio_buffer(Emulator*);
 Ticks emulator_get_ticks(Emulator*);
 Ticks emulator_get_duty_ticks(Emulator*);
 void emulator_set_duty_ticks(Emulator*, Ticks);
+u32 emulator_get_halt_count(Emulator*); // GBB EXTENSION.
 u32 emulator_get_ppu_frame(Emulator*);
 u32 audio_buffer_get_frames(AudioBuffer*);
 void emulator_set_builtin_palette(Emulator*, u32 index);
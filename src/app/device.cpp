@@ -29,7 +29,11 @@ Device* Device::create(CoreTypes type, Protocol* dbgListener) {
 	Device* result = nullptr;
 	switch (type) {
 	case CoreTypes::BINJGB:
-		result = new DeviceBinjgb(dbgListener);
+		result = new DeviceBinjgb(dbgListener, false);
+
+		break;
+	case CoreTypes::BINJGB_THREADED:
+		result = new DeviceBinjgb(dbgListener, true);
 
 		break;
 	default:
@@ -12,6 +12,8 @@
 #include "../gbbasic.h"
 #include "../utils/bytes.h"
 #include "../utils/colour.h"
+#include "profiler.h"
+#include "recording.h"
 #include <deque>
 
 /*
@@ -43,6 +45,13 @@
 #	define DEVICE_KEY_BUFFER_LENGTH 1 // 1 slot in pending buffer plus 1 `KEYC` register.
 #endif /* DEVICE_KEY_BUFFER_LENGTH */
 
+#ifndef DEVICE_DEFAULT_REWIND_BUDGET_MB
+#	define DEVICE_DEFAULT_REWIND_BUDGET_MB 0 // Rewinding is disabled with 0.
+#endif /* DEVICE_DEFAULT_REWIND_BUDGET_MB */
+#ifndef DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL
+#	define DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL 45 // In frames, the others are stored as differences.
+#endif /* DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL */
+
 /* ===========================================================================} */
 
 /*
@@ -56,6 +65,7 @@ public:
 
 	enum class CoreTypes {
 		BINJGB,
+		BINJGB_THREADED, // Runs the emulator core on its own thread.
 		COUNT
 	};
 
@@ -66,6 +76,12 @@ public:
 		COLORED_EXTENDED
 	};
 
+	enum class RecordingModes {
+		NONE,
+		RECORD,
+		REPLAY
+	};
+
 	enum class CursorTypes {
 		NONE,
 		POINTER,
@@ -163,6 +179,24 @@ public:
 	virtual bool readSram(const Bytes* bytes) = 0;
 	virtual bool writeSram(Bytes* bytes) = 0;
 
+	virtual bool readState(const Bytes* bytes) = 0;
+	virtual bool writeState(Bytes* bytes) = 0;
+
+	virtual size_t rewindBudget(int* keyframeInterval /* nullable */) const = 0;
+	virtual void rewindBudget(size_t bytes /* 0 to disable */, int keyframeInterval /* in frames */) = 0; // Takes effect on next opening.
+	virtual bool rewinding(void) const = 0;
+	virtual bool rewindBegin(void) = 0;
+	virtual bool rewindTo(double seconds /* back from the beginning */, double* reached /* nullable */) = 0;
+	virtual void rewindEnd(void) = 0;
+
+	virtual int profilerInterval(void) const = 0;
+	virtual void profilerInterval(int ticks /* 0 to disable */, const std::string &symbols, const Profiler::Line::Array &lines) = 0; // Takes effect on next opening.
+	virtual bool profile(Profiler::Report &report) = 0;
+
+	virtual RecordingModes recordingMode(void) const = 0;
+	virtual void recordingMode(RecordingModes mode, const Recording &replay /* for `RecordingModes::REPLAY` */) = 0; // Takes effect on next opening.
+	virtual bool recordingEnd(Recording &recording, Recording::Report &report) = 0; // Ends the session since opened.
+
 	static Device* create(CoreTypes type, Protocol* dbgListener /* nullable */);
 	static void destroy(Device* ptr);
 };
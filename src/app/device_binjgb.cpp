@@ -7,6 +7,7 @@
 */
 
 #include "device_binjgb.h"
+#include "device_registers.h"
 #include "../utils/datetime.h"
 #include "../utils/encoding.h"
 #include "../utils/input.h"
@@ -14,157 +15,13 @@
 #include "../utils/renderer.h"
 #include "../utils/text.h"
 #include "../utils/texture.h"
+#include "../../lib/binjgb/src/joypad.h"
 
 /*
 ** {===========================================================================
 ** Macros and constants
 */
 
-#ifndef DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS
-#	define DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS 0x0143
-#endif /* DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS */
-#ifndef DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS
-#	define DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS 0x0146
-#endif /* DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS */
-#ifndef DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS
-#	define DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS 0x0147
-#endif /* DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS */
-#ifndef DEVICE_BINJGB_ROM_SIZE_ADDRESS
-#	define DEVICE_BINJGB_ROM_SIZE_ADDRESS 0x0148
-#endif /* DEVICE_BINJGB_ROM_SIZE_ADDRESS */
-#ifndef DEVICE_BINJGB_SRAM_SIZE_ADDRESS
-#	define DEVICE_BINJGB_SRAM_SIZE_ADDRESS 0x0149
-#endif /* DEVICE_BINJGB_SRAM_SIZE_ADDRESS */
-
-// For `DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS`.
-#ifndef DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE 0x00
-#endif /* DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE */
-#ifndef DEVICE_BINJGB_CARTRIDGE_CGB_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_CGB_TYPE 0x80 // The cartridge supports colored functions, but works on classic also.
-#endif /* DEVICE_BINJGB_CARTRIDGE_CGB_TYPE */
-#ifndef DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE 0xc0 // The cartridge works on colored device only (physically the same as 0x80).
-#endif /* DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE */
-#ifndef DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE 0x20 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE */
-
-// For `DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS`.
-#ifndef DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE 0x00
-#endif /* DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE */
-#ifndef DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE
-#	define DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE 0x03 // The cartridge supports super functions.
-#endif /* DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE */
-
-#ifndef DEVICE_BINJGB_EXTENSION_AREA_SIZE
-#	define DEVICE_BINJGB_EXTENSION_AREA_SIZE 0x60 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_EXTENSION_AREA_SIZE */
-#ifndef DEVICE_BINJGB_EXTENSION_START_ADDRESS
-#	define DEVICE_BINJGB_EXTENSION_START_ADDRESS 0xfea0 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_EXTENSION_START_ADDRESS */
-#ifndef DEVICE_BINJGB_EXTENSION_STATUS_REG
-#	define DEVICE_BINJGB_EXTENSION_STATUS_REG 0xfea0 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_EXTENSION_STATUS_REG */
-#ifndef DEVICE_BINJGB_PLATFORM_FLAGS_REG
-#	define DEVICE_BINJGB_PLATFORM_FLAGS_REG 0xfea1 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_FLAGS_REG */
-#ifndef DEVICE_BINJGB_LOCALIZATION_FLAGS_REG
-#	define DEVICE_BINJGB_LOCALIZATION_FLAGS_REG 0xfea2 // GBB EXTENSION. Not documented.
-#endif /* DEVICE_BINJGB_LOCALIZATION_FLAGS_REG */
-#ifndef DEVICE_BINJGB_TOUCH_X_REG
-#	define DEVICE_BINJGB_TOUCH_X_REG 0xfea4 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TOUCH_X_REG */
-#ifndef DEVICE_BINJGB_TOUCH_Y_REG
-#	define DEVICE_BINJGB_TOUCH_Y_REG 0xfea5 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TOUCH_Y_REG */
-#ifndef DEVICE_BINJGB_TOUCH_PRESSED_REG
-#	define DEVICE_BINJGB_TOUCH_PRESSED_REG 0xfea6 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TOUCH_PRESSED_REG */
-#ifndef DEVICE_BINJGB_KEY_MODIFIERS_REG
-#	define DEVICE_BINJGB_KEY_MODIFIERS_REG 0xfea8 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_KEY_MODIFIERS_REG */
-#ifndef DEVICE_BINJGB_KEYBOARD_PRESSED_REG
-#	define DEVICE_BINJGB_KEYBOARD_PRESSED_REG 0xfea9 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_KEYBOARD_PRESSED_REG */
-#ifndef DEVICE_BINJGB_STREAMING_STATUS_REG
-#	define DEVICE_BINJGB_STREAMING_STATUS_REG 0xfeac // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_STATUS_REG */
-#ifndef DEVICE_BINJGB_STREAMING_ADDRESS
-#	define DEVICE_BINJGB_STREAMING_ADDRESS 0xfead // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_ADDRESS */
-#ifndef DEVICE_BINJGB_TRANSFER_STATUS_REG
-#	define DEVICE_BINJGB_TRANSFER_STATUS_REG 0xfeaf // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_STATUS_REG */
-#ifndef DEVICE_BINJGB_TRANSFER_ADDRESS
-#	define DEVICE_BINJGB_TRANSFER_ADDRESS 0xfeb0 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_ADDRESS */
-#ifndef DEVICE_BINJGB_TRANSFER_MAX_SIZE
-#	define DEVICE_BINJGB_TRANSFER_MAX_SIZE 0x40 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_MAX_SIZE */
-
-// For `DEVICE_BINJGB_EXTENSION_STATUS_REG`.
-#ifndef DEVICE_BINJGB_CPU_CGB_TYPE
-#	define DEVICE_BINJGB_CPU_CGB_TYPE 0x11 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_CPU_CGB_TYPE */
-#ifndef DEVICE_BINJGB_CPU_GB1_TYPE
-#	define DEVICE_BINJGB_CPU_GB1_TYPE 0x21 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_CPU_GB1_TYPE */
-#ifndef DEVICE_BINJGB_CPU_GB2_TYPE
-#	define DEVICE_BINJGB_CPU_GB2_TYPE 0x31 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_CPU_GB2_TYPE */
-
-// For `DEVICE_BINJGB_PLATFORM_FLAGS_REG`.
-#ifndef DEVICE_BINJGB_PLATFORM_EDITOR_FLAG
-#	define DEVICE_BINJGB_PLATFORM_EDITOR_FLAG 0b10000000 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_EDITOR_FLAG */
-#ifndef DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG
-#	define DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG 0b00000001 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG */
-#ifndef DEVICE_BINJGB_PLATFORM_LINUX_FLAG
-#	define DEVICE_BINJGB_PLATFORM_LINUX_FLAG 0b00000010 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_LINUX_FLAG */
-#ifndef DEVICE_BINJGB_PLATFORM_MACOS_FLAG
-#	define DEVICE_BINJGB_PLATFORM_MACOS_FLAG 0b00000100 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_MACOS_FLAG */
-#ifndef DEVICE_BINJGB_PLATFORM_HTML_FLAG
-#	define DEVICE_BINJGB_PLATFORM_HTML_FLAG 0b00001000 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_PLATFORM_HTML_FLAG */
-
-// For `DEVICE_BINJGB_TOUCH_PRESSED_REG`.
-#ifndef DEVICE_BINJGB_MOUSE_BUTTON_0
-#	define DEVICE_BINJGB_MOUSE_BUTTON_0 0x01 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_MOUSE_BUTTON_0 */
-#ifndef DEVICE_BINJGB_MOUSE_BUTTON_1
-#	define DEVICE_BINJGB_MOUSE_BUTTON_1 0x02 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_MOUSE_BUTTON_1 */
-
-// For `DEVICE_BINJGB_STREAMING_STATUS_REG`.
-#ifndef DEVICE_BINJGB_STREAMING_STATUS_READY
-#	define DEVICE_BINJGB_STREAMING_STATUS_READY 0x00 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_STATUS_READY */
-#ifndef DEVICE_BINJGB_STREAMING_STATUS_BUSY
-#	define DEVICE_BINJGB_STREAMING_STATUS_BUSY 0x01 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_STATUS_BUSY */
-#ifndef DEVICE_BINJGB_STREAMING_STATUS_FILLED
-#	define DEVICE_BINJGB_STREAMING_STATUS_FILLED 0x02 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_STATUS_FILLED */
-#ifndef DEVICE_BINJGB_STREAMING_STATUS_EOS
-#	define DEVICE_BINJGB_STREAMING_STATUS_EOS 0x80 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_STREAMING_STATUS_EOS */
-
-// For `DEVICE_BINJGB_TRANSFER_STATUS_REG`.
-#ifndef DEVICE_BINJGB_TRANSFER_STATUS_READY
-#	define DEVICE_BINJGB_TRANSFER_STATUS_READY 0x00 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_STATUS_READY */
-#ifndef DEVICE_BINJGB_TRANSFER_STATUS_BUSY
-#	define DEVICE_BINJGB_TRANSFER_STATUS_BUSY 0x01 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_STATUS_BUSY */
-#ifndef DEVICE_BINJGB_TRANSFER_STATUS_FILLED
-#	define DEVICE_BINJGB_TRANSFER_STATUS_FILLED 0x02 // GBB EXTENSION.
-#endif /* DEVICE_BINJGB_TRANSFER_STATUS_FILLED */
-
 #ifndef DEVICE_BINJGB_SRAM_MAX_SIZE
 #	define DEVICE_BINJGB_SRAM_MAX_SIZE (1024 * 128)
 #endif /* DEVICE_BINJGB_SRAM_MAX_SIZE */
@@ -184,11 +41,55 @@
 #ifndef DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8
 #	define DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8(VAL, VOL) ((VOL) * (VAL) * (1 / 255.0f))
 #endif /* DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8 */
+#ifndef DEVICE_BINJGB_AUDIO_CHUNK_FRAMES
+#	define DEVICE_BINJGB_AUDIO_CHUNK_FRAMES 1024 // Per audio event from the emulator, ~21ms.
+#endif /* DEVICE_BINJGB_AUDIO_CHUNK_FRAMES */
+#ifndef DEVICE_BINJGB_AUDIO_DEVICE_FRAMES
+#	define DEVICE_BINJGB_AUDIO_DEVICE_FRAMES 1024 // Of the hardware buffer, ~21ms.
+#endif /* DEVICE_BINJGB_AUDIO_DEVICE_FRAMES */
+#ifndef DEVICE_BINJGB_AUDIO_LATENCY_SECONDS
+#	define DEVICE_BINJGB_AUDIO_LATENCY_SECONDS 0.04 // The target of the queued audio, ~2 frames.
+#endif /* DEVICE_BINJGB_AUDIO_LATENCY_SECONDS */
+#ifndef DEVICE_BINJGB_AUDIO_RATE_ADJUSTMENT
+#	define DEVICE_BINJGB_AUDIO_RATE_ADJUSTMENT 0.005 // Up to 0.5%, inaudible.
+#endif /* DEVICE_BINJGB_AUDIO_RATE_ADJUSTMENT */
+
+#ifndef AUDIO_RESAMPLER_CHANNELS
+#	define AUDIO_RESAMPLER_CHANNELS 2
+#endif /* AUDIO_RESAMPLER_CHANNELS */
+#ifndef AUDIO_RESAMPLER_PHASE_BITS
+#	define AUDIO_RESAMPLER_PHASE_BITS 8
+#endif /* AUDIO_RESAMPLER_PHASE_BITS */
+#ifndef AUDIO_RESAMPLER_HALF_TAPS
+#	define AUDIO_RESAMPLER_HALF_TAPS 8 // Per unit of the ratio.
+#endif /* AUDIO_RESAMPLER_HALF_TAPS */
+#ifndef AUDIO_RESAMPLER_MAX_HALF_TAPS
+#	define AUDIO_RESAMPLER_MAX_HALF_TAPS 64
+#endif /* AUDIO_RESAMPLER_MAX_HALF_TAPS */
+#ifndef AUDIO_RESAMPLER_CUTOFF
+#	define AUDIO_RESAMPLER_CUTOFF 0.9 // Relative to the output Nyquist frequency.
+#endif /* AUDIO_RESAMPLER_CUTOFF */
 
 #ifndef DEVICE_BINJGB_DELTA_TIME_MIN_SECONDS
 #	define DEVICE_BINJGB_DELTA_TIME_MIN_SECONDS 0.024
 #endif /* DEVICE_BINJGB_DELTA_TIME_MIN_SECONDS */
 
+#ifndef DEVICE_BINJGB_THREAD_SLICE_MILLISECONDS
+#	define DEVICE_BINJGB_THREAD_SLICE_MILLISECONDS 4
+#endif /* DEVICE_BINJGB_THREAD_SLICE_MILLISECONDS */
+#ifndef DEVICE_BINJGB_THREAD_COMMAND_QUEUE_SIZE
+#	define DEVICE_BINJGB_THREAD_COMMAND_QUEUE_SIZE 64
+#endif /* DEVICE_BINJGB_THREAD_COMMAND_QUEUE_SIZE */
+#ifndef DEVICE_BINJGB_THREAD_VIDEO_QUEUE_SIZE
+#	define DEVICE_BINJGB_THREAD_VIDEO_QUEUE_SIZE 3
+#endif /* DEVICE_BINJGB_THREAD_VIDEO_QUEUE_SIZE */
+#ifndef DEVICE_BINJGB_THREAD_AUDIO_QUEUE_SIZE
+#	define DEVICE_BINJGB_THREAD_AUDIO_QUEUE_SIZE 8
+#endif /* DEVICE_BINJGB_THREAD_AUDIO_QUEUE_SIZE */
+#ifndef DEVICE_BINJGB_THREAD_EVENT_QUEUE_SIZE
+#	define DEVICE_BINJGB_THREAD_EVENT_QUEUE_SIZE 16
+#endif /* DEVICE_BINJGB_THREAD_EVENT_QUEUE_SIZE */
+
 /* ===========================================================================} */
 
 /*
@@ -198,18 +99,6 @@
 
 #define RAM_BANKS_ONLY     0x0f
 
-#define RTC_TIMER_STOP     0b01000000
-
-#define RTC_VALUE_SEC      0x08
-#define RTC_VALUE_MIN      0x09
-#define RTC_VALUE_HOUR     0x0a
-#define RTC_VALUE_DAY      0x0b
-#define RTC_VALUE_FLAGS    0x0c
-
-#define RTC_SELECT_REG     0x4000
-#define RTC_LATCH_REG      0x6000
-#define RTC_VALUE_REG      0xa000
-
 #define SWITCH_RAM(E, B)   emulator_write_u8_raw((E), 0x4000, (B))
 
 #define ENABLED_RAM(E)     (emulator_read_u8_raw((E), 0x0000) == 0x0a)
@@ -221,29 +110,29 @@ inline void deviceBinjgbRtcSelect(Emulator* emu, UInt8 what) {
 }
 
 inline void deviceBinjgbRtcStart(Emulator* emu, UInt8 start) {
-	deviceBinjgbRtcSelect(emu, RTC_VALUE_FLAGS);
+	deviceBinjgbRtcSelect(emu, DEVICE_BINJGB_RTC_VALUE_FLAGS);
 	if (start) {
-		u8 val = emulator_read_u8_raw(emu, RTC_VALUE_REG);
-		val &= ~RTC_TIMER_STOP;
-		emulator_write_u8_raw(emu, RTC_VALUE_REG, val);
+		u8 val = emulator_read_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG);
+		val &= ~DEVICE_BINJGB_RTC_TIMER_STOP;
+		emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG, val);
 	} else {
-		u8 val = emulator_read_u8_raw(emu, RTC_VALUE_REG);
-		val |= RTC_TIMER_STOP;
-		emulator_write_u8_raw(emu, RTC_VALUE_REG, val);
+		u8 val = emulator_read_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG);
+		val |= DEVICE_BINJGB_RTC_TIMER_STOP;
+		emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG, val);
 	}
 }
 inline void deviceBinjgbRtcLatch(Emulator* emu) {
-	emulator_write_u8_raw(emu, RTC_LATCH_REG, 0);
-	emulator_write_u8_raw(emu, RTC_LATCH_REG, 1);
+	emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_LATCH_REG, 0);
+	emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_LATCH_REG, 1);
 }
 
 inline UInt16 deviceBinjgbRtcGet(Emulator* emu, UInt8 part) {
 	UInt16 ret;
 	deviceBinjgbRtcSelect(emu, part);
-	ret = RTC_VALUE_REG;
-	if (part == RTC_VALUE_DAY) {
-		deviceBinjgbRtcSelect(emu, RTC_VALUE_FLAGS);
-		if (RTC_VALUE_REG & 0x01)
+	ret = DEVICE_BINJGB_RTC_VALUE_REG;
+	if (part == DEVICE_BINJGB_RTC_VALUE_DAY) {
+		deviceBinjgbRtcSelect(emu, DEVICE_BINJGB_RTC_VALUE_FLAGS);
+		if (DEVICE_BINJGB_RTC_VALUE_REG & 0x01)
 			ret |= 0x0100u;
 	}
 
@@ -251,14 +140,149 @@ inline UInt16 deviceBinjgbRtcGet(Emulator* emu, UInt8 part) {
 }
 inline void deviceBinjgbRtcSet(Emulator* emu, UInt8 part, UInt16 val) {
 	deviceBinjgbRtcSelect(emu, part);
-	emulator_write_u8_raw(emu, RTC_VALUE_REG, (u8)val);
-	if (part == RTC_VALUE_DAY) {
-		deviceBinjgbRtcSelect(emu, RTC_VALUE_FLAGS);
-		const u8 old = emulator_read_u8_raw(emu, RTC_VALUE_REG);
+	emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG, (u8)val);
+	if (part == DEVICE_BINJGB_RTC_VALUE_DAY) {
+		deviceBinjgbRtcSelect(emu, DEVICE_BINJGB_RTC_VALUE_FLAGS);
+		const u8 old = emulator_read_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG);
 		const u8 new_ = (old & 0x0e) | (UInt8)((val >> 8) & 0x01);
-		emulator_write_u8_raw(emu, RTC_VALUE_REG, new_);
+		emulator_write_u8_raw(emu, DEVICE_BINJGB_RTC_VALUE_REG, new_);
+	}
+}
+
+static const char* deviceBinjgbDeviceTypeName(Device::DeviceTypes type) {
+	// The same as the runner's "-d" argument.
+	switch (type) {
+	case Device::DeviceTypes::CLASSIC:          return "classic";
+	case Device::DeviceTypes::COLORED:          return "colored";
+	case Device::DeviceTypes::CLASSIC_EXTENDED: return "classic_ext";
+	case Device::DeviceTypes::COLORED_EXTENDED: return "colored_ext";
+	default:                                    return "";
 	}
 }
+static bool deviceBinjgbDeviceTypeOf(const std::string &name, Device::DeviceTypes &type) {
+	if (name == "classic")          type = Device::DeviceTypes::CLASSIC;
+	else if (name == "colored")     type = Device::DeviceTypes::COLORED;
+	else if (name == "classic_ext") type = Device::DeviceTypes::CLASSIC_EXTENDED;
+	else if (name == "colored_ext") type = Device::DeviceTypes::COLORED_EXTENDED;
+	else                            return false;
+
+	return true;
+}
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Audio resampler
+*/
+
+AudioResampler::AudioResampler() {
+	reset();
+}
+
+void AudioResampler::reset(void) {
+	_history.assign(AUDIO_RESAMPLER_MAX_HALF_TAPS * AUDIO_RESAMPLER_CHANNELS, 0.0f);
+	_position = (UInt64)AUDIO_RESAMPLER_MAX_HALF_TAPS << 32;
+}
+
+int AudioResampler::resample(const float* src, int frames, double ratio, double adjust, Samples &dst) {
+	// Prepare.
+	constexpr const int CHANNELS = AUDIO_RESAMPLER_CHANNELS;
+	constexpr const int FRAC_BITS = 32 - AUDIO_RESAMPLER_PHASE_BITS;
+	static_assert(CHANNELS == 2, "Wrong data.");
+
+	const UInt64 step = Math::max((UInt64)(ratio * adjust * 4294967296.0), (UInt64)1);
+	const bool passthrough = step == ((UInt64)1 << 32) && (UInt32)_position == 0;
+	const double ratio_ = Math::max(ratio, 1.0); // Upsampling shares the same kernel.
+	if (!passthrough && ratio_ != _kernelRatio)
+		build(ratio_);
+	const int half = passthrough ? 0 : _kernelTaps / 2;
+
+	// Append the input.
+	_history.insert(_history.end(), src, src + frames * CHANNELS);
+	const int count = (int)(_history.size() / CHANNELS);
+
+	// Resample.
+	int result = 0;
+	for (; ; ) {
+		const int idx = (int)(_position >> 32);
+		if (idx + half >= count)
+			break;
+
+		float l = 0.0f;
+		float r = 0.0f;
+		if (passthrough) {
+			// FEAT: OPTIMIZATION.
+			// The fixed point position stays on whole frames at unit ratio.
+			const float* p = &_history[idx * CHANNELS];
+			l = p[0];
+			r = p[1];
+		} else {
+			// Interpolate between the two nearest phases.
+			const UInt32 frac = (UInt32)_position;
+			const float t = (frac & ((1u << FRAC_BITS) - 1)) * (1.0f / (1u << FRAC_BITS));
+			const float* k0 = &_kernel[(frac >> FRAC_BITS) * _kernelTaps];
+			const float* k1 = k0 + _kernelTaps;
+			const float* p = &_history[(idx - half + 1) * CHANNELS];
+			float l0 = 0.0f, r0 = 0.0f;
+			float l1 = 0.0f, r1 = 0.0f;
+			for (int i = 0; i < _kernelTaps; ++i) {
+				l0 += k0[i] * p[i * CHANNELS];
+				r0 += k0[i] * p[i * CHANNELS + 1];
+				l1 += k1[i] * p[i * CHANNELS];
+				r1 += k1[i] * p[i * CHANNELS + 1];
+			}
+			l = l0 + (l1 - l0) * t;
+			r = r0 + (r1 - r0) * t;
+		}
+		dst.push_back(l);
+		dst.push_back(r);
+		++result;
+
+		_position += step;
+	}
+
+	// Drop the frames out of reach.
+	const int drop = (int)(_position >> 32) - AUDIO_RESAMPLER_MAX_HALF_TAPS;
+	if (drop > 0) {
+		_history.erase(_history.begin(), _history.begin() + drop * CHANNELS);
+		_position -= (UInt64)drop << 32;
+	}
+
+	// Finish.
+	return result;
+}
+
+void AudioResampler::build(double ratio) {
+	// Prepare.
+	constexpr const int PHASES = 1 << AUDIO_RESAMPLER_PHASE_BITS;
+
+	const int half = Math::min((int)std::ceil(ratio * AUDIO_RESAMPLER_HALF_TAPS), AUDIO_RESAMPLER_MAX_HALF_TAPS);
+	const int taps = half * 2;
+	const double cutoff = AUDIO_RESAMPLER_CUTOFF / ratio; // Relative to the input Nyquist frequency.
+	const double pi = Math::PI();
+
+	// Fill the phases with Blackman windowed sinc, each is normalized to unity
+	// gain to keep the DC level. There is one more phase than needed, which is
+	// the first one shifted by a frame, for interpolating.
+	_kernel.resize((PHASES + 1) * taps);
+	for (int p = 0; p <= PHASES; ++p) {
+		const double frac = (double)p / PHASES;
+		float* k = &_kernel[p * taps];
+		double sum = 0;
+		for (int i = 0; i < taps; ++i) {
+			const double x = (i - half + 1) - frac;
+			const double s = x == 0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+			const double w = 0.42 + 0.5 * std::cos(pi * x / half) + 0.08 * std::cos(2 * pi * x / half);
+			k[i] = (float)(s * w);
+			sum += k[i];
+		}
+		for (int i = 0; i < taps; ++i)
+			k[i] = (float)(k[i] / sum);
+	}
+	_kernelTaps = taps;
+	_kernelRatio = ratio;
+}
 
 /* ===========================================================================} */
 
@@ -267,8 +291,28 @@ inline void deviceBinjgbRtcSet(Emulator* emu, UInt8 part, UInt16 val) {
 ** Device based on the binjgb project
 */
 
-DeviceBinjgb::DeviceBinjgb(Protocol* dbgListener)
+DeviceBinjgb::InputSnapshot::InputSnapshot() {
+	memset(&buttons, 0, sizeof(JoypadButtons));
+}
+
+DeviceBinjgb::DeviceBinjgb(Protocol* dbgListener, bool threaded)
 	: _debugListener(dbgListener)
+	, _threaded(threaded && DEVICE_BINJGB_THREADED_ENABLED)
+	, _emulatorPaused(false)
+	, _speed(DEVICE_BASE_SPEED_FACTOR * 1)
+	, _fps(59)
+	, _duty(0)
+	, _longPeriodDuty(0)
+	, _emulatedFrames(0)
+	, _rewinding(false)
+#if DEVICE_BINJGB_THREADED_ENABLED
+	, _threadQuit(false)
+	, _commands(_threaded ? DEVICE_BINJGB_THREAD_COMMAND_QUEUE_SIZE : 0)
+	, _videoFrames(_threaded ? DEVICE_BINJGB_THREAD_VIDEO_QUEUE_SIZE : 0)
+	, _audioChunks(_threaded ? DEVICE_BINJGB_THREAD_AUDIO_QUEUE_SIZE : 0)
+	, _events(_threaded ? DEVICE_BINJGB_THREAD_EVENT_QUEUE_SIZE : 0)
+	, _sgbFrames(false)
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
 {
 	_classicPalette[0] = Colour::byRGBA8888(DEVICE_CLASSIC_PALETTE_0);
 	_classicPalette[1] = Colour::byRGBA8888(DEVICE_CLASSIC_PALETTE_1);
@@ -446,9 +490,18 @@ void DeviceBinjgb::classicPalette(int index, const Colour &col) {
 
 	_classicPalette[index] = col;
 
-	setBwPalette(PALETTE_TYPE_BGP,  _classicPalette[0].toRGBA(), _classicPalette[1].toRGBA(), _classicPalette[2].toRGBA(), _classicPalette[3].toRGBA());
-	setBwPalette(PALETTE_TYPE_OBP0, _classicPalette[0].toRGBA(), _classicPalette[1].toRGBA(), _classicPalette[2].toRGBA(), _classicPalette[3].toRGBA());
-	setBwPalette(PALETTE_TYPE_OBP1, _classicPalette[0].toRGBA(), _classicPalette[1].toRGBA(), _classicPalette[2].toRGBA(), _classicPalette[3].toRGBA());
+	const u32 white = _classicPalette[0].toRGBA();
+	const u32 lightGray = _classicPalette[1].toRGBA();
+	const u32 darkGray = _classicPalette[2].toRGBA();
+	const u32 black = _classicPalette[3].toRGBA();
+	invoke(
+		[this, white, lightGray, darkGray, black] (void) -> void {
+			setBwPalette(PALETTE_TYPE_BGP,  white, lightGray, darkGray, black);
+			setBwPalette(PALETTE_TYPE_OBP0, white, lightGray, darkGray, black);
+			setBwPalette(PALETTE_TYPE_OBP1, white, lightGray, darkGray, black);
+		},
+		false
+	);
 }
 
 bool DeviceBinjgb::isVariableSpeedSupported(void) const {
@@ -472,10 +525,15 @@ void DeviceBinjgb::inputEnabled(bool val) {
 }
 
 void DeviceBinjgb::stroke(int key) {
-	if (_keyBuffer.size() >= DEVICE_KEY_BUFFER_LENGTH)
-		return;
-
-	_keyBuffer.push_back(key);
+	invoke(
+		[this, key] (void) -> void {
+			if (_keyBuffer.size() >= DEVICE_KEY_BUFFER_LENGTH)
+				return;
+
+			_keyBuffer.push_back(key);
+		},
+		false
+	);
 }
 
 unsigned DeviceBinjgb::speed(void) const {
@@ -527,8 +585,16 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 		return false;
 	_opened = true;
 
+	// Initialize the input recording session, a replay runs on the recorded
+	// device type.
+	_recordingSession = _recordingMode;
+	_recording.clear();
+	if (_recordingSession == RecordingModes::REPLAY)
+		deviceBinjgbDeviceTypeOf(_recordingReplay.device, deviceType);
+
 	// Initialize the device type.
 	_enabledDeviceType = _deviceType = deviceType;
+	_recording.device = deviceBinjgbDeviceTypeName(_deviceType);
 
 	// Retain the ROM.
 	if (DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS < rom->count())
@@ -560,8 +626,8 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 	memcpy(data, rom->pointer(), rom->count());
 	init.rom             = { data, sz };
 	init.audio_frequency = DEVICE_BINJGB_AUDIO_SPEC_FREQUENCE;
-	init.audio_frames    = DEVICE_BINJGB_AUDIO_SPEC_FRAMES;
-	init.random_seed     = 0xcabba6e5;
+	init.audio_frames    = DEVICE_BINJGB_AUDIO_CHUNK_FRAMES;
+	init.random_seed     = DEVICE_BINJGB_RANDOM_SEED;
 	init.builtin_palette = 0;
 	init.force_dmg       = (_enabledDeviceType == DeviceTypes::CLASSIC || _enabledDeviceType == DeviceTypes::CLASSIC_EXTENDED) ? TRUE : FALSE;
 	init.cgb_color_curve = CGB_COLOR_CURVE_GAMBATTE;
@@ -595,26 +661,43 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 #elif defined GBBASIC_OS_HTML
 		flags |= DEVICE_BINJGB_PLATFORM_HTML_FLAG;
 #endif /* Platform macro. */
+		if (_recordingSession == RecordingModes::REPLAY && _recordingReplay.platform >= 0)
+			flags = (u8)_recordingReplay.platform;
 		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_PLATFORM_FLAGS_REG, flags);
 
 		// Set the localization flags.
-		const Platform::Languages lang = Platform::locale();
 		static_assert((unsigned)Platform::Languages::COUNT <= (unsigned)std::numeric_limits<u8>::max(), "Wrong type.");
-		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_LOCALIZATION_FLAGS_REG, (u8)lang);
+		u8 lang = (u8)Platform::locale();
+		if (_recordingSession == RecordingModes::REPLAY && _recordingReplay.localization >= 0)
+			lang = (u8)_recordingReplay.localization;
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_LOCALIZATION_FLAGS_REG, lang);
+
+		_recording.platform = flags;
+		_recording.localization = lang;
 	}
 
-	// Initialize the RTC.
-	if (cartridgeHasRtc()) {
+	// Initialize the RTC, with the host time, or the recorded one on replay;
+	// it's left as power on if a replay doesn't specify it.
+	const int rtc = _recordingSession == RecordingModes::REPLAY ? _recordingReplay.rtc : 0;
+	if (cartridgeHasRtc() && rtc >= 0) {
 		_rtcTicks = 0;
 		int day = 0, hr = 0, mi = 0, sec = 0;
-		DateTime::now(&sec, &mi, &hr, nullptr, nullptr, nullptr, nullptr, &day, nullptr);
+		if (_recordingSession == RecordingModes::REPLAY) {
+			day = rtc / (24 * 60 * 60);
+			hr = rtc / (60 * 60) % 24;
+			mi = rtc / 60 % 60;
+			sec = rtc % 60;
+		} else {
+			DateTime::now(&sec, &mi, &hr, nullptr, nullptr, nullptr, nullptr, &day, nullptr);
+		}
+		_recording.rtc = ((day * 24 + hr) * 60 + mi) * 60 + sec;
 		ENABLE_RAM(_emulator);
 		deviceBinjgbRtcStart(_emulator, 1);
 		deviceBinjgbRtcLatch(_emulator);
-		deviceBinjgbRtcSet(_emulator, (UInt8)RTC_VALUE_DAY,  (UInt16)day);
-		deviceBinjgbRtcSet(_emulator, (UInt8)RTC_VALUE_HOUR, (UInt16)hr);
-		deviceBinjgbRtcSet(_emulator, (UInt8)RTC_VALUE_MIN,  (UInt16)mi);
-		deviceBinjgbRtcSet(_emulator, (UInt8)RTC_VALUE_SEC,  (UInt16)sec);
+		deviceBinjgbRtcSet(_emulator, (UInt8)DEVICE_BINJGB_RTC_VALUE_DAY,  (UInt16)day);
+		deviceBinjgbRtcSet(_emulator, (UInt8)DEVICE_BINJGB_RTC_VALUE_HOUR, (UInt16)hr);
+		deviceBinjgbRtcSet(_emulator, (UInt8)DEVICE_BINJGB_RTC_VALUE_MIN,  (UInt16)mi);
+		deviceBinjgbRtcSet(_emulator, (UInt8)DEVICE_BINJGB_RTC_VALUE_SEC,  (UInt16)sec);
 		DISABLE_RAM(_emulator);
 	}
 
@@ -623,6 +706,15 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 
 	// Initialize the frame buffer.
 	memset(_videoBuffer, 0, sizeof(_videoBuffer));
+#if DEVICE_BINJGB_PRESENT_DIFF_ENABLED
+	_presentedTexture = nullptr;
+	_presentedSgb = false;
+#endif /* DEVICE_BINJGB_PRESENT_DIFF_ENABLED */
+	_emulatedFrames = 0;
+	_presentedFrames = 0;
+	_uploadedFrames = 0;
+	_uploadedRows = 0;
+	_openedTimestamp = DateTime::ticks();
 
 	// Initialize the audio.
 	memset(&_audioCvt, 0, sizeof(SDL_AudioCVT));
@@ -636,9 +728,11 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 	SDL_AudioSpec obtdSpec;
 	memset(&obtdSpec, 0, sizeof(SDL_AudioSpec));
 	if (useAudioDevice) {
+		SDL_AudioSpec devSpec = _audioSpec;
+		devSpec.samples = (Uint16)DEVICE_BINJGB_AUDIO_DEVICE_FRAMES; // Keep the hardware buffer short for latency.
 		_audioDeviceId = SDL_OpenAudioDevice(
 			nullptr, SDL_FALSE,
-			&_audioSpec, &obtdSpec,
+			&devSpec, &obtdSpec,
 			SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_FORMAT_CHANGE
 		);
 	}
@@ -666,6 +760,7 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 		}
 		_audioBuffer = Bytes::Ptr(Bytes::create());
 		_audioBuffer->resize(_audioSpec.size);
+		_audioBytesPerSecond = obtdSpec.freq * obtdSpec.channels * (SDL_AUDIO_BITSIZE(obtdSpec.format) / 8);
 
 		SDL_PauseAudioDevice(_audioDeviceId, SDL_FALSE);
 	} else {
@@ -673,6 +768,8 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 		_audioBuffer->resize(_audioSpec.size);
 	}
 
+	_audioResampler.reset();
+
 	// Initialize the input.
 	_input = input;
 	_inputEnabled = !!_input;
@@ -682,10 +779,33 @@ bool DeviceBinjgb::open(Bytes::Ptr rom, DeviceTypes deviceType, bool isEditor, b
 	_keyboardModifiers = KeyboardModifiers();
 	_keyBuffer.clear();
 
-	// Initialize the SRAM.
-	if (sram)
+	// Initialize the SRAM, a recording session always starts from the power on
+	// state.
+	if (sram && _recordingSession == RecordingModes::NONE)
 		readSram(sram.get());
 
+	// Initialize the rewind buffer, after the SRAM to capture it.
+	_rewindCapturedFrames = 0;
+	_rewindCaptureCost = 0;
+	resetRewind(_rewindCapacity > 0);
+
+	// Initialize the profiler.
+	if (_profilerInterval > 0)
+		_profiler.open(_profilerInterval, _profilerSymbols, _profilerLines);
+
+	// Begin the input recording session.
+	beginRecording();
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	// Start the emulator thread.
+	if (_threaded) {
+		_inputSnapshot = InputSnapshot();
+		_sgbFrames = false;
+
+		startThread();
+	}
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
 	// Finish.
 	return true;
 }
@@ -696,10 +816,55 @@ bool DeviceBinjgb::close(Bytes::Ptr sram) {
 		return false;
 	_opened = false;
 
-	// Dispose the SRAM.
-	if (sram)
+#if DEVICE_BINJGB_THREADED_ENABLED
+	// Stop the emulator thread.
+	stopThread();
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
+	// Dispose the SRAM, it's not kept from a recording session.
+	if (sram && _recordingSession == RecordingModes::NONE)
 		writeSram(sram.get());
 
+	// Report the presentation.
+	if (_presentedFrames > 0) {
+		const double secs = DateTime::toSeconds(DateTime::ticks() - _openedTimestamp);
+		fprintf(
+			stdout,
+			"Emulated %u frames in %gs (%.1f fps), presented: %u, uploaded: %u (%u scanlines).\n",
+			(unsigned)_emulatedFrames, secs, secs > 0 ? _emulatedFrames / secs : 0.0,
+			_presentedFrames, _uploadedFrames, _uploadedRows
+		);
+	}
+
+	// Report and dispose the rewind buffer.
+	if (_rewindBuffer && _rewindCapturedFrames > 0) {
+		const RewindStats stats = rewind_get_stats(_rewindBuffer);
+		const double minutes = (double)_rewindCapturedFrames * PPU_FRAME_TICKS / CPU_TICKS_PER_SECOND / 60;
+		fprintf(
+			stdout,
+			"Rewind captured %u frames, %.1fKB per emulated minute (%.1f%% of uncompressed), %.2fus per frame.\n",
+			_rewindCapturedFrames,
+			(stats.base_bytes + stats.diff_bytes) / 1024.0 / minutes,
+			stats.uncompressed_bytes ? (double)(stats.base_bytes + stats.diff_bytes) / stats.uncompressed_bytes * 100 : 0.0,
+			DateTime::toSeconds(_rewindCaptureCost) * 1000000 / _rewindCapturedFrames
+		);
+	}
+	resetRewind(false);
+
+	// Dispose the profiler.
+	_profiler.close();
+
+	// Dispose the input recording session.
+	_recordingSession = RecordingModes::NONE;
+	_recordingActive = false;
+	_recording.clear();
+	_recordingReport = Recording::Report();
+	_recordingBeginTicks = 0;
+	_recordingFrame = 0;
+	_recordingFrameTicks = 0;
+	_recordingButtons = 0;
+	_recordingHaltCount = 0;
+
 	// Dispose the counters.
 	_speed = 1 * DEVICE_BASE_SPEED_FACTOR;
 	_previousTicks = 0;
@@ -723,6 +888,10 @@ bool DeviceBinjgb::close(Bytes::Ptr sram) {
 	// Dispose the audio.
 	_audioCvtBufferLength = 0;
 	_audioBuffer = nullptr;
+	_audioResampler.reset();
+	_audioInput.clear();
+	_audioOutput.clear();
+	_audioBytesPerSecond = 0;
 
 	if (_audioCvt.buf)
 		SDL_free(_audioCvt.buf);
@@ -735,6 +904,10 @@ bool DeviceBinjgb::close(Bytes::Ptr sram) {
 
 	// Dispose the frame buffer.
 	memset(_videoBuffer, 0, sizeof(_videoBuffer));
+#if DEVICE_BINJGB_PRESENT_DIFF_ENABLED
+	_presentedTexture = nullptr;
+	_presentedSgb = false;
+#endif /* DEVICE_BINJGB_PRESENT_DIFF_ENABLED */
 
 	// Dispose the streaming buffer.
 	_streamingBuffer = nullptr;
@@ -773,8 +946,6 @@ bool DeviceBinjgb::update(
 	AudioHandler handleAudio
 ) {
 	// Prepare.
-	typedef std::array<float, SOUND_OUTPUT_COUNT> AudioValues;
-
 	if (!_emulator)
 		return false;
 
@@ -796,19 +967,45 @@ bool DeviceBinjgb::update(
 			isSgb = true;
 	}
 
+	// Update with the rewound content, the emulator doesn't advance meanwhile.
+	if (_rewinding) {
+		if (texture) {
+			invoke(
+				[this, isSgb] (void) -> void {
+					if (isSgb)
+						stageFrame(*emulator_get_sgb_frame_buffer(_emulator), true);
+					else
+						stageFrame(*emulator_get_frame_buffer(_emulator), false);
+				},
+				true
+			);
+			presentFrame(rnd, texture, isSgb);
+
+			rnd->target(oldRndTarget);
+			rnd->scale(oldRndScale);
+		}
+
+		return true;
+	}
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	// Present what the emulator thread has produced.
+	if (_threaded) {
+		updateThreaded(wnd, rnd, texture, isSgb, allowInput, handleAudio);
+
+		if (texture) {
+			rnd->target(oldRndTarget);
+			rnd->scale(oldRndScale);
+		}
+
+		return true;
+	}
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
 	// Update with paused content.
 	if (_emulatorPaused) {
 		if (texture) {
-			const int bytes = SDL_BYTESPERPIXEL(SDL_PIXELFORMAT_ABGR8888);
-			if (isSgb) {
-				SgbFrameBuffer* frame = emulator_get_sgb_frame_buffer(_emulator);
-				memcpy(_videoBuffer, frame, sizeof(_videoBuffer));
-				SDL_UpdateTexture((SDL_Texture*)texture->pointer(rnd), nullptr, _videoBuffer, SGB_SCREEN_WIDTH * bytes);
-			} else {
-				FrameBuffer* frame = emulator_get_frame_buffer(_emulator);
-				memcpy(_videoBuffer, frame, sizeof(_videoBuffer));
-				SDL_UpdateTexture((SDL_Texture*)texture->pointer(rnd), nullptr, _videoBuffer, SCREEN_WIDTH * bytes);
-			}
+			presentFrame(rnd, texture, isSgb);
 
 			rnd->target(oldRndTarget);
 			rnd->scale(oldRndScale);
@@ -819,181 +1016,73 @@ bool DeviceBinjgb::update(
 
 	// Tick a frame.
 	bool timeout = false;
-	long long start = 0;
-	if (_timeoutThreshold > 0) {
-		start = DateTime::ticks();
-	}
 	delta = Math::min(delta, DEVICE_BINJGB_DELTA_TIME_MIN_SECONDS);
 	const Ticks deltaTicks = (Ticks)(delta * CPU_TICKS_PER_SECOND);
 	const Ticks scaleTicks = deltaTicks * _speed / DEVICE_BASE_SPEED_FACTOR;
 	const Ticks untilTicks = emulator_get_ticks(_emulator) + scaleTicks;
-	EmulatorEvent event = 0;
 	bool disabledInput = false;
 	if (_inputEnabled && !allowInput) {
 		_inputEnabled = false;
 		disabledInput = true;
 	}
-	if (_previousTicks == 0) {
-		_previousTicks = emulator_get_ticks(_emulator);
-	}
-	do {
-		// Tick.
-		event = emulator_run_until(_emulator, untilTicks);
-
-		// Update the video system.
-		if (event & EMULATOR_EVENT_NEW_FRAME) {
-			const Ticks nowTicks = emulator_get_ticks(_emulator);
-			const Ticks diffTicks = nowTicks - _previousTicks;
-			_previousTicks = nowTicks;
-			const double deltaSecs = (double)diffTicks / CPU_TICKS_PER_SECOND;
-			_updatedSeconds += deltaSecs;
-			if (++_updatedFrameCount >= (120 * _speed / DEVICE_BASE_SPEED_FACTOR)) { // ~2 seconds.
-				if (_updatedSeconds > 0)
-					_fps = (unsigned)((_updatedFrameCount * _speed / DEVICE_BASE_SPEED_FACTOR) / _updatedSeconds);
-				else
-					_fps = 0;
-				_updatedFrameCount = 0;
-				_updatedSeconds = 0;
-			}
-
-			if (texture) {
-				const int bytes = SDL_BYTESPERPIXEL(SDL_PIXELFORMAT_ABGR8888);
-				if (isSgb) {
-					SgbFrameBuffer* frame = emulator_get_sgb_frame_buffer(_emulator);
-					memcpy(_videoBuffer, frame, sizeof(_videoBuffer));
-					SDL_UpdateTexture((SDL_Texture*)texture->pointer(rnd), nullptr, _videoBuffer, SGB_SCREEN_WIDTH * bytes);
-				} else {
-					FrameBuffer* frame = emulator_get_frame_buffer(_emulator);
-					memcpy(_videoBuffer, frame, sizeof(_videoBuffer));
-					SDL_UpdateTexture((SDL_Texture*)texture->pointer(rnd), nullptr, _videoBuffer, SCREEN_WIDTH * bytes);
-				}
-			}
-
-			const Ticks ticks = emulator_get_duty_ticks(_emulator);
-			constexpr const double dlt = ((double)CPU_TICKS_PER_SECOND / 120);
-			_duty = Math::clamp((int)((double)ticks / dlt * 100), 0, 100);
-			emulator_set_duty_ticks(_emulator, 0);
-
-			if (_duty > _longPeriodDutyMaxValue)
-				_longPeriodDutyMaxValue = _duty;
-			if (++_longPeriodDutyTicks >= (int)(30 * _speed / DEVICE_BASE_SPEED_FACTOR)) { // ~0.5 second.
-				_longPeriodDuty = Math::clamp(_longPeriodDutyMaxValue, 0, 100);
-				_longPeriodDutyMaxValue = 0;
-				_longPeriodDutyTicks = 0;
-			}
-		}
-
-		// Update the audio system.
-		if (event & EMULATOR_EVENT_AUDIO_BUFFER_FULL) {
+	bool staged = false;
+	Bytes::Ptr streamed = nullptr;
+	Text::Array cmds;
+	auto poll = [&] (void) -> void {
+		// Poll the streaming and shell command area, a completed stream is
+		// taken at most once, the next one waits for the next poll.
+		std::string cmd;
+		if (!streamed)
+			pollStreaming(streamed);
+		if (pollShellCommand(cmd))
+			cmds.push_back(cmd);
+	};
+	tick(
+		untilTicks, &timeout,
+		[&] (void) -> void {
+			// FEAT: OPTIMIZATION.
+			// Poll on every frame rather than every update.
+			poll();
+
+			// Stage the frame, only the latest one is presented.
+			if (!texture)
+				return;
+
+			if (isSgb)
+				stageFrame(*emulator_get_sgb_frame_buffer(_emulator), true);
+			else
+				stageFrame(*emulator_get_frame_buffer(_emulator), false);
+			staged = true;
+		},
+		[&] (void) -> void {
+			// Update the audio system.
 			AudioBuffer* srcBuffer = emulator_get_audio_buffer(_emulator);
-			const u32 srcFrames = audio_buffer_get_frames(srcBuffer);
-			const u8* srcData = srcBuffer->data;
-			const int sampleSize = SDL_AUDIO_BITSIZE(_audioSpec.format) / 8;
-			const u32 maxDstFrames = _audioSpec.size / (_audioSpec.channels * sampleSize);
-			const u32 frames = Math::min(srcFrames, maxDstFrames);
-
-			_audioBuffer->poke(0);
-			if (_speed == DEVICE_BASE_SPEED_FACTOR * 1) {
-				for (u32 i = 0; i < frames; ++i) {
-					AudioValues values;
-					for (int j = 0; j < (int)values.size(); ++j) {
-						const float val = DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8(*srcData, 1.0f);
-						values[j] = val;
-						++srcData;
-					}
-					for (int c = 0; c < _audioSpec.channels; ++c) {
-						const int u = c % (int)values.size();
-						const float val = values[u];
-						_audioBuffer->writeSingle(val);
-					}
-				}
-			} else if (_speed >= DEVICE_BASE_SPEED_FACTOR * 1) {
-				for (u32 i = 0; i < frames; i += _speed / DEVICE_BASE_SPEED_FACTOR) {
-					AudioValues values;
-					for (int j = 0; j < (int)values.size(); ++j) {
-						const float val = DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8(*srcData, 1.0f);
-						values[j] = val;
-						srcData += _speed / DEVICE_BASE_SPEED_FACTOR;
-					}
-					for (int c = 0; c < _audioSpec.channels; ++c) {
-						const int u = c % (int)values.size();
-						const float val = values[u];
-						_audioBuffer->writeSingle(val);
-					}
-				}
-			} else /* if (_speed < DEVICE_BASE_SPEED_FACTOR * 1) */ {
-				for (u32 i = 0; i < frames; ++i) {
-					AudioValues values;
-					for (int j = 0; j < (int)values.size(); ++j) {
-						const float val = DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8(*srcData, 1.0f);
-						values[j] = val;
-						++srcData;
-					}
-					for (int j = 0; j < (int)(DEVICE_BASE_SPEED_FACTOR / _speed); ++j) {
-						for (int c = 0; c < _audioSpec.channels; ++c) {
-							const int u = c % (int)values.size();
-							const float val = values[u];
-							_audioBuffer->writeSingle(val);
-						}
-					}
-				}
-			}
-			const Uint32 len = Math::min(
-				(frames * DEVICE_BASE_SPEED_FACTOR / _speed) * _audioSpec.channels * sampleSize,
-				(u32)_audioBuffer->count()
-			);
-
-			bool handledAudio = false;
-			if (handleAudio) {
-				handledAudio = handleAudio((void*)&_audioSpec, _audioBuffer.get(), len);
-			}
-			if (!handledAudio && _audioDeviceId) {
-				const Uint32 inq = SDL_GetQueuedAudioSize(_audioDeviceId);
-				if (inq < (len << 4)) { // Skip the audio frame if the queue is too long.
-					if (_audioCvt.needed) {
-						const size_t newLen = len * _audioCvt.len_mult;
-						if (_audioCvtBufferLength < newLen) {
-							_audioCvtBufferLength = newLen;
-							_audioCvt.buf = (Uint8*)SDL_realloc(_audioCvt.buf, newLen);
-						}
-						_audioCvt.len = (int)len;
-						SDL_memcpy(_audioCvt.buf, _audioBuffer->pointer(), len);
-						SDL_ConvertAudio(&_audioCvt);
-						SDL_QueueAudio(_audioDeviceId, _audioCvt.buf, _audioCvt.len_cvt);
-					} else {
-						SDL_QueueAudio(_audioDeviceId, _audioBuffer->pointer(), len);
-					}
-				}
-			}
-		}
-
-		// Break if timeout.
-		if (_timeoutThreshold > 0) {
-			const long long now = DateTime::ticks();
-			const long long diff = now - start;
-			if (diff > _timeoutThreshold) {
-				timeout = true;
-
-				break;
-			}
+			queueAudio(srcBuffer->data, audio_buffer_get_frames(srcBuffer), _speed, handleAudio);
 		}
-	} while (!(event & (EMULATOR_EVENT_UNTIL_TICKS | EMULATOR_EVENT_BREAKPOINT | EMULATOR_EVENT_INVALID_OPCODE)));
+	);
 	if (disabledInput) {
 		_inputEnabled = true;
 	}
 
-	// Tick the RTC.
-	if (cartridgeHasRtc()) {
-		_rtcTicks += delta;
-		if (_rtcTicks > 0.5) { // Ticks every half second.
-			_rtcTicks -= 0.5;
-			deviceBinjgbRtcLatch(_emulator);
-		}
+	// Update the video system.
+	if (staged) {
+		presentFrame(rnd, texture, isSgb);
+		++_presentedFrames;
 	}
 
+	// Tick the RTC.
+	tickRtc(delta);
+
 	// Process the streaming and shell command area.
-	processStreaming(wnd, rnd);
-	processShellCommand(wnd, rnd);
+	poll();
+	if (streamed)
+		dispatchStreamed(wnd, rnd, streamed);
+	for (const std::string &cmd : cmds) {
+		if (!_emulator) // Closed by the listener.
+			break;
+
+		dispatchShellCommand(wnd, rnd, cmd);
+	}
 
 	// Restore the renderer states.
 	if (texture) {
@@ -1025,8 +1114,12 @@ bool DeviceBinjgb::readRam(UInt16 address, UInt8* data) {
 	if (!_emulator)
 		return false;
 
-	const u8 ret = emulator_read_u8_raw(_emulator, address);
-	*data = ret;
+	invoke(
+		[this, address, data] (void) -> void {
+			*data = emulator_read_u8_raw(_emulator, address);
+		},
+		true
+	);
 
 	return true;
 }
@@ -1039,8 +1132,13 @@ bool DeviceBinjgb::readRam(UInt16 address, UInt16* data) {
 		UInt16 data;
 		UInt8 bytes[2];
 	} u;
-	u.bytes[0] = emulator_read_u8_raw(_emulator, address);
-	u.bytes[1] = emulator_read_u8_raw(_emulator, address + 1);
+	invoke(
+		[this, address, &u] (void) -> void {
+			u.bytes[0] = emulator_read_u8_raw(_emulator, address);
+			u.bytes[1] = emulator_read_u8_raw(_emulator, address + 1);
+		},
+		true
+	);
 	if (!Platform::isLittleEndian())
 		std::swap(u.bytes[0], u.bytes[1]);
 	*data = u.data;
@@ -1052,7 +1150,12 @@ bool DeviceBinjgb::writeRam(UInt16 address, UInt8 data) {
 	if (!_emulator)
 		return false;
 
-	emulator_write_u8_raw(_emulator, address, data);
+	invoke(
+		[this, address, data] (void) -> void {
+			emulator_write_u8_raw(_emulator, address, data);
+		},
+		false
+	);
 
 	return true;
 }
@@ -1068,8 +1171,15 @@ bool DeviceBinjgb::writeRam(UInt16 address, UInt16 data) {
 	u.data = data;
 	if (!Platform::isLittleEndian())
 		std::swap(u.bytes[0], u.bytes[1]);
-	emulator_write_u8_raw(_emulator, address,     u.bytes[0]);
-	emulator_write_u8_raw(_emulator, address + 1, u.bytes[1]);
+	const UInt8 lo = u.bytes[0];
+	const UInt8 hi = u.bytes[1];
+	invoke(
+		[this, address, lo, hi] (void) -> void {
+			emulator_write_u8_raw(_emulator, address,     lo);
+			emulator_write_u8_raw(_emulator, address + 1, hi);
+		},
+		false
+	);
 
 	return true;
 }
@@ -1083,7 +1193,13 @@ bool DeviceBinjgb::readSram(const Bytes* bytes) {
 	Bytes::Ptr tmp(Bytes::create());
 	tmp->writeBytes(bytes);
 	const FileData fd = { (u8*)tmp->pointer(), tmp->count() };
-	const Result ret = emulator_read_ext_ram(_emulator, &fd);
+	Result ret = ERROR;
+	invoke(
+		[this, &fd, &ret] (void) -> void {
+			ret = emulator_read_ext_ram(_emulator, &fd);
+		},
+		true
+	);
 
 	return ret == OK;
 }
@@ -1094,13 +1210,260 @@ bool DeviceBinjgb::writeSram(Bytes* bytes) {
 
 	bytes->resize(DEVICE_BINJGB_SRAM_MAX_SIZE);
 	FileData fd = { bytes->pointer(), bytes->count() };
-	const Result ret = emulator_write_ext_ram(_emulator, &fd);
+	Result ret = ERROR;
+	invoke(
+		[this, &fd, &ret] (void) -> void {
+			ret = emulator_write_ext_ram(_emulator, &fd);
+		},
+		true
+	);
 	const int size = cartridgeSramSize(nullptr);
 	bytes->resize(size);
 
 	return ret == OK;
 }
 
+bool DeviceBinjgb::readState(const Bytes* bytes) {
+	if (!bytes)
+		return false;
+	if (bytes->empty())
+		return false;
+	if (_rewinding)
+		return false;
+
+	Bytes::Ptr tmp(Bytes::create());
+	tmp->writeBytes(bytes);
+	const FileData fd = { (u8*)tmp->pointer(), tmp->count() };
+	Result ret = ERROR;
+	invoke(
+		[this, &fd, &ret] (void) -> void {
+			ret = emulator_read_state(_emulator, &fd);
+			if (ret != OK)
+				return;
+
+			// The history doesn't lead to the loaded state anymore.
+			resetRewind(!!_rewindBuffer);
+			_previousTicks = emulator_get_ticks(_emulator);
+
+			// Neither does the input recording session.
+			if (_recordingSession != RecordingModes::NONE) {
+				fprintf(stdout, "Stopped the input recording session by loading a state.\n");
+				_recordingSession = RecordingModes::NONE;
+				_recordingActive = false;
+			}
+		},
+		true
+	);
+
+	return ret == OK;
+}
+
+bool DeviceBinjgb::writeState(Bytes* bytes) {
+	if (!bytes)
+		return false;
+
+	FileData fd;
+	emulator_init_state_file_data(&fd);
+	Result ret = ERROR;
+	invoke(
+		[this, &fd, &ret] (void) -> void {
+			ret = emulator_write_state(_emulator, &fd);
+		},
+		true
+	);
+	if (ret == OK) {
+		bytes->resize(fd.size);
+		memcpy(bytes->pointer(), fd.data, fd.size);
+	}
+	file_data_delete(&fd);
+
+	return ret == OK;
+}
+
+size_t DeviceBinjgb::rewindBudget(int* keyframeInterval) const {
+	if (keyframeInterval)
+		*keyframeInterval = _rewindFramesPerBaseState;
+
+	return _rewindCapacity;
+}
+
+void DeviceBinjgb::rewindBudget(size_t bytes, int keyframeInterval) {
+	_rewindCapacity = bytes;
+	_rewindFramesPerBaseState = Math::max(keyframeInterval, 1);
+}
+
+bool DeviceBinjgb::rewinding(void) const {
+	return _rewinding;
+}
+
+bool DeviceBinjgb::rewindBegin(void) {
+	if (!_emulator || !_rewindBuffer || _rewinding)
+		return false;
+
+	invoke(
+		[this] (void) -> void {
+			_rewindBeginTicks = emulator_get_ticks(_emulator);
+			memset(&_rewindResult, 0, sizeof(RewindResult));
+			_rewinding = true;
+		},
+		true
+	);
+
+	return true;
+}
+
+bool DeviceBinjgb::rewindTo(double seconds, double* reached) {
+	if (reached)
+		*reached = 0;
+	if (!_rewinding)
+		return false;
+
+	Result ret = ERROR;
+	invoke(
+		[this, seconds, reached, &ret] (void) -> void {
+			// Clamp to the captured history.
+			const Ticks oldest = rewind_get_oldest_ticks(_rewindBuffer);
+			const Ticks newest = rewind_get_newest_ticks(_rewindBuffer);
+			if (oldest == INVALID_TICKS || newest == INVALID_TICKS)
+				return;
+			const Ticks back = (Ticks)(Math::max(seconds, 0.0) * CPU_TICKS_PER_SECOND);
+			Ticks ticks = _rewindBeginTicks > oldest + back ? _rewindBeginTicks - back : oldest;
+			if (ticks > newest)
+				ticks = newest;
+
+			// Restore the nearest state at or before the target.
+			RewindResult result;
+			ret = rewind_to_ticks(_rewindBuffer, ticks, &result);
+			if (ret != OK)
+				return;
+			_rewindResult = result;
+			emulator_read_state(_emulator, &_rewindResult.file_data);
+
+			// Render the frame that follows the state as preview, then restore
+			// it again, the frame buffer itself isn't part of the state.
+			const Ticks previewTicks = emulator_get_ticks(_emulator) + PPU_FRAME_TICKS;
+			EmulatorEvent event = 0;
+			do {
+				event = emulator_run_until(_emulator, previewTicks);
+			} while (!(event & (EMULATOR_EVENT_NEW_FRAME | EMULATOR_EVENT_UNTIL_TICKS | EMULATOR_EVENT_BREAKPOINT | EMULATOR_EVENT_INVALID_OPCODE)));
+			emulator_read_state(_emulator, &_rewindResult.file_data);
+
+			if (reached)
+				*reached = (double)(_rewindBeginTicks - emulator_get_ticks(_emulator)) / CPU_TICKS_PER_SECOND;
+		},
+		true
+	);
+
+	return ret == OK;
+}
+
+void DeviceBinjgb::rewindEnd(void) {
+	if (!_rewinding)
+		return;
+
+	invoke(
+		[this] (void) -> void {
+			// Drop the history after the rewound state, and resume from it.
+			if (_rewindResult.info)
+				rewind_truncate_to(_rewindBuffer, _emulator, &_rewindResult);
+			memset(&_rewindResult, 0, sizeof(RewindResult));
+			_previousTicks = emulator_get_ticks(_emulator);
+			_rewinding = false;
+		},
+		true
+	);
+}
+
+int DeviceBinjgb::profilerInterval(void) const {
+	return _profilerInterval;
+}
+
+void DeviceBinjgb::profilerInterval(int ticks, const std::string &symbols, const Profiler::Line::Array &lines) {
+	_profilerInterval = Math::max(ticks, 0);
+	_profilerSymbols = symbols;
+	_profilerLines = lines;
+}
+
+bool DeviceBinjgb::profile(Profiler::Report &report) {
+	report = Profiler::Report();
+	if (!_emulator || !_profiler.opened())
+		return false;
+
+	invoke(
+		[this, &report] (void) -> void {
+			_profiler.report(report);
+		},
+		true
+	);
+
+	return true;
+}
+
+Device::RecordingModes DeviceBinjgb::recordingMode(void) const {
+	return _recordingMode;
+}
+
+void DeviceBinjgb::recordingMode(RecordingModes mode, const Recording &replay) {
+	_recordingMode = mode;
+	if (mode == RecordingModes::REPLAY)
+		_recordingReplay = replay;
+	else
+		_recordingReplay.clear();
+}
+
+bool DeviceBinjgb::recordingEnd(Recording &recording, Recording::Report &report) {
+	recording = Recording();
+	report = Recording::Report();
+	if (!_emulator || _recordingSession == RecordingModes::NONE)
+		return false;
+
+	rewindEnd();
+	invoke(
+		[this, &recording, &report] (void) -> void {
+			if (_recordingActive && _recordingSession == RecordingModes::RECORD) {
+				// Run to the end of the current frame, so that the recording ends
+				// at a frame boundary the same as a replay does.
+				EmulatorEvent event = 0;
+				do {
+					event = emulator_run_until(_emulator, _recordingFrameTicks);
+				} while (!(event & (EMULATOR_EVENT_UNTIL_TICKS | EMULATOR_EVENT_BREAKPOINT | EMULATOR_EVENT_INVALID_OPCODE)));
+				_recording.frameCount = _recordingFrame + 1;
+				_recording.hash = Recording::stateHash(_emulator);
+				_recordingReport.frameCount = _recording.frameCount;
+				_recordingReport.hash = _recording.hash;
+			} else if (_recordingActive) {
+				// Stopped before the end of the replay.
+				_recordingReport.frameCount = _recordingFrame;
+			}
+			_recordingActive = false;
+
+			recording = _recording;
+			report = _recordingReport;
+		},
+		true
+	);
+
+	return true;
+}
+
+bool DeviceBinjgb::threaded(void) const {
+	return _threaded;
+}
+
+unsigned DeviceBinjgb::droppedFrames(void) const {
+	const unsigned emulated = _emulatedFrames;
+
+	return emulated > _presentedFrames ? emulated - _presentedFrames : 0;
+}
+
+int DeviceBinjgb::queueDepth(void) const {
+#if DEVICE_BINJGB_THREADED_ENABLED
+	return _queueDepth;
+#else /* DEVICE_BINJGB_THREADED_ENABLED */
+	return 0;
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+}
+
 void DeviceBinjgb::setBwPalette(PaletteType type, u32 white, u32 light_gray, u32 dark_gray, u32 black) {
 	if (!_emulator)
 		return;
@@ -1110,7 +1473,371 @@ void DeviceBinjgb::setBwPalette(PaletteType type, u32 white, u32 light_gray, u32
 	emulator_set_bw_palette(_emulator, type, &palette);
 }
 
-bool DeviceBinjgb::processStreaming(class Window* wnd, class Renderer* rnd) {
+bool DeviceBinjgb::invoke(Command cmd, bool wait) {
+#if DEVICE_BINJGB_THREADED_ENABLED
+	if (_thread.joinable()) {
+		// Post the command to the emulator thread, it's the only consumer.
+		Command* slot = nullptr;
+		while ((slot = _commands.acquire()) == nullptr)
+			std::this_thread::yield();
+
+		bool done = false; // Guarded by `_threadLock`.
+		if (wait) {
+			*slot = [this, cmd, &done] (void) -> void {
+				cmd();
+
+				LockGuard<decltype(_threadLock)> guard(_threadLock);
+				done = true;
+				_threadSignal.notify_all();
+			};
+		} else {
+			*slot = cmd;
+		}
+		{
+			LockGuard<decltype(_threadLock)> guard(_threadLock);
+			_commands.commit();
+			_threadSignal.notify_all();
+		}
+
+		// Wait for the result.
+		if (wait) {
+			std::unique_lock<decltype(_threadLock)> guard(_threadLock);
+			_threadSignal.wait(guard, [&done] (void) -> bool { return done; });
+		}
+
+		return true;
+	}
+#else /* DEVICE_BINJGB_THREADED_ENABLED */
+	(void)wait;
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
+	// Run it in place.
+	cmd();
+
+	return false;
+}
+
+void DeviceBinjgb::tick(Ticks untilTicks, bool* timeout, std::function<void(void)> onFrame, std::function<void(void)> onAudio) {
+	long long start = 0;
+	if (_timeoutThreshold > 0 || _recordingActive) {
+		start = DateTime::ticks();
+	}
+	const bool recording = _recordingActive;
+	EmulatorEvent event = 0;
+	if (_previousTicks == 0) {
+		_previousTicks = emulator_get_ticks(_emulator);
+	}
+	do {
+		// Stop at the frame boundaries during an input recording session, the
+		// joypad states are latched there.
+		Ticks until = untilTicks;
+		if (_recordingActive) {
+			syncRecording();
+			if (_recordingActive && _recordingFrameTicks < until)
+				until = _recordingFrameTicks;
+		}
+
+		// Tick, and sample for the profiler if it's enabled.
+		event = _profiler.run(_emulator, until);
+		if (until < untilTicks)
+			event &= ~EMULATOR_EVENT_UNTIL_TICKS; // Stopped at a frame boundary only.
+
+		// Update the statistics and the video system.
+		if (event & EMULATOR_EVENT_NEW_FRAME) {
+			if (_recordingActive) {
+				// It's a lag frame if the VM has never halted to wait for the
+				// vertical sync since the last one.
+				const UInt32 haltCount = emulator_get_halt_count(_emulator);
+				if (haltCount == _recordingHaltCount)
+					++_recordingReport.lagFrames;
+				_recordingHaltCount = haltCount;
+			}
+
+			const Ticks nowTicks = emulator_get_ticks(_emulator);
+			const Ticks diffTicks = nowTicks - _previousTicks;
+			_previousTicks = nowTicks;
+			const double deltaSecs = (double)diffTicks / CPU_TICKS_PER_SECOND;
+			_updatedSeconds += deltaSecs;
+			if (++_updatedFrameCount >= (120 * _speed / DEVICE_BASE_SPEED_FACTOR)) { // ~2 seconds.
+				if (_updatedSeconds > 0)
+					_fps = (unsigned)((_updatedFrameCount * _speed / DEVICE_BASE_SPEED_FACTOR) / _updatedSeconds);
+				else
+					_fps = 0;
+				_updatedFrameCount = 0;
+				_updatedSeconds = 0;
+			}
+			_emulatedFrames = _emulatedFrames + 1;
+
+			if (onFrame)
+				onFrame();
+
+			if (_rewindBuffer) {
+				// FEAT: OPTIMIZATION.
+				// Only the differences to the latest keyframe are stored, and
+				// they are run-length encoded.
+				const long long start_ = DateTime::ticks();
+				rewind_append(_rewindBuffer, _emulator);
+				_rewindCaptureCost += DateTime::ticks() - start_;
+				++_rewindCapturedFrames;
+			}
+
+			const Ticks ticks = emulator_get_duty_ticks(_emulator);
+			constexpr const double dlt = ((double)CPU_TICKS_PER_SECOND / 120);
+			const int duty = Math::clamp((int)((double)ticks / dlt * 100), 0, 100);
+			_duty = duty;
+			emulator_set_duty_ticks(_emulator, 0);
+
+			if (duty > _longPeriodDutyMaxValue)
+				_longPeriodDutyMaxValue = duty;
+			if (++_longPeriodDutyTicks >= (int)(30 * _speed / DEVICE_BASE_SPEED_FACTOR)) { // ~0.5 second.
+				_longPeriodDuty = Math::clamp(_longPeriodDutyMaxValue, 0, 100);
+				_longPeriodDutyMaxValue = 0;
+				_longPeriodDutyTicks = 0;
+			}
+		}
+
+		// Update the audio system.
+		if (event & EMULATOR_EVENT_AUDIO_BUFFER_FULL) {
+			if (onAudio)
+				onAudio();
+		}
+
+		// Break if timeout.
+		if (_timeoutThreshold > 0) {
+			const long long now = DateTime::ticks();
+			const long long diff = now - start;
+			if (diff > _timeoutThreshold) {
+				if (timeout)
+					*timeout = true;
+
+				break;
+			}
+		}
+	} while (!(event & (EMULATOR_EVENT_UNTIL_TICKS | EMULATOR_EVENT_BREAKPOINT | EMULATOR_EVENT_INVALID_OPCODE)));
+
+	if (recording)
+		_recordingReport.seconds += DateTime::toSeconds(DateTime::ticks() - start);
+}
+
+void DeviceBinjgb::tickRtc(double delta) {
+	if (!cartridgeHasRtc())
+		return;
+	if (_recordingActive)
+		return; // The RTC is only latched by the program during an input recording session.
+
+	_rtcTicks += delta;
+	if (_rtcTicks > 0.5) { // Ticks every half second.
+		_rtcTicks -= 0.5;
+		deviceBinjgbRtcLatch(_emulator);
+	}
+}
+
+void DeviceBinjgb::resetRewind(bool enabled) {
+	if (_rewindBuffer) {
+		rewind_delete(_rewindBuffer);
+		_rewindBuffer = nullptr;
+	}
+	memset(&_rewindResult, 0, sizeof(RewindResult));
+	_rewindBeginTicks = 0;
+	_rewinding = false;
+
+	if (enabled && _emulator) {
+		RewindInit init;
+		init.buffer_capacity = _rewindCapacity;
+		init.frames_per_base_state = _rewindFramesPerBaseState;
+		_rewindBuffer = rewind_new(&init, _emulator);
+	}
+}
+
+void DeviceBinjgb::beginRecording(void) {
+	_recordingReport = Recording::Report();
+	_recordingActive = _recordingSession != RecordingModes::NONE;
+	_recordingBeginTicks = emulator_get_ticks(_emulator);
+	_recordingFrame = 0;
+	_recordingFrameTicks = _recordingBeginTicks + PPU_FRAME_TICKS;
+	_recordingHaltCount = emulator_get_halt_count(_emulator);
+	_recordingButtons = 0;
+	if (!_recordingActive)
+		return;
+
+	if (_recordingSession == RecordingModes::RECORD) {
+		_recording.record(0, _recordingButtons);
+
+		fprintf(stdout, "Began recording input.\n");
+	} else {
+		_recordingButtons = _recordingReplay.buttons(0);
+
+		fprintf(stdout, "Began replaying input, %d frames.\n", _recordingReplay.frameCount);
+	}
+
+	// The joypad is polled for the session even without any input device.
+	emulator_set_joypad_callback(_emulator, onInput, this);
+}
+
+void DeviceBinjgb::syncRecording(void) {
+	// Determine the frame by the emulated ticks, it goes back by rewinding.
+	const Ticks now = emulator_get_ticks(_emulator);
+	const int frame = now > _recordingBeginTicks ? (int)((now - _recordingBeginTicks) / PPU_FRAME_TICKS) : 0;
+	if (frame == _recordingFrame)
+		return;
+
+	// Latch the joypad states of the frame.
+	if (frame > _recordingFrame) {
+		if (_recordingSession == RecordingModes::RECORD) {
+			InputSnapshot snapshot;
+#if DEVICE_BINJGB_THREADED_ENABLED
+			if (_threaded)
+				snapshot = _inputSnapshot; // Sampled by the UI thread.
+			else
+				sampleInput(true, snapshot);
+#else /* DEVICE_BINJGB_THREADED_ENABLED */
+			sampleInput(true, snapshot);
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+			_recordingButtons = snapshot.enabled ? joypad_pack_buttons(&snapshot.buttons) : 0;
+			_recording.record(frame, _recordingButtons);
+		} else {
+			_recordingButtons = _recordingReplay.buttons(frame);
+		}
+	} else {
+		// The rewound frame has been partially run with its recorded states, and
+		// the recording after it is dropped.
+		if (_recordingSession == RecordingModes::RECORD) {
+			_recordingButtons = _recording.buttons(frame);
+			_recording.record(frame, _recordingButtons);
+		} else {
+			_recordingButtons = _recordingReplay.buttons(frame);
+		}
+	}
+	_recordingFrame = frame;
+	_recordingFrameTicks = _recordingBeginTicks + (Ticks)(frame + 1) * PPU_FRAME_TICKS;
+
+	// Finish the replay at its end.
+	if (_recordingSession == RecordingModes::REPLAY && _recordingReplay.frameCount > 0 && frame >= _recordingReplay.frameCount)
+		finishReplay();
+}
+
+void DeviceBinjgb::finishReplay(void) {
+	_recordingActive = false;
+	_recordingReport.frameCount = _recordingFrame;
+	_recordingReport.hash = Recording::stateHash(_emulator);
+	_recordingReport.diverged = _recordingReport.hash != _recordingReplay.hash;
+
+	fprintf(
+		stdout,
+		"Replayed %d frames, %s.\n",
+		_recordingReport.frameCount,
+		_recordingReport.diverged ? "diverged" : "matched"
+	);
+}
+
+void DeviceBinjgb::stageFrame(const RGBA* pixels, bool isSgb) {
+	// FEAT: OPTIMIZATION.
+	// It's a plain copy, the texture is uploaded once per update by
+	// `presentFrame(...)` however many frames have been emulated.
+	if (isSgb)
+		memcpy(_videoBuffer, pixels, sizeof(SgbFrameBuffer));
+	else
+		memcpy(_videoBuffer, pixels, sizeof(FrameBuffer));
+}
+
+bool DeviceBinjgb::presentFrame(class Renderer* rnd, class Texture* texture, bool isSgb) {
+	// Prepare.
+	const int bytes = SDL_BYTESPERPIXEL(SDL_PIXELFORMAT_ABGR8888);
+	const int width = isSgb ? SGB_SCREEN_WIDTH : SCREEN_WIDTH;
+	const int height = isSgb ? SGB_SCREEN_HEIGHT : SCREEN_HEIGHT;
+	int first = 0;
+	int last = height - 1;
+
+#if DEVICE_BINJGB_PRESENT_DIFF_ENABLED
+	// Narrow down to the changed scanlines, everything is uploaded for a
+	// different texture.
+	if (texture == _presentedTexture && isSgb == _presentedSgb) {
+		const size_t pitch = width * sizeof(RGBA);
+		while (first <= last && memcmp(_videoBuffer + first * width, _presentedBuffer + first * width, pitch) == 0)
+			++first;
+		while (last > first && memcmp(_videoBuffer + last * width, _presentedBuffer + last * width, pitch) == 0)
+			--last;
+		if (first > last)
+			return false;
+	}
+	_presentedTexture = texture;
+	_presentedSgb = isSgb;
+	memcpy(_presentedBuffer + first * width, _videoBuffer + first * width, (last - first + 1) * width * sizeof(RGBA));
+#endif /* DEVICE_BINJGB_PRESENT_DIFF_ENABLED */
+
+	// Upload.
+	const SDL_Rect rect{ 0, first, width, last - first + 1 };
+	SDL_UpdateTexture((SDL_Texture*)texture->pointer(rnd), &rect, _videoBuffer + first * width, width * bytes);
+	++_uploadedFrames;
+	_uploadedRows += (unsigned)rect.h;
+
+	// Finish.
+	return true;
+}
+
+void DeviceBinjgb::queueAudio(const u8* srcData, u32 srcFrames, unsigned speed, AudioHandler handleAudio) {
+	// Prepare.
+	const int sampleSize = SDL_AUDIO_BITSIZE(_audioSpec.format) / 8;
+
+	// Track the fill level of the audio queue, the rate is tuned slightly to
+	// keep the latency around the target.
+	double adjust = 1.0;
+	bool overflow = false;
+	if (_audioDeviceId && _audioBytesPerSecond > 0) {
+		const Uint32 inq = SDL_GetQueuedAudioSize(_audioDeviceId);
+		const double latency = (double)inq / _audioBytesPerSecond;
+		const double error = Math::clamp(
+			(latency - DEVICE_BINJGB_AUDIO_LATENCY_SECONDS) / DEVICE_BINJGB_AUDIO_LATENCY_SECONDS,
+			-1.0, 1.0
+		);
+		adjust = 1.0 + error * DEVICE_BINJGB_AUDIO_RATE_ADJUSTMENT;
+		overflow = latency > DEVICE_BINJGB_AUDIO_LATENCY_SECONDS * 4; // Far behind, e.g. after a hitch.
+	}
+
+	// Resample.
+	const size_t srcCount = srcFrames * SOUND_OUTPUT_COUNT;
+	_audioInput.resize(srcCount);
+	for (size_t i = 0; i < srcCount; ++i)
+		_audioInput[i] = DEVICE_BINJGB_AUDIO_CONVERT_FROM_U8(srcData[i], 1.0f);
+	_audioOutput.clear();
+	const double ratio = (double)speed / DEVICE_BASE_SPEED_FACTOR;
+	const int frames = _audioResampler.resample(_audioInput.data(), (int)srcFrames, ratio, adjust, _audioOutput);
+
+	_audioBuffer->poke(0);
+	for (int i = 0; i < frames; ++i) {
+		for (int c = 0; c < _audioSpec.channels; ++c) {
+			const int u = c % SOUND_OUTPUT_COUNT;
+			const float val = _audioOutput[i * SOUND_OUTPUT_COUNT + u];
+			_audioBuffer->writeSingle(val);
+		}
+	}
+	const Uint32 len = (Uint32)(frames * _audioSpec.channels * sampleSize);
+	if (len == 0)
+		return;
+
+	// Queue.
+	bool handledAudio = false;
+	if (handleAudio) {
+		handledAudio = handleAudio((void*)&_audioSpec, _audioBuffer.get(), len);
+	}
+	if (!handledAudio && _audioDeviceId && !overflow) {
+		if (_audioCvt.needed) {
+			const size_t newLen = len * _audioCvt.len_mult;
+			if (_audioCvtBufferLength < newLen) {
+				_audioCvtBufferLength = newLen;
+				_audioCvt.buf = (Uint8*)SDL_realloc(_audioCvt.buf, newLen);
+			}
+			_audioCvt.len = (int)len;
+			SDL_memcpy(_audioCvt.buf, _audioBuffer->pointer(), len);
+			SDL_ConvertAudio(&_audioCvt);
+			SDL_QueueAudio(_audioDeviceId, _audioCvt.buf, _audioCvt.len_cvt);
+		} else {
+			SDL_QueueAudio(_audioDeviceId, _audioBuffer->pointer(), len);
+		}
+	}
+}
+
+bool DeviceBinjgb::pollStreaming(Bytes::Ptr &streamed) {
 	// Extension feature: stream transfering.
 	if (_enabledDeviceType != DeviceTypes::CLASSIC_EXTENDED && _enabledDeviceType != DeviceTypes::COLORED_EXTENDED) // GBB EXTENSION.
 		return false;
@@ -1119,7 +1846,30 @@ bool DeviceBinjgb::processStreaming(class Window* wnd, class Renderer* rnd) {
 	if (statusByte == DEVICE_BINJGB_STREAMING_STATUS_READY || statusByte == DEVICE_BINJGB_STREAMING_STATUS_BUSY)
 		return false;
 
-	if (statusByte != DEVICE_BINJGB_STREAMING_STATUS_EOS) {
+	const bool isEos = !!(statusByte & DEVICE_BINJGB_STREAMING_STATUS_EOS);
+	if (statusByte & DEVICE_BINJGB_STREAMING_STATUS_BLOCK) {
+		// FEAT: OPTIMIZATION.
+		// Take the whole published block at once, instead of a byte per poll.
+		const UInt16 address = (UInt16)(
+			emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG) |
+			(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG + 1) << 8)
+		);
+		const UInt16 size = (UInt16)(
+			emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG) |
+			(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG + 1) << 8)
+		);
+		if (!_streamingBuffer)
+			_streamingBuffer = Bytes::Ptr(Bytes::create());
+
+		const size_t count = Math::min((size_t)size, (size_t)0x10000 - address);
+		const size_t offset = _streamingBuffer->count();
+		_streamingBuffer->resize(offset + count);
+		Byte* ptr = _streamingBuffer->pointer() + offset;
+		for (size_t i = 0; i < count; ++i)
+			ptr[i] = emulator_read_u8_raw(_emulator, (Address)(address + i));
+		_streamingBuffer->poke(offset + count);
+	} else if (!isEos) {
+		// Single byte from a program built before the block transfer.
 		if (!_streamingBuffer)
 			_streamingBuffer = Bytes::Ptr(Bytes::create());
 
@@ -1131,20 +1881,18 @@ bool DeviceBinjgb::processStreaming(class Window* wnd, class Renderer* rnd) {
 
 	emulator_write_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_STATUS_REG, DEVICE_BINJGB_STREAMING_STATUS_READY);
 
-	if (statusByte == DEVICE_BINJGB_STREAMING_STATUS_EOS) {
-		if (_debugListener)
-			_debugListener->streamed(wnd, rnd, _streamingBuffer);
+	if (!isEos)
+		return false;
 
-		if (_streamingBuffer)
-			_streamingBuffer = nullptr;
+	streamed = _streamingBuffer;
+	_streamingBuffer = nullptr;
 
-		fprintf(stdout, "Got stream data, bytes: %d.\n", _streamingBuffer ? (int)_streamingBuffer->count() : 0);
-	}
+	fprintf(stdout, "Got stream data, bytes: %d.\n", streamed ? (int)streamed->count() : 0);
 
 	return true;
 }
 
-bool DeviceBinjgb::processShellCommand(class Window* wnd, class Renderer* rnd) {
+bool DeviceBinjgb::pollShellCommand(std::string &cmd) {
 	// Extension feature: shell command.
 	if (_enabledDeviceType != DeviceTypes::CLASSIC_EXTENDED && _enabledDeviceType != DeviceTypes::COLORED_EXTENDED) // GBB EXTENSION.
 		return false;
@@ -1153,16 +1901,29 @@ bool DeviceBinjgb::processShellCommand(class Window* wnd, class Renderer* rnd) {
 	if (statusByte == DEVICE_BINJGB_TRANSFER_STATUS_READY || statusByte == DEVICE_BINJGB_TRANSFER_STATUS_BUSY)
 		return false;
 
-	std::string cmd;
+	// FEAT: OPTIMIZATION.
+	// The area is cleared after each command, so it stops at the terminator.
+	cmd.clear();
 	for (int i = 0; i < DEVICE_BINJGB_TRANSFER_MAX_SIZE; ++i) {
 		const Address address = (Address)(DEVICE_BINJGB_TRANSFER_ADDRESS + i);
 		const u8 byte = emulator_read_u8_raw(_emulator, address);
+		if (byte == 0)
+			break;
 		emulator_write_u8_raw(_emulator, address, 0);
 		cmd.push_back(byte);
 	}
 
 	emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TRANSFER_STATUS_REG, DEVICE_BINJGB_TRANSFER_STATUS_READY);
 
+	return true;
+}
+
+void DeviceBinjgb::dispatchStreamed(class Window* wnd, class Renderer* rnd, Bytes::Ptr streamed) {
+	if (_debugListener)
+		_debugListener->streamed(wnd, rnd, streamed);
+}
+
+void DeviceBinjgb::dispatchShellCommand(class Window* wnd, class Renderer* rnd, const std::string &cmd) {
 	const bool isSurf =
 		Text::startsWith(cmd, "http://", false) ||
 		Text::startsWith(cmd, "https://", false);
@@ -1232,108 +1993,337 @@ bool DeviceBinjgb::processShellCommand(class Window* wnd, class Renderer* rnd) {
 	}
 
 	fprintf(stdout, "Executed shell command: \"%s\".\n", cmd.c_str());
-
-	return true;
 }
 
-void DeviceBinjgb::onInput(JoypadButtons* joyp, void* data) {
+void DeviceBinjgb::sampleInput(bool allowInput, InputSnapshot &snapshot) const {
 	// Prepare.
 	static_assert(INPUT_GAMEPAD_COUNT == 2, "Wrong data.");
 
-	DeviceBinjgb* self = (DeviceBinjgb*)data;
-	Input* input = (Input*)self->_input;
-
-	if (!self->_inputEnabled) {
-		joyp->up     = FALSE;
-		joyp->down   = FALSE;
-		joyp->left   = FALSE;
-		joyp->right  = FALSE;
-		joyp->select = FALSE;
-		joyp->start  = FALSE;
-		joyp->A      = FALSE;
-		joyp->B      = FALSE;
-
-		emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_X_REG,          (u8)0xff);
-		emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_Y_REG,          (u8)0xff);
-		emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG,    (u8)0x00);
-		emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_KEY_MODIFIERS_REG,    (u8)0x00);
-		emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG, (u8)0x00);
+	Input* input = (Input*)_input;
 
+	snapshot = InputSnapshot();
+	snapshot.enabled = input && _inputEnabled && allowInput;
+	if (!snapshot.enabled)
 		return;
-	}
 
-	// Update the joypad.
-	joyp->up = (Bool)(
+	// Sample the joypad.
+	JoypadButtons &joyp = snapshot.buttons;
+	joyp.up = (Bool)(
 		input->buttonDown((int)Input::Buttons::UP,     0) ||
 		input->buttonDown((int)Input::Buttons::UP,     1)
 	);
-	joyp->down = (Bool)(
+	joyp.down = (Bool)(
 		input->buttonDown((int)Input::Buttons::DOWN,   0) ||
 		input->buttonDown((int)Input::Buttons::DOWN,   1)
 	);
-	joyp->left = (Bool)(
+	joyp.left = (Bool)(
 		input->buttonDown((int)Input::Buttons::LEFT,   0) ||
 		input->buttonDown((int)Input::Buttons::LEFT,   1)
 	);
-	joyp->right = (Bool)(
+	joyp.right = (Bool)(
 		input->buttonDown((int)Input::Buttons::RIGHT,  0) ||
 		input->buttonDown((int)Input::Buttons::RIGHT,  1)
 	);
-	joyp->select = (Bool)(
+	joyp.select = (Bool)(
 		input->buttonDown((int)Input::Buttons::SELECT, 0) ||
 		input->buttonDown((int)Input::Buttons::SELECT, 1)
 	);
-	joyp->start = (Bool)(
+	joyp.start = (Bool)(
 		input->buttonDown((int)Input::Buttons::START,  0) ||
 		input->buttonDown((int)Input::Buttons::START,  1)
 	);
-	joyp->A = (Bool)(
+	joyp.A = (Bool)(
 		input->buttonDown((int)Input::Buttons::A,      0) ||
 		input->buttonDown((int)Input::Buttons::A,      1)
 	);
-	joyp->B = (Bool)(
+	joyp.B = (Bool)(
 		input->buttonDown((int)Input::Buttons::B,      0) ||
 		input->buttonDown((int)Input::Buttons::B,      1)
 	);
 
-	// Update the touch states.
-	if (self->_enabledDeviceType == DeviceTypes::CLASSIC_EXTENDED || self->_enabledDeviceType == DeviceTypes::COLORED_EXTENDED) { // GBB EXTENSION.
+	// Sample the touch states.
+	if (_enabledDeviceType == DeviceTypes::CLASSIC_EXTENDED || _enabledDeviceType == DeviceTypes::COLORED_EXTENDED) { // GBB EXTENSION.
 		// Extension feature: touch input.
 		int x = 0;
 		int y = 0;
 		bool p0 = false;
 		bool p1 = false;
+		snapshot.touchEnabled = true;
 		if (input->touch(0, &x, &y, &p0, &p1, nullptr, nullptr, nullptr)) {
-			UInt8 prs = 0x00;
-			if (p0) prs |= DEVICE_BINJGB_MOUSE_BUTTON_0;
-			if (p1) prs |= DEVICE_BINJGB_MOUSE_BUTTON_1;
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_X_REG,       (u8)x);
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_Y_REG,       (u8)y);
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG, (u8)prs);
+			snapshot.touched = true;
+			snapshot.touchX = (UInt8)x;
+			snapshot.touchY = (UInt8)y;
+			if (p0) snapshot.touchButtons |= DEVICE_BINJGB_MOUSE_BUTTON_0;
+			if (p1) snapshot.touchButtons |= DEVICE_BINJGB_MOUSE_BUTTON_1;
+		}
+	}
+
+	// Sample the keyboard modifiers.
+	if (_keyboardModifiers.ctrl)
+		snapshot.keyModifiers |= 0x01;
+	if (_keyboardModifiers.shift)
+		snapshot.keyModifiers |= 0x02;
+	if (_keyboardModifiers.alt)
+		snapshot.keyModifiers |= 0x04;
+	if (_keyboardModifiers.super)
+		snapshot.keyModifiers |= 0x08;
+}
+
+void DeviceBinjgb::applyInput(JoypadButtons* joyp, const InputSnapshot &snapshot) {
+	if (!snapshot.enabled) {
+		joyp->up     = FALSE;
+		joyp->down   = FALSE;
+		joyp->left   = FALSE;
+		joyp->right  = FALSE;
+		joyp->select = FALSE;
+		joyp->start  = FALSE;
+		joyp->A      = FALSE;
+		joyp->B      = FALSE;
+
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_X_REG,          (u8)0xff);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_Y_REG,          (u8)0xff);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG,    (u8)0x00);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_KEY_MODIFIERS_REG,    (u8)0x00);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG, (u8)0x00);
+
+		return;
+	}
+
+	// Update the joypad.
+	*joyp = snapshot.buttons;
+
+	// Update the touch states.
+	if (snapshot.touchEnabled) { // GBB EXTENSION.
+		if (snapshot.touched) {
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_X_REG,       (u8)snapshot.touchX);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_Y_REG,       (u8)snapshot.touchY);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG, (u8)snapshot.touchButtons);
 		} else {
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_X_REG,       (u8)0xff);
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_Y_REG,       (u8)0xff);
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG, (u8)0x00);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_X_REG,       (u8)0xff);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_Y_REG,       (u8)0xff);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_TOUCH_PRESSED_REG, (u8)0x00);
 		}
 	}
 
 	// Update the keyboard states.
-	UInt8 mods = 0x00;
-	if (self->_keyboardModifiers.ctrl)
-		mods |= 0x01;
-	if (self->_keyboardModifiers.shift)
-		mods |= 0x02;
-	if (self->_keyboardModifiers.alt)
-		mods |= 0x04;
-	if (self->_keyboardModifiers.super)
-		mods |= 0x08;
-	emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_KEY_MODIFIERS_REG, (u8)mods);
-	if (!self->_keyBuffer.empty() && emulator_read_u8_raw(self->_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG) == 0x00) {
-		const int key = self->_keyBuffer.front(); // FIFO.
-		self->_keyBuffer.pop_front();
+	emulator_write_u8_raw(_emulator, DEVICE_BINJGB_KEY_MODIFIERS_REG, (u8)snapshot.keyModifiers);
+	if (!_keyBuffer.empty() && emulator_read_u8_raw(_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG) == 0x00) {
+		const int key = _keyBuffer.front(); // FIFO.
+		_keyBuffer.pop_front();
 		if (key)
-			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG, (u8)key);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_KEYBOARD_PRESSED_REG, (u8)key);
+	}
+}
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+void DeviceBinjgb::startThread(void) {
+	_threadQuit = false;
+	_queueDepth = 0;
+
+	_thread = std::thread(
+		[this] (void) -> void {
+			threadProc();
+		}
+	);
+
+	fprintf(stdout, "Emulator thread started.\n");
+}
+
+void DeviceBinjgb::stopThread(void) {
+	if (!_thread.joinable())
+		return;
+
+	{
+		LockGuard<decltype(_threadLock)> guard(_threadLock);
+		_threadQuit = true;
+		_threadSignal.notify_all();
+	}
+	_thread.join();
+
+	// Flush the pending commands in place, and discard the pending output.
+	while (Command* cmd = _commands.front()) {
+		(*cmd)();
+		*cmd = nullptr;
+		_commands.pop();
+	}
+	while (_videoFrames.front())
+		_videoFrames.pop();
+	while (_audioChunks.front())
+		_audioChunks.pop();
+	while (Event* evt = _events.front()) {
+		*evt = Event();
+		_events.pop();
+	}
+
+	fprintf(stdout, "Emulator thread stopped, dropped frames: %u.\n", droppedFrames());
+}
+
+void DeviceBinjgb::threadProc(void) {
+	long long last = DateTime::ticks();
+	while (!_threadQuit) {
+		// Execute the commands from the UI thread.
+		while (Command* cmd = _commands.front()) {
+			(*cmd)();
+			*cmd = nullptr;
+			_commands.pop();
+		}
+
+		// Emulate for the elapsed host time.
+		const long long now = DateTime::ticks();
+		double delta = DateTime::toSeconds(now - last);
+		last = now;
+		if (!_emulatorPaused && !_rewinding) {
+			delta = Math::min(delta, DEVICE_BINJGB_DELTA_TIME_MIN_SECONDS);
+			const Ticks deltaTicks = (Ticks)(delta * CPU_TICKS_PER_SECOND);
+			const Ticks scaleTicks = deltaTicks * _speed / DEVICE_BASE_SPEED_FACTOR;
+			const Ticks untilTicks = emulator_get_ticks(_emulator) + scaleTicks;
+			tick(
+				untilTicks, nullptr,
+				[this] (void) -> void {
+					// Hand the frame over, it's dropped if the UI thread falls behind.
+					VideoFrame* frame = _videoFrames.acquire();
+					if (!frame)
+						return;
+
+					frame->isSgb = _sgbFrames;
+					if (frame->isSgb)
+						memcpy(frame->pixels, *emulator_get_sgb_frame_buffer(_emulator), sizeof(SgbFrameBuffer));
+					else
+						memcpy(frame->pixels, *emulator_get_frame_buffer(_emulator), sizeof(FrameBuffer));
+					_videoFrames.commit();
+				},
+				[this] (void) -> void {
+					// Hand the samples over, they're skipped if the UI thread falls behind.
+					AudioChunk* chunk = _audioChunks.acquire();
+					if (!chunk)
+						return;
+
+					AudioBuffer* srcBuffer = emulator_get_audio_buffer(_emulator);
+					chunk->frames = audio_buffer_get_frames(srcBuffer);
+					chunk->data.assign(srcBuffer->data, srcBuffer->data + chunk->frames * SOUND_OUTPUT_COUNT);
+					chunk->speed = _speed;
+					_audioChunks.commit();
+				}
+			);
+
+			// Tick the RTC.
+			tickRtc(delta);
+
+			// Poll the streaming and shell command area, only if there's room
+			// for the event, otherwise it's polled again in the next slice.
+			Event* evt = _events.acquire();
+			if (evt && pollStreaming(evt->streamed)) {
+				evt->isStreamed = true;
+				_events.commit();
+				evt = _events.acquire();
+			}
+			if (evt && pollShellCommand(evt->command)) {
+				evt->isStreamed = false;
+				_events.commit();
+			}
+		}
+
+		// Wait for the next slice or a command.
+		std::unique_lock<decltype(_threadLock)> guard(_threadLock);
+		_threadSignal.wait_for(
+			guard,
+			std::chrono::milliseconds(DEVICE_BINJGB_THREAD_SLICE_MILLISECONDS),
+			[this] (void) -> bool {
+				return _threadQuit || !_commands.empty();
+			}
+		);
+	}
+}
+
+void DeviceBinjgb::updateThreaded(
+	class Window* wnd, class Renderer* rnd,
+	class Texture* texture, bool isSgb,
+	bool allowInput,
+	AudioHandler handleAudio
+) {
+	// Hand the input states over.
+	if (_input) {
+		InputSnapshot snapshot;
+		sampleInput(allowInput, snapshot);
+		invoke(
+			[this, snapshot] (void) -> void {
+				_inputSnapshot = snapshot;
+			},
+			false
+		);
+	}
+	_sgbFrames = isSgb;
+
+	// Present the latest frame, the stale ones are skipped.
+	const size_t depth = _videoFrames.count();
+	_queueDepth = (int)depth;
+	for (size_t i = 0; i + 1 < depth; ++i)
+		_videoFrames.pop();
+	if (depth > 0) {
+		const VideoFrame* frame = _videoFrames.front();
+		if (texture && frame->isSgb == isSgb) {
+			stageFrame(frame->pixels, isSgb);
+			presentFrame(rnd, texture, isSgb);
+		}
+		_videoFrames.pop();
+		++_presentedFrames;
+	}
+
+	// Queue the audio.
+	while (const AudioChunk* chunk = _audioChunks.front()) {
+		queueAudio(chunk->data.data(), chunk->frames, chunk->speed, handleAudio);
+		_audioChunks.pop();
+	}
+
+	// Dispatch the streamed data and shell commands.
+	while (Event* evt = _events.front()) {
+		const Event evt_ = *evt;
+		*evt = Event();
+		_events.pop();
+
+		if (evt_.isStreamed)
+			dispatchStreamed(wnd, rnd, evt_.streamed);
+		else
+			dispatchShellCommand(wnd, rnd, evt_.command);
+		if (!_emulator) // Closed by the listener.
+			break;
+	}
+}
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
+void DeviceBinjgb::onInput(JoypadButtons* joyp, void* data) {
+	DeviceBinjgb* self = (DeviceBinjgb*)data;
+
+	if (self->_rewinding) {
+		// No input while previewing a rewound frame.
+		self->applyInput(joyp, InputSnapshot());
+
+		return;
 	}
+
+	if (self->_recordingActive) {
+		// Latched at the beginning of the frame, there's no touch input, the
+		// same as the runner.
+		*joyp = joypad_unpack_buttons(self->_recordingButtons);
+		if (self->_enabledDeviceType == DeviceTypes::CLASSIC_EXTENDED || self->_enabledDeviceType == DeviceTypes::COLORED_EXTENDED) { // GBB EXTENSION.
+			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_X_REG, (u8)0xff);
+			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_Y_REG, (u8)0xff);
+		}
+
+		return;
+	}
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	if (self->_threaded) {
+		// Sampled by the UI thread.
+		self->applyInput(joyp, self->_inputSnapshot);
+
+		return;
+	}
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
+	self->sampleInput(true, self->_inputSnapshot);
+	self->applyInput(joyp, self->_inputSnapshot);
 }
 
 /* ===========================================================================} */
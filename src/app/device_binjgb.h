@@ -11,8 +11,77 @@
 
 #include "../gbbasic.h"
 #include "device.h"
+#include "../utils/plus.h"
 #include "../../lib/binjgb/src/emulator-debug.h"
+#include "../../lib/binjgb/src/rewind.h"
 #include <SDL.h>
+#include <condition_variable>
+#include <thread>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+// Indicates whether the emulator core can run on its own thread.
+#ifndef DEVICE_BINJGB_THREADED_ENABLED
+#	define DEVICE_BINJGB_THREADED_ENABLED GBBASIC_MULTITHREAD_ENABLED
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
+// Indicates whether to upload only the changed scanlines on presenting.
+#ifndef DEVICE_BINJGB_PRESENT_DIFF_ENABLED
+#	define DEVICE_BINJGB_PRESENT_DIFF_ENABLED 1
+#endif /* DEVICE_BINJGB_PRESENT_DIFF_ENABLED */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Audio resampler
+*/
+
+/**
+ * @brief Band-limited resampler for interleaved stereo audio. It filters with a
+ *   polyphase windowed-sinc kernel whose cutoff follows the ratio, so that
+ *   fast-forwarded audio doesn't alias; the frames are passed through as is at
+ *   exactly unit ratio.
+ */
+class AudioResampler {
+public:
+	typedef std::vector<float> Samples;
+
+private:
+	Samples _history; // Interleaved input frames still in reach of the kernel.
+	UInt64 _position = 0; // Input frames since the first in `_history`, 32.32 fixed point.
+	Samples _kernel; // Polyphase table, one row of `_kernelTaps` per phase.
+	int _kernelTaps = 0;
+	double _kernelRatio = 0; // The ratio that `_kernel` was built for.
+
+public:
+	AudioResampler();
+
+	/**
+	 * @brief Resets to silence.
+	 */
+	void reset(void);
+
+	/**
+	 * @brief Resamples the specific frames and appends the output to `dst`.
+	 *
+	 * @param[in] src Interleaved stereo frames.
+	 * @param ratio The input rate divided by the output rate, it determines the
+	 *   cutoff.
+	 * @param adjust Fine tuning of the ratio, it doesn't affect the cutoff.
+	 * @param[out] dst Interleaved stereo frames.
+	 * @return The count of the output frames.
+	 */
+	int resample(const float* src, int frames, double ratio, double adjust, Samples &dst);
+
+private:
+	void build(double ratio);
+};
+
+/* ===========================================================================} */
 
 /*
 ** {===========================================================================
@@ -20,9 +89,49 @@
 */
 
 class DeviceBinjgb : public Device, public virtual Object {
+private:
+	/**
+	 * @brief Input states sampled on the UI thread, and applied to the
+	 *   emulator when it polls the joypad.
+	 */
+	struct InputSnapshot {
+		bool enabled = false;
+		JoypadButtons buttons;
+		bool touchEnabled = false;
+		bool touched = false;
+		UInt8 touchX = 0xff;
+		UInt8 touchY = 0xff;
+		UInt8 touchButtons = 0x00;
+		UInt8 keyModifiers = 0x00;
+
+		InputSnapshot();
+	};
+
+	typedef std::function<void(void)> Command;
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	struct VideoFrame {
+		RGBA pixels[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT];
+		bool isSgb = false;
+	};
+
+	struct AudioChunk {
+		std::vector<u8> data;
+		u32 frames = 0;
+		unsigned speed = 0;
+	};
+
+	struct Event {
+		bool isStreamed = false; // Streamed data, otherwise shell command.
+		Bytes::Ptr streamed = nullptr;
+		std::string command;
+	};
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
+
 private:
 	bool _opened = false;
 	Protocol* _debugListener = nullptr;
+	bool _threaded = false;
 	DeviceTypes _deviceType = DeviceTypes::COLORED; // Determined by device.
 	DeviceTypes _enabledDeviceType = DeviceTypes::COLORED; // Determined by both device and ROM.
 	int _cartridgeType = 0;
@@ -32,32 +141,83 @@ private:
 	int _sramType = 0;
 	Colour _classicPalette[4];
 	Emulator* _emulator = nullptr;
-	bool _emulatorPaused = false;
+	Atomic<bool> _emulatorPaused;
 	double _rtcTicks = 0;
 	Bytes::Ptr _streamingBuffer = nullptr;
-	RGBA _videoBuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+	RGBA _videoBuffer[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT]; // The latest completed frame.
+#if DEVICE_BINJGB_PRESENT_DIFF_ENABLED
+	RGBA _presentedBuffer[SGB_SCREEN_WIDTH * SGB_SCREEN_HEIGHT]; // What the texture holds.
+	const class Texture* _presentedTexture = nullptr;
+	bool _presentedSgb = false;
+#endif /* DEVICE_BINJGB_PRESENT_DIFF_ENABLED */
 	SDL_AudioDeviceID _audioDeviceId = 0;
 	SDL_AudioSpec _audioSpec;
 	SDL_AudioCVT _audioCvt;
 	size_t _audioCvtBufferLength = 0;
 	Bytes::Ptr _audioBuffer = nullptr;
+	AudioResampler _audioResampler;
+	AudioResampler::Samples _audioInput;
+	AudioResampler::Samples _audioOutput;
+	int _audioBytesPerSecond = 0; // Of the audio queue.
 	class Input* _input = nullptr; // Foreign.
 	bool _inputEnabled = true;
+	InputSnapshot _inputSnapshot; // Used by the emulator.
 	KeyboardModifiers _keyboardModifiers;
 	KeyBuffer _keyBuffer; // FIFO.
-	unsigned _speed = DEVICE_BASE_SPEED_FACTOR * 1;
+	Atomic<unsigned> _speed;
 	Ticks _previousTicks = 0;
 	unsigned _updatedFrameCount = 0;
 	double _updatedSeconds = 0;
-	unsigned _fps = 59;
-	int _duty = 0;
+	Atomic<unsigned> _fps;
+	Atomic<int> _duty;
 	long long _timeoutThreshold = 0;
-	int _longPeriodDuty = 0;
+	Atomic<int> _longPeriodDuty;
 	int _longPeriodDutyMaxValue = 0;
 	int _longPeriodDutyTicks = 0;
+	Atomic<unsigned> _emulatedFrames; // Written by the emulator.
+	unsigned _presentedFrames = 0; // Written by the UI thread.
+	unsigned _uploadedFrames = 0;
+	unsigned _uploadedRows = 0;
+	long long _openedTimestamp = 0;
+	RewindBuffer* _rewindBuffer = nullptr;
+	size_t _rewindCapacity = DEVICE_DEFAULT_REWIND_BUDGET_MB * 1024 * 1024;
+	int _rewindFramesPerBaseState = DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL;
+	Atomic<bool> _rewinding;
+	Ticks _rewindBeginTicks = 0;
+	RewindResult _rewindResult; // Valid if `_rewindResult.info` is not null.
+	unsigned _rewindCapturedFrames = 0;
+	long long _rewindCaptureCost = 0; // In ticks of `DateTime`.
+	Profiler _profiler;
+	int _profilerInterval = 0;
+	std::string _profilerSymbols;
+	Profiler::Line::Array _profilerLines;
+	RecordingModes _recordingMode = RecordingModes::NONE; // For the next opening.
+	Recording _recordingReplay;
+	RecordingModes _recordingSession = RecordingModes::NONE; // Since opened.
+	bool _recordingActive = false; // Whether the input is still from or to the session.
+	Recording _recording;
+	Recording::Report _recordingReport;
+	Ticks _recordingBeginTicks = 0;
+	int _recordingFrame = 0;
+	Ticks _recordingFrameTicks = 0; // End of the current frame.
+	UInt8 _recordingButtons = 0;
+	UInt32 _recordingHaltCount = 0; // At the last vertical sync.
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	std::thread _thread;
+	Atomic<bool> _threadQuit;
+	Mutex _threadLock;
+	std::condition_variable_any _threadSignal;
+	RingBuffer<Command> _commands; // From the UI thread to the emulator.
+	RingBuffer<VideoFrame> _videoFrames; // From the emulator to the UI thread.
+	RingBuffer<AudioChunk> _audioChunks; // From the emulator to the UI thread.
+	RingBuffer<Event> _events; // From the emulator to the UI thread.
+	Atomic<bool> _sgbFrames;
+	int _queueDepth = 0;
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
 
 public:
-	DeviceBinjgb(Protocol* dbgListener);
+	DeviceBinjgb(Protocol* dbgListener, bool threaded);
 	virtual ~DeviceBinjgb() override;
 
 	virtual unsigned type(void) const override;
@@ -119,11 +279,72 @@ public:
 	virtual bool readSram(const Bytes* bytes) override;
 	virtual bool writeSram(Bytes* bytes) override;
 
+	virtual bool readState(const Bytes* bytes) override;
+	virtual bool writeState(Bytes* bytes) override;
+
+	virtual size_t rewindBudget(int* keyframeInterval) const override;
+	virtual void rewindBudget(size_t bytes, int keyframeInterval) override;
+	virtual bool rewinding(void) const override;
+	virtual bool rewindBegin(void) override;
+	virtual bool rewindTo(double seconds, double* reached) override;
+	virtual void rewindEnd(void) override;
+
+	virtual int profilerInterval(void) const override;
+	virtual void profilerInterval(int ticks, const std::string &symbols, const Profiler::Line::Array &lines) override;
+	virtual bool profile(Profiler::Report &report) override;
+
+	virtual RecordingModes recordingMode(void) const override;
+	virtual void recordingMode(RecordingModes mode, const Recording &replay) override;
+	virtual bool recordingEnd(Recording &recording, Recording::Report &report) override;
+
+	/**
+	 * @brief Gets whether the emulator core runs on its own thread.
+	 */
+	bool threaded(void) const;
+	/**
+	 * @brief Gets the emulated frames that have never been presented, since
+	 *   opened.
+	 */
+	unsigned droppedFrames(void) const;
+	/**
+	 * @brief Gets the depth of the frame queue at the latest update.
+	 */
+	int queueDepth(void) const;
+
 private:
 	void setBwPalette(PaletteType type, u32 white, u32 light_gray, u32 dark_gray, u32 black);
 
-	bool processStreaming(class Window* wnd, class Renderer* rnd);
-	bool processShellCommand(class Window* wnd, class Renderer* rnd);
+	bool invoke(Command cmd, bool wait);
+
+	void tick(Ticks untilTicks, bool* timeout, std::function<void(void)> onFrame, std::function<void(void)> onAudio);
+	void tickRtc(double delta);
+	void resetRewind(bool enabled);
+	void beginRecording(void);
+	void syncRecording(void);
+	void finishReplay(void);
+	void stageFrame(const RGBA* pixels, bool isSgb);
+	bool presentFrame(class Renderer* rnd, class Texture* texture, bool isSgb);
+	void queueAudio(const u8* srcData, u32 srcFrames, unsigned speed, AudioHandler handleAudio);
+
+	bool pollStreaming(Bytes::Ptr &streamed);
+	bool pollShellCommand(std::string &cmd);
+	void dispatchStreamed(class Window* wnd, class Renderer* rnd, Bytes::Ptr streamed);
+	void dispatchShellCommand(class Window* wnd, class Renderer* rnd, const std::string &cmd);
+
+	void sampleInput(bool allowInput, InputSnapshot &snapshot) const;
+	void applyInput(JoypadButtons* joyp, const InputSnapshot &snapshot);
+
+#if DEVICE_BINJGB_THREADED_ENABLED
+	void startThread(void);
+	void stopThread(void);
+	void threadProc(void);
+	void updateThreaded(
+		class Window* wnd, class Renderer* rnd,
+		class Texture* texture, bool isSgb,
+		bool allowInput,
+		AudioHandler handleAudio
+	);
+#endif /* DEVICE_BINJGB_THREADED_ENABLED */
 
 	static void onInput(JoypadButtons* joyp, void* data);
 };
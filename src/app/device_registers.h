@@ -0,0 +1,213 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#ifndef __DEVICE_REGISTERS_H__
+#define __DEVICE_REGISTERS_H__
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS
+#	define DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS 0x0143
+#endif /* DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS */
+#ifndef DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS
+#	define DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS 0x0146
+#endif /* DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS */
+#ifndef DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS
+#	define DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS 0x0147
+#endif /* DEVICE_BINJGB_CONTROLLER_TYPE_ADDRESS */
+#ifndef DEVICE_BINJGB_ROM_SIZE_ADDRESS
+#	define DEVICE_BINJGB_ROM_SIZE_ADDRESS 0x0148
+#endif /* DEVICE_BINJGB_ROM_SIZE_ADDRESS */
+#ifndef DEVICE_BINJGB_SRAM_SIZE_ADDRESS
+#	define DEVICE_BINJGB_SRAM_SIZE_ADDRESS 0x0149
+#endif /* DEVICE_BINJGB_SRAM_SIZE_ADDRESS */
+
+// For `DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS`.
+#ifndef DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE 0x00
+#endif /* DEVICE_BINJGB_CARTRIDGE_GB_ONLY_TYPE */
+#ifndef DEVICE_BINJGB_CARTRIDGE_CGB_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_CGB_TYPE 0x80 // The cartridge supports colored functions, but works on classic also.
+#endif /* DEVICE_BINJGB_CARTRIDGE_CGB_TYPE */
+#ifndef DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE 0xc0 // The cartridge works on colored device only (physically the same as 0x80).
+#endif /* DEVICE_BINJGB_CARTRIDGE_CGB_ONLY_TYPE */
+#ifndef DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE 0x20 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE */
+
+// For `DEVICE_BINJGB_CARTRIDGE_SUPER_TYPE_ADDRESS`.
+#ifndef DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE 0x00
+#endif /* DEVICE_BINJGB_CARTRIDGE_WITHOUT_SGB_SUPPORT_TYPE */
+#ifndef DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE
+#	define DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE 0x03 // The cartridge supports super functions.
+#endif /* DEVICE_BINJGB_CARTRIDGE_WITH_SGB_SUPPORT_TYPE */
+
+#ifndef DEVICE_BINJGB_EXTENSION_AREA_SIZE
+#	define DEVICE_BINJGB_EXTENSION_AREA_SIZE 0x60 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_EXTENSION_AREA_SIZE */
+#ifndef DEVICE_BINJGB_EXTENSION_START_ADDRESS
+#	define DEVICE_BINJGB_EXTENSION_START_ADDRESS 0xfea0 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_EXTENSION_START_ADDRESS */
+#ifndef DEVICE_BINJGB_EXTENSION_STATUS_REG
+#	define DEVICE_BINJGB_EXTENSION_STATUS_REG 0xfea0 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_EXTENSION_STATUS_REG */
+#ifndef DEVICE_BINJGB_PLATFORM_FLAGS_REG
+#	define DEVICE_BINJGB_PLATFORM_FLAGS_REG 0xfea1 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_FLAGS_REG */
+#ifndef DEVICE_BINJGB_LOCALIZATION_FLAGS_REG
+#	define DEVICE_BINJGB_LOCALIZATION_FLAGS_REG 0xfea2 // GBB EXTENSION. Not documented.
+#endif /* DEVICE_BINJGB_LOCALIZATION_FLAGS_REG */
+#ifndef DEVICE_BINJGB_TOUCH_X_REG
+#	define DEVICE_BINJGB_TOUCH_X_REG 0xfea4 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TOUCH_X_REG */
+#ifndef DEVICE_BINJGB_TOUCH_Y_REG
+#	define DEVICE_BINJGB_TOUCH_Y_REG 0xfea5 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TOUCH_Y_REG */
+#ifndef DEVICE_BINJGB_TOUCH_PRESSED_REG
+#	define DEVICE_BINJGB_TOUCH_PRESSED_REG 0xfea6 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TOUCH_PRESSED_REG */
+#ifndef DEVICE_BINJGB_KEY_MODIFIERS_REG
+#	define DEVICE_BINJGB_KEY_MODIFIERS_REG 0xfea8 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_KEY_MODIFIERS_REG */
+#ifndef DEVICE_BINJGB_KEYBOARD_PRESSED_REG
+#	define DEVICE_BINJGB_KEYBOARD_PRESSED_REG 0xfea9 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_KEYBOARD_PRESSED_REG */
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_REG
+#	define DEVICE_BINJGB_STREAMING_STATUS_REG 0xfeac // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_REG */
+#ifndef DEVICE_BINJGB_STREAMING_ADDRESS
+#	define DEVICE_BINJGB_STREAMING_ADDRESS 0xfead // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_ADDRESS */
+#ifndef DEVICE_BINJGB_TRANSFER_STATUS_REG
+#	define DEVICE_BINJGB_TRANSFER_STATUS_REG 0xfeaf // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_STATUS_REG */
+#ifndef DEVICE_BINJGB_TRANSFER_ADDRESS
+#	define DEVICE_BINJGB_TRANSFER_ADDRESS 0xfeb0 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_ADDRESS */
+#ifndef DEVICE_BINJGB_TRANSFER_MAX_SIZE
+#	define DEVICE_BINJGB_TRANSFER_MAX_SIZE 0x40 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_MAX_SIZE */
+#ifndef DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG
+#	define DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG 0xfef0 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG */
+#ifndef DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG
+#	define DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG 0xfef2 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG */
+
+// For `DEVICE_BINJGB_EXTENSION_STATUS_REG`.
+#ifndef DEVICE_BINJGB_CPU_CGB_TYPE
+#	define DEVICE_BINJGB_CPU_CGB_TYPE 0x11 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_CPU_CGB_TYPE */
+#ifndef DEVICE_BINJGB_CPU_GB1_TYPE
+#	define DEVICE_BINJGB_CPU_GB1_TYPE 0x21 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_CPU_GB1_TYPE */
+#ifndef DEVICE_BINJGB_CPU_GB2_TYPE
+#	define DEVICE_BINJGB_CPU_GB2_TYPE 0x31 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_CPU_GB2_TYPE */
+
+// For `DEVICE_BINJGB_PLATFORM_FLAGS_REG`.
+#ifndef DEVICE_BINJGB_PLATFORM_EDITOR_FLAG
+#	define DEVICE_BINJGB_PLATFORM_EDITOR_FLAG 0b10000000 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_EDITOR_FLAG */
+#ifndef DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG
+#	define DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG 0b00000001 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG */
+#ifndef DEVICE_BINJGB_PLATFORM_LINUX_FLAG
+#	define DEVICE_BINJGB_PLATFORM_LINUX_FLAG 0b00000010 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_LINUX_FLAG */
+#ifndef DEVICE_BINJGB_PLATFORM_MACOS_FLAG
+#	define DEVICE_BINJGB_PLATFORM_MACOS_FLAG 0b00000100 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_MACOS_FLAG */
+#ifndef DEVICE_BINJGB_PLATFORM_HTML_FLAG
+#	define DEVICE_BINJGB_PLATFORM_HTML_FLAG 0b00001000 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_PLATFORM_HTML_FLAG */
+
+// For `DEVICE_BINJGB_TOUCH_PRESSED_REG`.
+#ifndef DEVICE_BINJGB_MOUSE_BUTTON_0
+#	define DEVICE_BINJGB_MOUSE_BUTTON_0 0x01 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_MOUSE_BUTTON_0 */
+#ifndef DEVICE_BINJGB_MOUSE_BUTTON_1
+#	define DEVICE_BINJGB_MOUSE_BUTTON_1 0x02 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_MOUSE_BUTTON_1 */
+
+// For `DEVICE_BINJGB_STREAMING_STATUS_REG`.
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_READY
+#	define DEVICE_BINJGB_STREAMING_STATUS_READY 0x00 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_READY */
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_BUSY
+#	define DEVICE_BINJGB_STREAMING_STATUS_BUSY 0x01 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_BUSY */
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_FILLED
+#	define DEVICE_BINJGB_STREAMING_STATUS_FILLED 0x02 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_FILLED */
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_BLOCK
+#	define DEVICE_BINJGB_STREAMING_STATUS_BLOCK 0x04 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_BLOCK */
+#ifndef DEVICE_BINJGB_STREAMING_STATUS_EOS
+#	define DEVICE_BINJGB_STREAMING_STATUS_EOS 0x80 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_STREAMING_STATUS_EOS */
+
+// For `DEVICE_BINJGB_TRANSFER_STATUS_REG`.
+#ifndef DEVICE_BINJGB_TRANSFER_STATUS_READY
+#	define DEVICE_BINJGB_TRANSFER_STATUS_READY 0x00 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_STATUS_READY */
+#ifndef DEVICE_BINJGB_TRANSFER_STATUS_BUSY
+#	define DEVICE_BINJGB_TRANSFER_STATUS_BUSY 0x01 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_STATUS_BUSY */
+#ifndef DEVICE_BINJGB_TRANSFER_STATUS_FILLED
+#	define DEVICE_BINJGB_TRANSFER_STATUS_FILLED 0x02 // GBB EXTENSION.
+#endif /* DEVICE_BINJGB_TRANSFER_STATUS_FILLED */
+
+// For the MBC3 RTC.
+#ifndef DEVICE_BINJGB_RAM_ENABLE_REG
+#	define DEVICE_BINJGB_RAM_ENABLE_REG 0x0000
+#endif /* DEVICE_BINJGB_RAM_ENABLE_REG */
+#ifndef DEVICE_BINJGB_RTC_SELECT_REG
+#	define DEVICE_BINJGB_RTC_SELECT_REG 0x4000
+#endif /* DEVICE_BINJGB_RTC_SELECT_REG */
+#ifndef DEVICE_BINJGB_RTC_LATCH_REG
+#	define DEVICE_BINJGB_RTC_LATCH_REG 0x6000
+#endif /* DEVICE_BINJGB_RTC_LATCH_REG */
+#ifndef DEVICE_BINJGB_RTC_VALUE_REG
+#	define DEVICE_BINJGB_RTC_VALUE_REG 0xa000
+#endif /* DEVICE_BINJGB_RTC_VALUE_REG */
+
+// For `DEVICE_BINJGB_RTC_SELECT_REG`.
+#ifndef DEVICE_BINJGB_RTC_VALUE_SEC
+#	define DEVICE_BINJGB_RTC_VALUE_SEC 0x08
+#endif /* DEVICE_BINJGB_RTC_VALUE_SEC */
+#ifndef DEVICE_BINJGB_RTC_VALUE_MIN
+#	define DEVICE_BINJGB_RTC_VALUE_MIN 0x09
+#endif /* DEVICE_BINJGB_RTC_VALUE_MIN */
+#ifndef DEVICE_BINJGB_RTC_VALUE_HOUR
+#	define DEVICE_BINJGB_RTC_VALUE_HOUR 0x0a
+#endif /* DEVICE_BINJGB_RTC_VALUE_HOUR */
+#ifndef DEVICE_BINJGB_RTC_VALUE_DAY
+#	define DEVICE_BINJGB_RTC_VALUE_DAY 0x0b
+#endif /* DEVICE_BINJGB_RTC_VALUE_DAY */
+#ifndef DEVICE_BINJGB_RTC_VALUE_FLAGS
+#	define DEVICE_BINJGB_RTC_VALUE_FLAGS 0x0c
+#endif /* DEVICE_BINJGB_RTC_VALUE_FLAGS */
+
+// For `DEVICE_BINJGB_RTC_VALUE_FLAGS`.
+#ifndef DEVICE_BINJGB_RTC_TIMER_STOP
+#	define DEVICE_BINJGB_RTC_TIMER_STOP 0b01000000
+#endif /* DEVICE_BINJGB_RTC_TIMER_STOP */
+
+#ifndef DEVICE_BINJGB_RANDOM_SEED
+#	define DEVICE_BINJGB_RANDOM_SEED 0xcabba6e5 // Fixed, so that runs are reproducible.
+#endif /* DEVICE_BINJGB_RANDOM_SEED */
+
+/* ===========================================================================} */
+
+#endif /* __DEVICE_REGISTERS_H__ */
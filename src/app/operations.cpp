@@ -4159,9 +4159,41 @@ promise::Promise Operations::projectRun(Window*, Renderer*, Workspace* ws, Bytes
 			ws->category(Workspace::Categories::EMULATOR);
 			ws->tabsWidth(0.0f);
 
-			ws->canvasDevice(Device::Ptr(Device::create(Device::CoreTypes::BINJGB, ws)));
+			const Device::CoreTypes coreType = ws->settings().emulatorThreaded ?
+				Device::CoreTypes::BINJGB_THREADED :
+				Device::CoreTypes::BINJGB;
+			ws->canvasDevice(Device::Ptr(Device::create(coreType, ws)));
 			for (int i = 0; i < GBBASIC_COUNTOF(ws->settings().deviceClassicPalette); ++i)
 				ws->canvasDevice()->classicPalette(i, ws->settings().deviceClassicPalette[i]);
+			ws->canvasDevice()->rewindBudget(
+				(size_t)Math::max(ws->settings().emulatorRewindBudget, 0) * 1024 * 1024,
+				ws->settings().emulatorRewindKeyframeInterval
+			);
+			if (ws->currentProject()->contentType() == Project::ContentTypes::BASIC) {
+				ws->canvasDevice()->profilerInterval(
+					ws->settings().emulatorProfilerInterval,
+					ws->canvasProfilerSymbols(), ws->canvasProfilerLines()
+				);
+			}
+			Recording replay;
+			if (!ws->settings().emulatorReplayInput.empty()) {
+				const std::string &path = ws->settings().emulatorReplayInput;
+				File::Ptr file(File::create());
+				std::string txt;
+				int ln = 0;
+				if (!file->open(path.c_str(), Stream::READ) || !file->readString(txt)) {
+					const std::string msg = "Cannot read input recording at \"" + path + "\".";
+					ws->warn(msg.c_str());
+				} else if (!replay.parse(txt, &ln)) {
+					const std::string msg = "Invalid input recording at \"" + path + "\", line " + Text::toString(ln) + ".";
+					ws->warn(msg.c_str());
+				} else {
+					ws->canvasDevice()->recordingMode(Device::RecordingModes::REPLAY, replay);
+				}
+				file->close();
+			} else if (!ws->settings().emulatorRecordInput.empty()) {
+				ws->canvasDevice()->recordingMode(Device::RecordingModes::RECORD, replay);
+			}
 			const bool suc = ws->canvasDevice()->open(
 				rom,
 				(Device::DeviceTypes)ws->settings().deviceType, true, true, ws->input(),
@@ -4240,8 +4272,54 @@ promise::Promise Operations::projectStop(Window*, Renderer*, Workspace* ws) {
 				ws->category(ws->categoryBeforeCompiling());
 			ws->tabsWidth(0.0f);
 
+			Profiler::Report report;
+			if (ws->canvasDevice()->profile(report)) {
+				const Text::Array lines = Profiler::format(report, PROFILER_DEFAULT_TOP_COUNT);
+				for (const std::string &ln : lines)
+					ws->print(ln.c_str());
+			}
+
+			Recording recording;
+			Recording::Report recordingReport;
+			const Device::RecordingModes recordingMode = ws->canvasDevice()->recordingMode();
+			if (ws->canvasDevice()->recordingEnd(recording, recordingReport)) {
+				if (recordingMode == Device::RecordingModes::RECORD) {
+					const std::string &path = ws->settings().emulatorRecordInput;
+					File::Ptr file(File::create());
+					if (file->open(path.c_str(), Stream::WRITE)) {
+						file->writeString(recording.toString());
+						file->close();
+
+						const std::string msg = "Recorded " + Text::toString(recording.frameCount) + " frames of input to \"" + path + "\".";
+						ws->print(msg.c_str());
+					} else {
+						const std::string msg = "Cannot write input recording to \"" + path + "\".";
+						ws->warn(msg.c_str());
+					}
+				}
+
+				const char* verdict = "";
+				if (recordingMode == Device::RecordingModes::REPLAY)
+					verdict = !recordingReport.hash ? ", not replayed to the end" : (recordingReport.diverged ? ", DIVERGED" : ", matched");
+				const std::string msg = Text::cformat(
+					"Input %s: %d frames, %d lag frames, %.3fms per frame, state: %016llx%s.",
+					recordingMode == Device::RecordingModes::RECORD ? "recorded" : "replayed",
+					recordingReport.frameCount,
+					recordingReport.lagFrames,
+					recordingReport.frameCount > 0 ? recordingReport.seconds * 1000 / recordingReport.frameCount : 0.0,
+					(unsigned long long)recordingReport.hash,
+					verdict
+				);
+				if (recordingReport.diverged)
+					ws->warn(msg.c_str());
+				else
+					ws->print(msg.c_str());
+			}
+
 			sram = Bytes::Ptr(Bytes::create());
 			ws->canvasDevice()->close(sram);
+			if (sram->empty())
+				sram = nullptr; // Not kept from a recording session.
 			ws->canvasDevice(nullptr);
 			ws->canvasStatusText().clear();
 			ws->canvasStatusTooltip().clear();
@@ -4409,7 +4487,7 @@ promise::Promise Operations::projectSaveSram(Window* wnd, Renderer* rnd, Workspa
 			}
 
 			const std::string sramType = prj->sramType();
-			if (sramType.empty() || sramType == "0") {
+			if (sramType.empty() || sramType == "0" || !sram || sram->empty()) {
 				df.resolve(true);
 
 				fprintf(stdout, "Ignore SRAM saving.\n");
@@ -0,0 +1,365 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#include "profiler.h"
+#include "../../lib/binjgb/src/emulator-debug.h"
+#include <algorithm>
+#include <cstdlib>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef PROFILER_CONTEXT_PC_OFFSET
+#	define PROFILER_CONTEXT_PC_OFFSET 0 // `SCRIPT_CTX::PC`.
+#endif /* PROFILER_CONTEXT_PC_OFFSET */
+#ifndef PROFILER_CONTEXT_BANK_OFFSET
+#	define PROFILER_CONTEXT_BANK_OFFSET 2 // `SCRIPT_CTX::bank`.
+#endif /* PROFILER_CONTEXT_BANK_OFFSET */
+
+#ifndef PROFILER_FRAME_TICKS
+#	define PROFILER_FRAME_TICKS 70224 // CPU ticks per frame.
+#endif /* PROFILER_FRAME_TICKS */
+
+#ifndef PROFILER_UNKNOWN_NAME
+#	define PROFILER_UNKNOWN_NAME "(unknown)"
+#endif /* PROFILER_UNKNOWN_NAME */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Utilities
+*/
+
+static bool profilerIsCode(int address) {
+	return address < 0x8000 /* ROM */ || address >= 0xff80 /* HRAM */;
+}
+
+static UInt16 profilerReadU16(Emulator* emulator, int address) {
+	return (UInt16)(
+		emulator_read_u8_raw(emulator, (Address)address) |
+		(emulator_read_u8_raw(emulator, (Address)(address + 1)) << 8)
+	);
+}
+
+static void profilerSort(Profiler::Hotspot::Array &hotspots) {
+	std::stable_sort(
+		hotspots.begin(), hotspots.end(),
+		[] (const Profiler::Hotspot &left, const Profiler::Hotspot &right) -> bool {
+			return left.samples > right.samples;
+		}
+	);
+}
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Profiler
+*/
+
+Profiler::Line::Line() {
+}
+
+Profiler::Line::Line(int p, int l, int b, int a, int s) : page(p), line(l), bank(b), address(a), size(s) {
+}
+
+Profiler::Hotspot::Hotspot() {
+}
+
+Profiler::Hotspot::Hotspot(const std::string &n, int s) : name(n), samples(s) {
+}
+
+Profiler::Symbol::Symbol() {
+}
+
+Profiler::Symbol::Symbol(int b, int a, const std::string &n) : bank(b), address(a), name(n) {
+}
+
+bool Profiler::Symbol::operator < (const Symbol &other) const {
+	if (bank != other.bank)
+		return bank < other.bank;
+
+	return address < other.address;
+}
+
+Profiler::Profiler() {
+}
+
+Profiler::~Profiler() {
+	close();
+}
+
+bool Profiler::opened(void) const {
+	return _interval > 0;
+}
+
+int Profiler::interval(void) const {
+	return _interval;
+}
+
+bool Profiler::open(int interval, const std::string &symbols, const Line::Array &lines) {
+	// Prepare.
+	close();
+
+	if (interval <= 0)
+		return false;
+
+	// Parse the symbols, in the form of "BB:AAAA NAME" per line.
+	std::string symbols_ = symbols;
+	symbols_ = Text::replace(symbols_, "\r\n", "\n");
+	symbols_ = Text::replace(symbols_, "\r", "\n");
+	const Text::Array lines_ = Text::split(symbols_, "\n");
+	for (std::string ln : lines_) {
+		const size_t idx = Text::indexOf(ln, ";");
+		if (idx != std::string::npos)
+			ln = ln.substr(0, idx);
+		ln = Text::trim(ln);
+		if (ln.empty())
+			continue;
+
+		const Text::Array parts = Text::split(ln, " ");
+		if (parts.size() != 2)
+			continue;
+		const Text::Array addressParts = Text::split(parts.front(), ":");
+		if (addressParts.size() != 2)
+			continue;
+
+		const std::string &name = parts.back();
+		const int bank = (int)std::strtol(addressParts.front().c_str(), nullptr, 16);
+		const int address = (int)std::strtol(addressParts.back().c_str(), nullptr, 16);
+		if (name == PROFILER_EXECUTING_CONTEXT_SYMBOL) {
+			_executingContext = address;
+
+			continue;
+		}
+		if (Text::startsWith(name, "l__", false) || Text::startsWith(name, "s__", false) || Text::startsWith(name, "___", false))
+			continue; // Ignore the area and bank markers of the linker.
+		if (!profilerIsCode(address))
+			continue; // Ignore the variables.
+
+		_symbols.push_back(Symbol(bank, address, Text::startsWith(name, "_", false) ? name.substr(1) : name));
+	}
+
+	// Order the symbols and lines by location, keep the first one of the
+	// symbols at the same location.
+	std::stable_sort(_symbols.begin(), _symbols.end());
+	_symbols.erase(
+		std::unique(
+			_symbols.begin(), _symbols.end(),
+			[] (const Symbol &left, const Symbol &right) -> bool {
+				return left.bank == right.bank && left.address == right.address;
+			}
+		),
+		_symbols.end()
+	);
+	_lines = lines;
+	std::stable_sort(
+		_lines.begin(), _lines.end(),
+		[] (const Line &left, const Line &right) -> bool {
+			if (left.bank != right.bank)
+				return left.bank < right.bank;
+
+			return left.address < right.address;
+		}
+	);
+
+	// Initialize the counters.
+	_interval = interval;
+	_symbolSamples.resize(_symbols.size(), 0);
+	_lineSamples.resize(_lines.size(), 0);
+
+	// Finish.
+	return true;
+}
+
+void Profiler::close(void) {
+	_interval = 0;
+	_symbols.clear();
+	_executingContext = -1;
+	_lines.clear();
+
+	_nextTicks = 0;
+	_samples = 0;
+	_scriptSamples = 0;
+	_symbolSamples.clear();
+	_lineSamples.clear();
+	_unknownSymbolSamples = 0;
+	_unknownLineSamples = 0;
+}
+
+UInt32 Profiler::run(Emulator* emulator, UInt64 untilTicks) {
+	if (!opened())
+		return emulator_run_until(emulator, untilTicks);
+
+	for (; ; ) {
+		// Restart sampling if the time has jumped, i.e. by loading a state.
+		const Ticks now = emulator_get_ticks(emulator);
+		if (_nextTicks <= now || _nextTicks > now + _interval)
+			_nextTicks = now + _interval;
+
+		// Run till the next sample point or the specific ticks.
+		const Ticks until = std::min((Ticks)untilTicks, (Ticks)_nextTicks);
+		EmulatorEvent event = emulator_run_until(emulator, until);
+
+		// Sample.
+		if (emulator_get_ticks(emulator) >= _nextTicks) {
+			sample(emulator);
+			_nextTicks += _interval;
+			if (until < untilTicks)
+				event &= ~EMULATOR_EVENT_UNTIL_TICKS; // Stopped for sampling only.
+		}
+
+		if (event)
+			return event;
+	}
+}
+
+void Profiler::report(Report &report) const {
+	report = Report();
+	report.interval = _interval;
+	report.samples = _samples;
+	report.scriptSamples = _scriptSamples;
+
+	for (int i = 0; i < (int)_symbols.size(); ++i) {
+		if (_symbolSamples[i] > 0)
+			report.flat.push_back(Hotspot(_symbols[i].name, _symbolSamples[i]));
+	}
+	if (_unknownSymbolSamples > 0)
+		report.flat.push_back(Hotspot(PROFILER_UNKNOWN_NAME, _unknownSymbolSamples));
+	profilerSort(report.flat);
+
+	for (int i = 0; i < (int)_lines.size(); ++i) {
+		if (_lineSamples[i] > 0)
+			report.lines.push_back(Hotspot("#" + Text::toString(_lines[i].page) + ":" + Text::toString(_lines[i].line), _lineSamples[i]));
+	}
+	if (_unknownLineSamples > 0)
+		report.lines.push_back(Hotspot(PROFILER_UNKNOWN_NAME, _unknownLineSamples));
+	profilerSort(report.lines);
+}
+
+bool Profiler::parseLines(const std::string &txt, Line::Array &lines) {
+	lines.clear();
+
+	std::string txt_ = txt;
+	txt_ = Text::replace(txt_, "\r\n", "\n");
+	txt_ = Text::replace(txt_, "\r", "\n");
+	const Text::Array lines_ = Text::split(txt_, "\n");
+	for (std::string ln : lines_) {
+		const size_t idx = Text::indexOf(ln, ";");
+		if (idx != std::string::npos)
+			ln = ln.substr(0, idx);
+		ln = Text::trim(ln);
+		if (ln.empty())
+			continue;
+
+		const Text::Array parts = Text::split(ln, " ");
+		if (parts.size() != 3)
+			return false;
+		const Text::Array addressParts = Text::split(parts[0], ":");
+		const Text::Array lineParts = Text::split(parts[2], ":");
+		if (addressParts.size() != 2 || lineParts.size() != 2)
+			return false;
+
+		Line line;
+		char* end = nullptr;
+		line.bank = (int)std::strtol(addressParts[0].c_str(), &end, 16);
+		if (*end)
+			return false;
+		line.address = (int)std::strtol(addressParts[1].c_str(), &end, 16);
+		if (*end)
+			return false;
+		if (!Text::fromString(parts[1], line.size))
+			return false;
+		if (!Text::fromString(lineParts[0], line.page) || !Text::fromString(lineParts[1], line.line))
+			return false;
+		lines.push_back(line);
+	}
+
+	return true;
+}
+
+Text::Array Profiler::format(const Report &report, int count) {
+	Text::Array result;
+
+	// The samples are evenly spread over time, so a hotspot's share of them
+	// times the frame length is its average cost per frame.
+	const double samples = report.samples > 0 ? (double)report.samples : 1.0;
+	auto table = [&] (const char* title, const Hotspot::Array &hotspots) -> void {
+		result.push_back(title);
+		for (int i = 0; i < (int)hotspots.size() && i < count; ++i) {
+			const Hotspot &hotspot = hotspots[i];
+			result.push_back(
+				Text::cformat(
+					"  %5.1f%% %7.0f ticks/frame  %s",
+					hotspot.samples / samples * 100,
+					hotspot.samples / samples * PROFILER_FRAME_TICKS,
+					hotspot.name.c_str()
+				)
+			);
+		}
+	};
+
+	result.push_back(
+		Text::cformat(
+			"profile: %d samples every %d ticks, %.1f%% in script",
+			report.samples, report.interval,
+			report.scriptSamples / samples * 100
+		)
+	);
+	table("flat:", report.flat);
+	table("lines:", report.lines);
+
+	return result;
+}
+
+void Profiler::sample(Emulator* emulator) {
+	++_samples;
+
+	// Resolve the CPU PC to the kernel symbol, PC in the switchable ROM area is
+	// with the mapped bank.
+	const Registers regs = emulator_get_registers(emulator);
+	const int pc = regs.PC;
+	const int bank = (pc >= 0x4000 && pc < 0x8000) ? emulator_get_rom_bank(emulator, (Address)pc) : 0;
+	Symbol::Array::const_iterator sit = std::upper_bound(_symbols.begin(), _symbols.end(), Symbol(bank, pc, ""));
+	if (profilerIsCode(pc) && sit != _symbols.begin() && (sit - 1)->bank == bank)
+		++_symbolSamples[(sit - 1) - _symbols.begin()];
+	else
+		++_unknownSymbolSamples;
+
+	// Resolve the program pointer of the executing VM context to the source
+	// line, it's attributed to the nearest line that starts before it.
+	if (_executingContext < 0)
+		return;
+	const UInt16 ctx = profilerReadU16(emulator, _executingContext);
+	if (!ctx)
+		return;
+	++_scriptSamples;
+	if (_lines.empty())
+		return;
+
+	const int ctxPc = profilerReadU16(emulator, ctx + PROFILER_CONTEXT_PC_OFFSET);
+	const int ctxBank = emulator_read_u8_raw(emulator, (Address)(ctx + PROFILER_CONTEXT_BANK_OFFSET));
+	Line::Array::const_iterator lit = std::upper_bound(
+		_lines.begin(), _lines.end(), Line(0, 0, ctxBank, ctxPc, 0),
+		[] (const Line &left, const Line &right) -> bool {
+			if (left.bank != right.bank)
+				return left.bank < right.bank;
+
+			return left.address < right.address;
+		}
+	);
+	if (lit != _lines.begin() && (lit - 1)->bank == ctxBank)
+		++_lineSamples[(lit - 1) - _lines.begin()];
+	else
+		++_unknownLineSamples;
+}
+
+/* ===========================================================================} */
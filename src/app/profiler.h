@@ -0,0 +1,154 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "../gbbasic.h"
+#include "../utils/text.h"
+#include <string>
+#include <vector>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef PROFILER_DEFAULT_INTERVAL
+#	define PROFILER_DEFAULT_INTERVAL 1009 // In CPU ticks, a prime so that the samples don't alias with the frame or timer periods.
+#endif /* PROFILER_DEFAULT_INTERVAL */
+
+#ifndef PROFILER_DEFAULT_TOP_COUNT
+#	define PROFILER_DEFAULT_TOP_COUNT 20
+#endif /* PROFILER_DEFAULT_TOP_COUNT */
+
+#ifndef PROFILER_EXECUTING_CONTEXT_SYMBOL
+#	define PROFILER_EXECUTING_CONTEXT_SYMBOL "_executing_ctx" // See "src/vm/vm.c".
+#endif /* PROFILER_EXECUTING_CONTEXT_SYMBOL */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Profiler
+*/
+
+struct Emulator;
+
+/**
+ * @brief Sampling profiler of the VM. It samples the CPU PC and the executing
+ *   VM context every few CPU ticks, resolves the former to the kernel symbols,
+ *   and the latter's program pointer to the BASIC source lines.
+ */
+class Profiler {
+public:
+	/**
+	 * @brief ROM location of the compiled code of a source line, the same as
+	 *   `GBBASIC::LineLocation`.
+	 */
+	struct Line {
+		typedef std::vector<Line> Array;
+
+		int page = 0;
+		int line = 0;
+		int bank = 0;
+		int address = 0;
+		int size = 0;
+
+		Line();
+		Line(int p, int l, int b, int a, int s);
+	};
+
+	struct Hotspot {
+		typedef std::vector<Hotspot> Array;
+
+		std::string name; // Kernel symbol, or "#PAGE:LINE".
+		int samples = 0;
+
+		Hotspot();
+		Hotspot(const std::string &n, int s);
+	};
+
+	struct Report {
+		int interval = 0; // In CPU ticks.
+		int samples = 0;
+		int scriptSamples = 0; // With a VM context executing.
+		Hotspot::Array flat; // By kernel symbol, in descending order.
+		Hotspot::Array lines; // By source line, in descending order.
+	};
+
+private:
+	struct Symbol {
+		typedef std::vector<Symbol> Array;
+
+		int bank = 0;
+		int address = 0;
+		std::string name;
+
+		Symbol();
+		Symbol(int b, int a, const std::string &n);
+
+		bool operator < (const Symbol &other) const;
+	};
+
+private:
+	int _interval = 0;
+	Symbol::Array _symbols; // Code symbols, ordered by bank and address.
+	int _executingContext = -1; // Address of the executing VM context pointer.
+	Line::Array _lines; // Ordered by bank and address.
+
+	UInt64 _nextTicks = 0;
+	int _samples = 0;
+	int _scriptSamples = 0;
+	std::vector<int> _symbolSamples; // Corresponds to `_symbols`.
+	std::vector<int> _lineSamples; // Corresponds to `_lines`.
+	int _unknownSymbolSamples = 0;
+	int _unknownLineSamples = 0;
+
+public:
+	Profiler();
+	~Profiler();
+
+	bool opened(void) const;
+	int interval(void) const;
+
+	/**
+	 * @param[in] interval Samples every such many CPU ticks.
+	 * @param[in] symbols Content of the kernel's ".sym" file.
+	 * @param[in] lines Line map of the program, the per-line table is left
+	 *   empty if it's empty.
+	 */
+	bool open(int interval, const std::string &symbols, const Line::Array &lines);
+	void close(void);
+
+	/**
+	 * @brief Same as `emulator_run_until(...)`, but stops every `interval()`
+	 *   CPU ticks to take a sample.
+	 */
+	UInt32 run(struct Emulator* emulator, UInt64 untilTicks);
+
+	void report(Report &report) const;
+
+	/**
+	 * @brief Parses a line map in the form of "BB:AAAA SIZE PAGE:LINE" per line,
+	 *   as written by the compiler; `;` starts a comment.
+	 */
+	static bool parseLines(const std::string &txt, Line::Array &lines);
+	/**
+	 * @brief Formats a report into human readable text lines, with up to
+	 *   `count` entries in each table.
+	 */
+	static Text::Array format(const Report &report, int count);
+
+private:
+	void sample(struct Emulator* emulator);
+};
+
+/* ===========================================================================} */
+
+#endif /* __PROFILER_H__ */
@@ -888,7 +888,7 @@ bool Project::addTilesPage(const std::string &val, bool isNew) {
 			entry->name = getUsableTilesName(index); // Unique name.
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		TilesAssets::Entry* entry = assets_.get(i);
+		TilesAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -901,7 +901,7 @@ bool Project::removeTilesPage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	TilesAssets::Entry* entry = assets_.get(index);
+	TilesAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		entry->editor->close(index);
 		EditorTiles::destroy((EditorTiles*)entry->editor);
@@ -986,7 +986,7 @@ bool Project::addMapPage(const std::string &val, bool isNew, const char* prefere
 		}
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		MapAssets::Entry* entry = assets_.get(i);
+		MapAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -999,7 +999,7 @@ bool Project::removeMapPage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	MapAssets::Entry* entry = assets_.get(index);
+	MapAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		entry->editor->close(index);
 		EditorMap::destroy((EditorMap*)entry->editor);
@@ -1066,7 +1066,7 @@ std::string Project::getUsableMapName(int index) const {
 
 Project::Indices Project::getMapsRefToTiles(int tilesIndex) const {
 	Indices result;
-	const MapAssets &assets_ = assets()->maps;
+	MapAssets &assets_ = assets()->maps; // Materializes on reading the ref.
 	for (int i = 0; i < assets_.count(); ++i) {
 		const MapAssets::Entry* entry = assets_.get(i);
 		if (entry->ref == tilesIndex)
@@ -1099,7 +1099,7 @@ bool Project::addMusicPage(const std::string &val, bool isNew) {
 		}
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		MusicAssets::Entry* entry = assets_.get(i);
+		MusicAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -1112,7 +1112,7 @@ bool Project::removeMusicPage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	MusicAssets::Entry* entry = assets_.get(index);
+	MusicAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		entry->editor->close(index);
 		EditorMusic::destroy((EditorMusic*)entry->editor);
@@ -1189,7 +1189,7 @@ bool Project::canRenameMusicInstrument(int index, int instIndex, const std::stri
 	if (another)
 		*another = -1;
 
-	const MusicAssets &assets_ = assets()->music;
+	MusicAssets &assets_ = assets()->music; // Materializes on reading the instruments.
 	if (index < 0 || index >= assets_.count())
 		return false;
 
@@ -1214,7 +1214,7 @@ bool Project::canRenameMusicInstrument(int index, int instIndex, const std::stri
 std::string Project::getUsableMusicInstrumentName(int index, int instIndex) const {
 	std::string prefix = "Instrument";
 	do {
-		const MusicAssets &assets_ = assets()->music;
+		MusicAssets &assets_ = assets()->music; // Materializes on reading the instruments.
 		if (index < 0 || index >= assets_.count())
 			break;
 
@@ -1284,7 +1284,7 @@ bool Project::addSfxPage(const std::string &val, bool isNew, bool insertBefore,
 		result = assets_.add(SfxAssets::Entry(val));
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		SfxAssets::Entry* entry = assets_.get(i);
+		SfxAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -1297,7 +1297,7 @@ bool Project::removeSfxPage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	SfxAssets::Entry* entry = assets_.get(index);
+	SfxAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		sharedSfxEditor()->removed(entry, index); // Before removing.
 
@@ -1401,7 +1401,7 @@ bool Project::addActorPage(const std::string &val, bool isNew) {
 			entry->name = getUsableActorName(index); // Unique name.
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		ActorAssets::Entry* entry = assets_.get(i);
+		ActorAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -1414,7 +1414,7 @@ bool Project::removeActorPage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	ActorAssets::Entry* entry = assets_.get(index);
+	ActorAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		entry->editor->close(index);
 		EditorActor::destroy((EditorActor*)entry->editor);
@@ -1499,7 +1499,7 @@ bool Project::addScenePage(const std::string &val, bool isNew, const char* prefe
 		}
 	}
 	for (int i = 0; i < assets_.count(); ++i) {
-		SceneAssets::Entry* entry = assets_.get(i);
+		SceneAssets::Entry* entry = assets_.peek(i);
 		if (entry->editor)
 			entry->editor->statusInvalidated();
 	}
@@ -1512,7 +1512,7 @@ bool Project::removeScenePage(int index) {
 	if (index < 0 || index >= assets_.count())
 		return false;
 
-	SceneAssets::Entry* entry = assets_.get(index);
+	SceneAssets::Entry* entry = assets_.peek(index);
 	if (entry->editor) {
 		entry->editor->close(index);
 		EditorScene::destroy((EditorScene*)entry->editor);
@@ -1762,11 +1762,11 @@ bool Project::open(const char* path_) {
 		return false;
 
 	// Determine the source type.
-	std::string content;
+	const GBBASIC::Sections content(source); // Indexed in a single pass, no need to trim.
 	const std::string sectionBegin = COMPILER_PROGRAM_BEGIN;
 	const std::string sectionEnd = COMPILER_PROGRAM_END;
-	const size_t beginIndex = Text::indexOf(source, sectionBegin);
-	const size_t endIndex = Text::indexOf(source, sectionEnd, beginIndex + sectionBegin.length());
+	const size_t beginIndex = content.indexOf(sectionBegin);
+	const size_t endIndex = content.indexOf(sectionEnd, beginIndex + sectionBegin.length());
 	if (beginIndex == std::string::npos && endIndex == std::string::npos) { // Is a plain source code file.
 		// Fill the information.
 		std::string title_;
@@ -1811,7 +1811,6 @@ bool Project::open(const char* path_) {
 		// Finish.
 		return true;
 	} else { // Is a rich project file.
-		content = Text::trim(source);
 		isPlain(false);
 		preferPlain(false);
 	}
@@ -1906,6 +1905,13 @@ bool Project::close(bool deep) {
 		_iconTexture2BppDirty = true;
 	}
 
+	// Report how many deferred assets have been used.
+	if (assets()) {
+		const BaseAssets::Lazy::Statistics stat = BaseAssets::Lazy::statistics();
+		if (stat.deferred > 0)
+			fprintf(stdout, "Assets: %d deferred, %d materialized.\n", stat.deferred, stat.materialized);
+	}
+
 	// Destroy the assets.
 	assets(nullptr);
 
@@ -1968,11 +1974,11 @@ bool Project::load(const char* fontConfigPath, WarningOrErrorHandler onWarningOr
 	}
 
 	// Determine the source type.
-	std::string content;
+	const GBBASIC::Sections content(source); // Indexed in a single pass, no need to trim.
 	const std::string sectionBegin = COMPILER_PROGRAM_BEGIN;
 	const std::string sectionEnd = COMPILER_PROGRAM_END;
-	const size_t beginIndex = Text::indexOf(source, sectionBegin);
-	const size_t endIndex = Text::indexOf(source, sectionEnd, beginIndex + sectionBegin.length());
+	const size_t beginIndex = content.indexOf(sectionBegin);
+	const size_t endIndex = content.indexOf(sectionEnd, beginIndex + sectionBegin.length());
 	if (beginIndex == std::string::npos && endIndex == std::string::npos) { // Is a plain source code file.
 		// Fill the information.
 		std::string title_;
@@ -2059,7 +2065,6 @@ bool Project::load(const char* fontConfigPath, WarningOrErrorHandler onWarningOr
 		// Finish.
 		return true;
 	} else { // Is a rich project file.
-		content = Text::trim(source);
 		isPlain(false);
 		preferPlain(false);
 	}
@@ -2262,37 +2267,37 @@ void Project::foreach(AssetHandler handle) {
 
 	TilesAssets &tiles = assets()->tiles;
 	for (int i = 0; i < tiles.count(); ++i) {
-		TilesAssets::Entry* entry = tiles.get(i);
+		TilesAssets::Entry* entry = tiles.peek(i);
 		handle(AssetsBundle::Categories::TILES, i, entry, entry->editor);
 	}
 
 	MapAssets &maps = assets()->maps;
 	for (int i = 0; i < maps.count(); ++i) {
-		MapAssets::Entry* entry = maps.get(i);
+		MapAssets::Entry* entry = maps.peek(i);
 		handle(AssetsBundle::Categories::MAP, i, entry, entry->editor);
 	}
 
 	MusicAssets &music = assets()->music;
 	for (int i = 0; i < music.count(); ++i) {
-		MusicAssets::Entry* entry = music.get(i);
+		MusicAssets::Entry* entry = music.peek(i);
 		handle(AssetsBundle::Categories::MUSIC, i, entry, entry->editor);
 	}
 
 	SfxAssets &sfx = assets()->sfx;
 	for (int i = 0; i < sfx.count(); ++i) {
-		SfxAssets::Entry* entry = sfx.get(i);
+		SfxAssets::Entry* entry = sfx.peek(i);
 		handle(AssetsBundle::Categories::SFX, i, entry, entry->editor);
 	}
 
 	ActorAssets &actors = assets()->actors;
 	for (int i = 0; i < actors.count(); ++i) {
-		ActorAssets::Entry* entry = actors.get(i);
+		ActorAssets::Entry* entry = actors.peek(i);
 		handle(AssetsBundle::Categories::ACTOR, i, entry, entry->editor);
 	}
 
 	SceneAssets &scenes = assets()->scenes;
 	for (int i = 0; i < scenes.count(); ++i) {
-		SceneAssets::Entry* entry = scenes.get(i);
+		SceneAssets::Entry* entry = scenes.peek(i);
 		handle(AssetsBundle::Categories::SCENE, i, entry, entry->editor);
 	}
 }
@@ -2326,7 +2331,7 @@ void Project::transfer(void) {
 	}
 }
 
-bool Project::loadInformation(const std::string &content, WarningOrErrorHandler onWarningOrError) {
+bool Project::loadInformation(const GBBASIC::Sections &content, WarningOrErrorHandler onWarningOrError) {
 	auto report = [onWarningOrError] (const char* msg, bool isWarning) -> void {
 		if (onWarningOrError)
 			onWarningOrError(msg, isWarning);
@@ -2757,10 +2762,12 @@ bool Project::saveInformation(std::string &content) {
 	return true;
 }
 
-bool Project::loadAssets(const char* fontConfigPath, const std::string &content, WarningOrErrorHandler onWarningOrError) {
+bool Project::loadAssets(const char* fontConfigPath, const GBBASIC::Sections &content, WarningOrErrorHandler onWarningOrError) {
 	// Prepare.
 	assets(AssetsBundle::Ptr(new AssetsBundle()));
 
+	BaseAssets::Lazy::resetStatistics();
+
 	// Load palette.
 	do {
 		std::string section;
@@ -2848,7 +2855,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addTilesPage(section, false);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->tiles.add(TilesAssets::Entry(renderer(), pending, paletteGetter())); // Deserialized on first use.
 	}
 
 	if (tilesPageCount() > 0)
@@ -2868,7 +2876,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addMapPage(section, false, nullptr);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->maps.add(MapAssets::Entry(pending, tilesGetter(), attributesTexture()));
 	}
 
 	if (mapPageCount() > 0)
@@ -2888,7 +2897,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addMusicPage(section, false);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->music.add(MusicAssets::Entry(pending));
 	}
 
 	if (musicPageCount() > 0)
@@ -2908,7 +2918,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addSfxPage(section, false, false, false);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->sfx.add(SfxAssets::Entry(pending));
 	}
 
 	if (sfxPageCount() > 0)
@@ -2928,7 +2939,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addActorPage(section, false);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->actors.add(ActorAssets::Entry(renderer(), pending, paletteGetter(), behaviourSerializer(), behaviourParser()));
 	}
 
 	if (actorPageCount() > 0)
@@ -2948,7 +2960,8 @@ bool Project::loadAssets(const char* fontConfigPath, const std::string &content,
 		}
 		section = Text::trim(section);
 
-		addScenePage(section, false, nullptr);
+		const BaseAssets::Lazy::Pending pending = std::make_shared<const std::string>(std::move(section));
+		assets()->scenes.add(SceneAssets::Entry(pending, mapGetter(), actorGetter(), propertiesTexture(), actorsTexture()));
 	}
 
 	if (scenePageCount() > 0)
@@ -3020,7 +3033,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save tiles.
 	for (int i = 0; i < assets()->tiles.count(); ++i) {
-		TilesAssets::Entry* entry = assets()->tiles.get(i);
+		TilesAssets::Entry* entry = assets()->tiles.peek(i); // Pending entries are written verbatim.
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3034,7 +3047,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save maps.
 	for (int i = 0; i < assets()->maps.count(); ++i) {
-		MapAssets::Entry* entry = assets()->maps.get(i);
+		MapAssets::Entry* entry = assets()->maps.peek(i);
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3048,7 +3061,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save music.
 	for (int i = 0; i < assets()->music.count(); ++i) {
-		MusicAssets::Entry* entry = assets()->music.get(i);
+		MusicAssets::Entry* entry = assets()->music.peek(i);
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3062,7 +3075,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save SFX.
 	for (int i = 0; i < assets()->sfx.count(); ++i) {
-		SfxAssets::Entry* entry = assets()->sfx.get(i);
+		SfxAssets::Entry* entry = assets()->sfx.peek(i);
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3077,7 +3090,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save actors.
 	for (int i = 0; i < assets()->actors.count(); ++i) {
-		ActorAssets::Entry* entry = assets()->actors.get(i);
+		ActorAssets::Entry* entry = assets()->actors.peek(i);
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3091,7 +3104,7 @@ bool Project::saveAssets(std::string &content, WarningOrErrorHandler onWarningOr
 
 	// Save scenes.
 	for (int i = 0; i < assets()->scenes.count(); ++i) {
-		SceneAssets::Entry* entry = assets()->scenes.get(i);
+		SceneAssets::Entry* entry = assets()->scenes.peek(i);
 		if (entry->editor && entry->editor->hasUnsavedChanges()) {
 			entry->editor->flush();
 			entry->editor->markChangesSaved();
@@ -3192,17 +3205,8 @@ bool Project::write(const char* path, FileWritingHandler write_) {
 #endif /* Platform macro. */
 }
 
-bool Project::retrieve(const std::string &content, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) {
-	const size_t beginIndex = Text::indexOf(content, sectionBegin);
-	if (beginIndex == std::string::npos)
-		return false;
-	const size_t endIndex = Text::indexOf(content, sectionEnd, beginIndex + sectionBegin.length());
-	if (endIndex == std::string::npos)
-		return false;
-
-	section = content.substr(beginIndex + sectionBegin.length(), endIndex - (beginIndex + sectionBegin.length()));
-
-	return true;
+bool Project::retrieve(const GBBASIC::Sections &content, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) {
+	return content.retrieve(sectionBegin, sectionEnd, section);
 }
 
 bool Project::put(std::string &content, const std::string &sectionBegin, const std::string &sectionEnd, const std::string &section) {
@@ -10,6 +10,7 @@
 #define __PROJECT_H__
 
 #include "../gbbasic.h"
+#include "../compiler/compiler.h"
 #include "../utils/assets.h"
 #include "../utils/file_sandbox.h"
 
@@ -293,16 +294,16 @@ public:
 private:
 	void transfer(void);
 
-	bool loadInformation(const std::string &content, WarningOrErrorHandler onWarningOrError);
+	bool loadInformation(const GBBASIC::Sections &content, WarningOrErrorHandler onWarningOrError);
 	bool saveInformation(std::string &content);
 
-	bool loadAssets(const char* fontConfigPath, const std::string &content, WarningOrErrorHandler onWarningOrError);
+	bool loadAssets(const char* fontConfigPath, const GBBASIC::Sections &content, WarningOrErrorHandler onWarningOrError);
 	bool saveAssets(std::string &content, WarningOrErrorHandler onWarningOrError);
 
 	static bool read(const char* path, FileReadingHandler read_);
 	static bool write(const char* path, FileWritingHandler write_);
 
-	static bool retrieve(const std::string &content, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section);
+	static bool retrieve(const GBBASIC::Sections &content, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section);
 	static bool put(std::string &content, const std::string &sectionBegin, const std::string &sectionEnd, const std::string &section);
 };
 
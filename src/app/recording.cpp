@@ -0,0 +1,282 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#include "recording.h"
+#include "../utils/text.h"
+#include "../../lib/binjgb/src/emulator-debug.h"
+#include "../../lib/binjgb/src/joypad.h"
+#include <algorithm>
+#include <inttypes.h>
+#include <sstream>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef RECORDING_HASH_OFFSET_BASIS
+#	define RECORDING_HASH_OFFSET_BASIS 0xcbf29ce484222325ull // FNV-1a.
+#endif /* RECORDING_HASH_OFFSET_BASIS */
+#ifndef RECORDING_HASH_PRIME
+#	define RECORDING_HASH_PRIME 0x00000100000001b3ull // FNV-1a.
+#endif /* RECORDING_HASH_PRIME */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Utilities
+*/
+
+static void recordingHash(UInt64 &hash, const UInt8* bytes, size_t len) {
+	for (size_t i = 0; i < len; ++i) {
+		hash ^= bytes[i];
+		hash *= RECORDING_HASH_PRIME;
+	}
+}
+
+static void recordingHash(UInt64 &hash, Emulator* emulator, int begin, int end) {
+	for (int i = begin; i < end; ++i) {
+		hash ^= emulator_read_u8_raw(emulator, (Address)i);
+		hash *= RECORDING_HASH_PRIME;
+	}
+}
+
+static bool recordingParseButtons(const std::string &btns, UInt8 &packed) {
+	JoypadButtons joyp;
+	memset(&joyp, 0, sizeof(JoypadButtons));
+	if (btns != "-") {
+		const Text::Array parts = Text::split(btns, "+");
+		for (std::string btn : parts) {
+			Text::toLowerCase(btn);
+			if (btn == "up")          joyp.up = TRUE;
+			else if (btn == "down")   joyp.down = TRUE;
+			else if (btn == "left")   joyp.left = TRUE;
+			else if (btn == "right")  joyp.right = TRUE;
+			else if (btn == "a")      joyp.A = TRUE;
+			else if (btn == "b")      joyp.B = TRUE;
+			else if (btn == "select") joyp.select = TRUE;
+			else if (btn == "start")  joyp.start = TRUE;
+			else                      return false;
+		}
+	}
+	packed = joypad_pack_buttons(&joyp);
+
+	return true;
+}
+
+static std::string recordingFormatButtons(UInt8 packed) {
+	const JoypadButtons joyp = joypad_unpack_buttons(packed);
+	Text::Array parts;
+	if (joyp.up)     parts.push_back("up");
+	if (joyp.down)   parts.push_back("down");
+	if (joyp.left)   parts.push_back("left");
+	if (joyp.right)  parts.push_back("right");
+	if (joyp.A)      parts.push_back("a");
+	if (joyp.B)      parts.push_back("b");
+	if (joyp.select) parts.push_back("select");
+	if (joyp.start)  parts.push_back("start");
+	if (parts.empty())
+		return "-";
+
+	std::string result;
+	for (const std::string &part : parts) {
+		if (!result.empty())
+			result += "+";
+		result += part;
+	}
+
+	return result;
+}
+
+static bool recordingParseRtc(const std::string &txt, int &rtc) {
+	const Text::Array parts = Text::split(txt, ":");
+	if (parts.size() != 4)
+		return false;
+
+	int day = 0, hr = 0, mi = 0, sec = 0;
+	if (!Text::fromString(parts[0], day) || day < 0 || day > 511)
+		return false;
+	if (!Text::fromString(parts[1], hr) || hr < 0 || hr > 23)
+		return false;
+	if (!Text::fromString(parts[2], mi) || mi < 0 || mi > 59)
+		return false;
+	if (!Text::fromString(parts[3], sec) || sec < 0 || sec > 59)
+		return false;
+	rtc = ((day * 24 + hr) * 60 + mi) * 60 + sec;
+
+	return true;
+}
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Recording
+*/
+
+Recording::Keys::Keys() {
+}
+
+Recording::Keys::Keys(int frame_, UInt8 buttons_) : frame(frame_), buttons(buttons_) {
+}
+
+Recording::Recording() {
+}
+
+void Recording::clear(void) {
+	device.clear();
+	rtc = -1;
+	platform = -1;
+	localization = -1;
+	keys.clear();
+	frameCount = 0;
+	hash = 0;
+}
+
+void Recording::record(int frame, UInt8 buttons_) {
+	while (!keys.empty() && keys.back().frame >= frame)
+		keys.pop_back();
+	if (buttons(frame) != buttons_ || (keys.empty() && frame == 0))
+		keys.push_back(Keys(frame, buttons_));
+}
+
+UInt8 Recording::buttons(int frame) const {
+	Keys::Array::const_iterator it = std::upper_bound(
+		keys.begin(), keys.end(), frame,
+		[] (int frame, const Keys &keys) -> bool {
+			return frame < keys.frame;
+		}
+	);
+	if (it == keys.begin())
+		return 0;
+
+	return (it - 1)->buttons;
+}
+
+bool Recording::parse(const std::string &txt, int* errorLine) {
+	// Prepare.
+	clear();
+	if (errorLine)
+		*errorLine = 0;
+
+	// Parse line by line.
+	std::istringstream ss(txt);
+	std::string line;
+	int ln = 0;
+	while (std::getline(ss, line)) {
+		++ln;
+
+		const size_t cmt = line.find('#');
+		if (cmt != std::string::npos)
+			line = line.substr(0, cmt);
+
+		std::istringstream ls(line);
+		std::string first, second, third, extra;
+		if (!(ls >> first))
+			continue;
+
+		bool ok = !!(ls >> second);
+		const bool hasThird = !!(ls >> third);
+		ok = ok && !(ls >> extra);
+		if (ok && first == "device") {
+			ok = !hasThird && (second == "classic" || second == "colored" || second == "classic_ext" || second == "colored_ext");
+			if (ok)
+				device = second;
+		} else if (ok && first == "rtc") {
+			ok = !hasThird && recordingParseRtc(second, rtc);
+		} else if (ok && first == "platform") {
+			char* end = nullptr;
+			const unsigned long val = strtoul(second.c_str(), &end, 16);
+			ok = !hasThird && !*end && val <= 0xff;
+			if (ok)
+				platform = (int)val;
+		} else if (ok && first == "localization") {
+			ok = !hasThird && Text::fromString(second, localization) && localization >= 0 && localization <= 0xff;
+		} else if (ok && first == "end") {
+			UInt64 val = 0;
+			char* end = nullptr;
+			if (hasThird)
+				val = (UInt64)strtoull(third.c_str(), &end, 16);
+			ok = hasThird && !*end && Text::fromString(second, frameCount) && frameCount > 0;
+			if (ok)
+				hash = val;
+		} else if (ok) {
+			int frame = 0;
+			UInt8 packed = 0;
+			ok = !hasThird;
+			ok = ok && Text::fromString(first, frame) && frame >= 0;
+			ok = ok && (keys.empty() || frame >= keys.back().frame);
+			ok = ok && recordingParseButtons(second, packed);
+			if (ok)
+				keys.push_back(Keys(frame, packed));
+		}
+		if (!ok) {
+			clear();
+			if (errorLine)
+				*errorLine = ln;
+
+			return false;
+		}
+	}
+
+	// Finish.
+	return true;
+}
+
+std::string Recording::toString(void) const {
+	std::string result;
+
+	result += "# GB BASIC input recording.\n";
+	if (!device.empty())
+		result += "device " + device + "\n";
+	if (rtc >= 0) {
+		result += Text::cformat(
+			"rtc %d:%02d:%02d:%02d\n",
+			rtc / (24 * 60 * 60), rtc / (60 * 60) % 24, rtc / 60 % 60, rtc % 60
+		);
+	}
+	if (platform >= 0)
+		result += Text::cformat("platform %02x\n", platform);
+	if (localization >= 0)
+		result += Text::cformat("localization %d\n", localization);
+	if (frameCount > 0)
+		result += Text::cformat("end %d %016" PRIx64 "\n", frameCount, (uint64_t)hash);
+	for (const Keys &k : keys) {
+		if (frameCount > 0 && k.frame >= frameCount)
+			break;
+
+		result += Text::toString(k.frame) + " " + recordingFormatButtons(k.buttons) + "\n";
+	}
+
+	return result;
+}
+
+UInt64 Recording::stateHash(Emulator* emulator) {
+	UInt64 result = RECORDING_HASH_OFFSET_BASIS;
+
+	const FrameBuffer* frame = emulator_get_frame_buffer(emulator);
+	recordingHash(result, (const UInt8*)frame, sizeof(FrameBuffer));
+
+	const Registers regs = emulator_get_registers(emulator);
+	const UInt8 regBytes[] = {
+		regs.A, (UInt8)regs.F.Z, (UInt8)regs.F.N, (UInt8)regs.F.H, (UInt8)regs.F.C,
+		(UInt8)regs.BC, (UInt8)(regs.BC >> 8), (UInt8)regs.DE, (UInt8)(regs.DE >> 8),
+		(UInt8)regs.HL, (UInt8)(regs.HL >> 8), (UInt8)regs.SP, (UInt8)(regs.SP >> 8),
+		(UInt8)regs.PC, (UInt8)(regs.PC >> 8)
+	};
+	recordingHash(result, regBytes, sizeof(regBytes));
+
+	recordingHash(result, emulator, 0x8000, 0xe000); // VRAM, SRAM and WRAM of the mapped banks.
+	recordingHash(result, emulator, 0xfe00, 0xfea0); // OAM.
+	recordingHash(result, emulator, 0xff80, 0xffff); // HRAM.
+
+	return result;
+}
+
+/* ===========================================================================} */
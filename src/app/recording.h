@@ -0,0 +1,105 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#ifndef __RECORDING_H__
+#define __RECORDING_H__
+
+#include "../gbbasic.h"
+#include "../utils/mathematics.h"
+#include <string>
+#include <vector>
+
+/*
+** {===========================================================================
+** Recording
+*/
+
+struct Emulator;
+
+/**
+ * @brief Joypad input recording, it's the joypad states per emulated frame,
+ *   run-length encoded, with everything else from the host that a run from
+ *   power on depends on. A frame is `PPU_FRAME_TICKS` CPU ticks counted from
+ *   power on, and the input is latched at the beginning of each frame, so the
+ *   same recording replays bit-exactly in both the device and the runner.
+ */
+class Recording {
+public:
+	/**
+	 * @brief Joypad state since a specific frame, with buttons packed the same
+	 *   as `joypad_pack_buttons(...)`.
+	 */
+	struct Keys {
+		typedef std::vector<Keys> Array;
+
+		int frame = 0;
+		UInt8 buttons = 0;
+
+		Keys();
+		Keys(int frame, UInt8 buttons);
+	};
+
+	/**
+	 * @brief Statistics of a recorded or replayed run.
+	 */
+	struct Report {
+		int frameCount = 0;
+		int lagFrames = 0; // Frames in which the VM missed the vertical sync.
+		double seconds = 0; // Host time spent on emulating.
+		UInt64 hash = 0; // State hash at the end of the last frame, 0 if it didn't reach there.
+		bool diverged = false; // Replayed to a different state from the recorded one.
+	};
+
+public:
+	std::string device; // Device type, the same as the runner's "-d" argument; empty for unspecified.
+	int rtc = -1; // Initial RTC value in seconds, -1 if the cartridge has no RTC.
+	int platform = -1; // Value of the platform flags register, -1 for unspecified.
+	int localization = -1; // Value of the localization flags register, -1 for unspecified.
+	Keys::Array keys; // Ordered by frame.
+	int frameCount = 0; // Frames recorded, 0 if it's open ended.
+	UInt64 hash = 0; // State hash at the end of the last frame.
+
+public:
+	Recording();
+
+	void clear(void);
+
+	/**
+	 * @brief Records the joypad state of a specific frame, the keys after it
+	 *   are dropped if it's going back in time, i.e. by rewinding.
+	 */
+	void record(int frame, UInt8 buttons);
+	/**
+	 * @brief Gets the joypad state of a specific frame.
+	 */
+	UInt8 buttons(int frame) const;
+
+	/**
+	 * @brief Parses a recording. Each line is a frame index followed by the held
+	 *   buttons joined with `+`, or `-` for none, the state persists till the
+	 *   next line. Besides, there are the following directives:
+	 *   "device classic|colored|classic_ext|colored_ext", "rtc DAY:HH:MM:SS",
+	 *   "platform FLAGS" in hexadecimal, "localization FLAGS", and
+	 *   "end FRAMES HASH" for the state hash after the specific frames.
+	 *   `#` starts a comment.
+	 *
+	 * @param[out] errorLine The 1-based line number on failure.
+	 */
+	bool parse(const std::string &txt, int* errorLine);
+	std::string toString(void) const;
+
+	/**
+	 * @brief Hashes the state that a program can observe: the frame buffer, the
+	 *   CPU registers and the memory except the I/O and extension registers.
+	 */
+	static UInt64 stateHash(struct Emulator* emulator);
+};
+
+/* ===========================================================================} */
+
+#endif /* __RECORDING_H__ */
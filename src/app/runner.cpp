@@ -0,0 +1,382 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#include "runner.h"
+#include "device_registers.h"
+#include "../../lib/binjgb/src/emulator-debug.h"
+#include "../../lib/binjgb/src/joypad.h"
+#include "../../lib/binjgb/src/rewind.h"
+#include <chrono>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef RUNNER_AUDIO_FREQUENCE
+#	define RUNNER_AUDIO_FREQUENCE 48000
+#endif /* RUNNER_AUDIO_FREQUENCE */
+#ifndef RUNNER_AUDIO_FRAMES
+#	define RUNNER_AUDIO_FRAMES 2048
+#endif /* RUNNER_AUDIO_FRAMES */
+
+#ifndef RUNNER_HASH_OFFSET_BASIS
+#	define RUNNER_HASH_OFFSET_BASIS 0xcbf29ce484222325ull // FNV-1a.
+#endif /* RUNNER_HASH_OFFSET_BASIS */
+#ifndef RUNNER_HASH_PRIME
+#	define RUNNER_HASH_PRIME 0x00000100000001b3ull // FNV-1a.
+#endif /* RUNNER_HASH_PRIME */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Runner
+*/
+
+class RunnerImpl : public Runner {
+private:
+	Emulator* _emulator = nullptr;
+	RewindBuffer* _rewindBuffer = nullptr;
+	Profiler _profiler;
+	const Recording* _input = nullptr; // Foreign.
+	Recording _recording; // Host states as applied, without the keys.
+	int _frame = 0;
+	UInt32 _haltCount = 0; // At the last vertical sync.
+	JoypadButtons _buttons;
+	bool _extended = false;
+	std::vector<UInt8> _streaming;
+
+public:
+	RunnerImpl() {
+		memset(&_buttons, 0, sizeof(JoypadButtons));
+	}
+	virtual ~RunnerImpl() override {
+		close();
+	}
+
+	virtual bool run(const UInt8* rom, size_t size, const Options &options, Result &result) override {
+		// Prepare.
+		result = Result();
+
+		if (!open(rom, size, options))
+			return false;
+
+		// Run the frames.
+		typedef std::chrono::steady_clock Clock;
+
+		const Clock::time_point begin = Clock::now();
+		const Ticks beginTicks = emulator_get_ticks(_emulator);
+		Clock::duration rewindDuration = Clock::duration::zero();
+		bool ok = true;
+		for (_frame = 0; _frame < options.frameCount && ok; ++_frame) {
+			updateKeys();
+
+			const Ticks untilTicks = beginTicks + (Ticks)(_frame + 1) * PPU_FRAME_TICKS;
+			EmulatorEvent event = 0;
+			do {
+				event = _profiler.run(_emulator, untilTicks);
+				if (event & EMULATOR_EVENT_INVALID_OPCODE) {
+					result.invalidOpcode = true;
+					ok = false;
+
+					break;
+				}
+				if (event & EMULATOR_EVENT_NEW_FRAME) {
+					const UInt32 haltCount = emulator_get_halt_count(_emulator);
+					if (haltCount == _haltCount)
+						++result.lagFrames; // Never halted to wait for the vertical sync since the last one.
+					_haltCount = haltCount;
+				}
+			} while (!(event & EMULATOR_EVENT_UNTIL_TICKS));
+
+			pollStreaming(result);
+
+			if (_rewindBuffer && ok) {
+				const Clock::time_point start = Clock::now();
+				rewind_append(_rewindBuffer, _emulator);
+				rewindDuration += Clock::now() - start;
+				++result.rewindFrames;
+			}
+
+			const bool last = !ok || _frame == options.frameCount - 1;
+			if (last || (options.hashInterval > 0 && (_frame + 1) % options.hashInterval == 0))
+				result.frameHashes.push_back(std::make_pair(_frame, hash((const UInt8*)emulator_get_frame_buffer(_emulator), sizeof(FrameBuffer))));
+		}
+		const Clock::time_point end = Clock::now();
+
+		// Fill in the result.
+		result.frameCount = _frame;
+		result.stateHash = Recording::stateHash(_emulator);
+		result.recording = _recording;
+		for (int i = 0; i < (int)options.input.keys.size() && options.input.keys[i].frame < _frame; ++i)
+			result.recording.keys.push_back(options.input.keys[i]);
+		result.recording.frameCount = _frame;
+		result.recording.hash = result.stateHash;
+		result.ticks = (UInt64)(emulator_get_ticks(_emulator) - beginTicks);
+		result.busyTicks = (UInt64)emulator_get_duty_ticks(_emulator);
+		result.seconds = std::chrono::duration<double>(end - begin - rewindDuration).count();
+		if (_rewindBuffer) {
+			const RewindStats stats = rewind_get_stats(_rewindBuffer);
+			result.rewindBytes = (UInt64)(stats.base_bytes + stats.diff_bytes);
+			result.rewindUncompressedBytes = (UInt64)stats.uncompressed_bytes;
+			result.rewindSeconds = std::chrono::duration<double>(rewindDuration).count();
+		}
+		if (_profiler.opened())
+			_profiler.report(result.profile);
+		for (const Region &region : options.regions) {
+			std::vector<UInt8> data(region.size);
+			for (int i = 0; i < (int)region.size; ++i)
+				data[i] = emulator_read_u8_raw(_emulator, (Address)(region.address + i));
+			result.regions.push_back(data);
+		}
+
+		// Finish.
+		close();
+
+		return ok;
+	}
+
+private:
+	bool open(const UInt8* rom, size_t size, const Options &options) {
+		// Prepare.
+		if (!rom || size <= DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS)
+			return false;
+
+		// Determine the device type, the extension is only turned on if the
+		// cartridge prefers it.
+		Device::DeviceTypes deviceType = options.deviceType;
+		if (!(rom[DEVICE_BINJGB_CARTRIDGE_TYPE_ADDRESS] & DEVICE_BINJGB_CARTRIDGE_EXTENSION_TYPE)) {
+			if (deviceType == Device::DeviceTypes::CLASSIC_EXTENDED)
+				deviceType = Device::DeviceTypes::CLASSIC;
+			else if (deviceType == Device::DeviceTypes::COLORED_EXTENDED)
+				deviceType = Device::DeviceTypes::COLORED;
+		}
+		_extended = deviceType == Device::DeviceTypes::CLASSIC_EXTENDED || deviceType == Device::DeviceTypes::COLORED_EXTENDED;
+
+		// Initialize the emulator, with the same settings as the device.
+		EmulatorInit init;
+		memset(&init, 0, sizeof(EmulatorInit));
+		u8* data = (u8*)xmalloc(size);
+		memcpy(data, rom, size);
+		init.rom             = { data, size };
+		init.audio_frequency = RUNNER_AUDIO_FREQUENCE;
+		init.audio_frames    = RUNNER_AUDIO_FRAMES;
+		init.random_seed     = DEVICE_BINJGB_RANDOM_SEED;
+		init.builtin_palette = 0;
+		init.force_dmg       = (deviceType == Device::DeviceTypes::CLASSIC || deviceType == Device::DeviceTypes::CLASSIC_EXTENDED) ? TRUE : FALSE;
+		init.cgb_color_curve = CGB_COLOR_CURVE_GAMBATTE;
+		_emulator = emulator_new(&init);
+		if (!_emulator) {
+			xfree(data);
+
+			return false;
+		}
+
+		PaletteRGBA palette = { { DEVICE_CLASSIC_PALETTE_0, DEVICE_CLASSIC_PALETTE_1, DEVICE_CLASSIC_PALETTE_2, DEVICE_CLASSIC_PALETTE_3 } };
+		emulator_set_all_bw_palettes(_emulator, &palette);
+
+		if (_extended) { // GBB EXTENSION.
+			// Turn on the extension features.
+			if (deviceType == Device::DeviceTypes::CLASSIC_EXTENDED)
+				emulator_write_u8_raw(_emulator, DEVICE_BINJGB_EXTENSION_STATUS_REG, DEVICE_BINJGB_CPU_GB1_TYPE);
+			else
+				emulator_write_u8_raw(_emulator, DEVICE_BINJGB_EXTENSION_STATUS_REG, DEVICE_BINJGB_CPU_GB2_TYPE);
+			for (int i = 1; i < DEVICE_BINJGB_EXTENSION_AREA_SIZE; ++i)
+				emulator_write_u8_raw(_emulator, (Address)(DEVICE_BINJGB_EXTENSION_START_ADDRESS + i), 0);
+
+			// Set the platform flags, the localization flags are left as default
+			// to keep the runs reproducible across hosts; unless they're
+			// specified by a recording.
+			u8 flags = 0;
+#if defined GBBASIC_OS_WIN
+			flags |= DEVICE_BINJGB_PLATFORM_WINDOWS_FLAG;
+#elif defined GBBASIC_OS_MAC
+			flags |= DEVICE_BINJGB_PLATFORM_MACOS_FLAG;
+#elif defined GBBASIC_OS_LINUX
+			flags |= DEVICE_BINJGB_PLATFORM_LINUX_FLAG;
+#elif defined GBBASIC_OS_HTML
+			flags |= DEVICE_BINJGB_PLATFORM_HTML_FLAG;
+#endif /* Platform macro. */
+			if (options.input.platform >= 0)
+				flags = (u8)options.input.platform;
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_PLATFORM_FLAGS_REG, flags);
+			const u8 lang = options.input.localization >= 0 ? (u8)options.input.localization : 0;
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_LOCALIZATION_FLAGS_REG, lang);
+
+			_recording.platform = flags;
+			_recording.localization = lang;
+		}
+
+		// Initialize the RTC, it's left as power on unless it's specified by a
+		// recording.
+		if (options.input.rtc >= 0)
+			setRtc(options.input.rtc);
+		_recording.device = deviceTypeName(options.deviceType);
+		_recording.rtc = options.input.rtc;
+
+		// Initialize the input.
+		_input = &options.input;
+		_frame = 0;
+		_haltCount = emulator_get_halt_count(_emulator);
+		memset(&_buttons, 0, sizeof(JoypadButtons));
+		emulator_set_joypad_callback(_emulator, onInput, this);
+
+		// Initialize the rewind buffer.
+		if (options.rewindCapacity > 0) {
+			RewindInit rewind;
+			rewind.buffer_capacity = options.rewindCapacity;
+			rewind.frames_per_base_state = options.rewindKeyframeInterval > 0 ? options.rewindKeyframeInterval : 1;
+			_rewindBuffer = rewind_new(&rewind, _emulator);
+		}
+
+		// Initialize the profiler.
+		if (options.profilerInterval > 0)
+			_profiler.open(options.profilerInterval, options.profilerSymbols, options.profilerLines);
+
+		// Finish.
+		return true;
+	}
+	void close(void) {
+		if (_rewindBuffer) {
+			rewind_delete(_rewindBuffer);
+			_rewindBuffer = nullptr;
+		}
+		_profiler.close();
+		if (_emulator) {
+			emulator_delete(_emulator);
+			_emulator = nullptr;
+		}
+		_input = nullptr;
+		_recording.clear();
+		_streaming.clear();
+	}
+
+	void updateKeys(void) {
+		if (!_input)
+			return;
+
+		_buttons = joypad_unpack_buttons(_input->buttons(_frame));
+	}
+
+	void setRtc(int seconds) {
+		// The same as the device, the RTC is started, latched then set.
+		auto select = [this] (UInt8 part) -> void {
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_SELECT_REG, part);
+		};
+		auto set = [this, select] (UInt8 part, UInt16 val) -> void {
+			select(part);
+			emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_VALUE_REG, (u8)val);
+			if (part == DEVICE_BINJGB_RTC_VALUE_DAY) {
+				select(DEVICE_BINJGB_RTC_VALUE_FLAGS);
+				const u8 old = emulator_read_u8_raw(_emulator, DEVICE_BINJGB_RTC_VALUE_REG);
+				emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_VALUE_REG, (u8)((old & 0x0e) | ((val >> 8) & 0x01)));
+			}
+		};
+
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RAM_ENABLE_REG, 0x0a);
+		select(DEVICE_BINJGB_RTC_VALUE_FLAGS);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_VALUE_REG, (u8)(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_RTC_VALUE_REG) & ~DEVICE_BINJGB_RTC_TIMER_STOP));
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_LATCH_REG, 0);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RTC_LATCH_REG, 1);
+		set(DEVICE_BINJGB_RTC_VALUE_DAY,  (UInt16)(seconds / (24 * 60 * 60)));
+		set(DEVICE_BINJGB_RTC_VALUE_HOUR, (UInt16)(seconds / (60 * 60) % 24));
+		set(DEVICE_BINJGB_RTC_VALUE_MIN,  (UInt16)(seconds / 60 % 60));
+		set(DEVICE_BINJGB_RTC_VALUE_SEC,  (UInt16)(seconds % 60));
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_RAM_ENABLE_REG, 0x00);
+	}
+
+	void pollStreaming(Result &result) {
+		// The same as the device, it's polled once per frame.
+		if (!_extended) // GBB EXTENSION.
+			return;
+
+		const u8 status = emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_STATUS_REG);
+		if (status == DEVICE_BINJGB_STREAMING_STATUS_READY || status == DEVICE_BINJGB_STREAMING_STATUS_BUSY)
+			return;
+
+		if (status & DEVICE_BINJGB_STREAMING_STATUS_BLOCK) {
+			const UInt16 address = (UInt16)(
+				emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG) |
+				(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_ADDRESS_REG + 1) << 8)
+			);
+			const UInt16 size = (UInt16)(
+				emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG) |
+				(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_BLOCK_SIZE_REG + 1) << 8)
+			);
+			for (int i = 0; i < (int)size && address + i <= 0xffff; ++i)
+				_streaming.push_back(emulator_read_u8_raw(_emulator, (Address)(address + i)));
+		} else if (!(status & DEVICE_BINJGB_STREAMING_STATUS_EOS)) {
+			_streaming.push_back(emulator_read_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_ADDRESS));
+		}
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_ADDRESS, 0);
+		emulator_write_u8_raw(_emulator, DEVICE_BINJGB_STREAMING_STATUS_REG, DEVICE_BINJGB_STREAMING_STATUS_READY);
+
+		if (status & DEVICE_BINJGB_STREAMING_STATUS_EOS) {
+			Stream stream;
+			stream.frame = _frame;
+			stream.data.swap(_streaming);
+			stream.hash = hash(stream.data.empty() ? nullptr : &stream.data.front(), stream.data.size());
+			result.streams.push_back(stream);
+		}
+	}
+
+	static const char* deviceTypeName(Device::DeviceTypes type) {
+		switch (type) {
+		case Device::DeviceTypes::CLASSIC:          return "classic";
+		case Device::DeviceTypes::COLORED:          return "colored";
+		case Device::DeviceTypes::CLASSIC_EXTENDED: return "classic_ext";
+		case Device::DeviceTypes::COLORED_EXTENDED: return "colored_ext";
+		default:                                    return "";
+		}
+	}
+
+	static UInt64 hash(const UInt8* bytes, size_t len) {
+		UInt64 result = RUNNER_HASH_OFFSET_BASIS;
+		for (size_t i = 0; i < len; ++i) {
+			result ^= bytes[i];
+			result *= RUNNER_HASH_PRIME;
+		}
+
+		return result;
+	}
+
+	static void onInput(JoypadButtons* joyp, void* data) {
+		RunnerImpl* self = (RunnerImpl*)data;
+
+		*joyp = self->_buttons;
+
+		if (self->_extended) { // GBB EXTENSION.
+			// Extension feature: no touch.
+			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_X_REG, (u8)0xff);
+			emulator_write_u8_raw(self->_emulator, DEVICE_BINJGB_TOUCH_Y_REG, (u8)0xff);
+		}
+	}
+};
+
+Runner::Region::Region() {
+}
+
+Runner::Region::Region(UInt16 address_, UInt16 size_) : address(address_), size(size_) {
+}
+
+Runner::~Runner() {
+}
+
+Runner* Runner::create(void) {
+	RunnerImpl* result = new RunnerImpl();
+
+	return result;
+}
+
+void Runner::destroy(Runner* ptr) {
+	RunnerImpl* impl = static_cast<RunnerImpl*>(ptr);
+	delete impl;
+}
+
+/* ===========================================================================} */
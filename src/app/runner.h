@@ -0,0 +1,117 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#ifndef __RUNNER_H__
+#define __RUNNER_H__
+
+#include "../gbbasic.h"
+#include "device.h"
+#include "profiler.h"
+#include "recording.h"
+#include <string>
+#include <vector>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef RUNNER_DEFAULT_FRAME_COUNT
+#	define RUNNER_DEFAULT_FRAME_COUNT 600 // ~10 seconds.
+#endif /* RUNNER_DEFAULT_FRAME_COUNT */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Runner
+*/
+
+/**
+ * @brief Headless runner, it drives a ROM for a fixed number of frames as fast
+ *   as possible without video or audio output, for benchmarking and regression
+ *   tests.
+ */
+class Runner {
+public:
+	/**
+	 * @brief RAM region to dump after running.
+	 */
+	struct Region {
+		typedef std::vector<Region> Array;
+
+		UInt16 address = 0;
+		UInt16 size = 0;
+
+		Region();
+		Region(UInt16 address, UInt16 size);
+	};
+
+	/**
+	 * @brief Data streamed by the ROM, till an end-of-stream.
+	 */
+	struct Stream {
+		typedef std::vector<Stream> Array;
+
+		int frame = 0; // When it ended.
+		std::vector<UInt8> data;
+		UInt64 hash = 0;
+	};
+
+	struct Options {
+		Device::DeviceTypes deviceType = Device::DeviceTypes::COLORED_EXTENDED;
+		int frameCount = RUNNER_DEFAULT_FRAME_COUNT;
+		int hashInterval = 0; // Hashes the last frame only if it's 0.
+		Recording input; // Joypad input, and the host states to reproduce a recorded run.
+		Region::Array regions;
+		size_t rewindCapacity = 0; // Captures every frame into a rewind buffer if it's not 0.
+		int rewindKeyframeInterval = DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL;
+		int profilerInterval = 0; // Samples every such many CPU ticks if it's not 0.
+		std::string profilerSymbols; // Content of the kernel's ".sym" file.
+		Profiler::Line::Array profilerLines;
+	};
+
+	struct Result {
+		typedef std::vector<std::pair<int, UInt64>> FrameHashes;
+		typedef std::vector<std::vector<UInt8>> RegionData;
+
+		int frameCount = 0;
+		UInt64 ticks = 0; // Total CPU ticks.
+		UInt64 busyTicks = 0; // CPU ticks spent out of `HALT`.
+		double seconds = 0; // Host time.
+		bool invalidOpcode = false;
+		int lagFrames = 0; // Frames in which the VM missed the vertical sync.
+		FrameHashes frameHashes;
+		UInt64 stateHash = 0; // See `Recording::stateHash(...)`, at the end of the last frame.
+		RegionData regions; // Corresponds to `Options::regions`.
+		Stream::Array streams;
+		int rewindFrames = 0; // Captured frames.
+		UInt64 rewindBytes = 0; // Compressed, including the overwritten ones.
+		UInt64 rewindUncompressedBytes = 0;
+		double rewindSeconds = 0; // Host time spent on capturing.
+		Profiler::Report profile;
+		Recording recording; // The input and host states as applied, till the last frame.
+	};
+
+public:
+	virtual ~Runner();
+
+	/**
+	 * @brief Runs the specific ROM from power on.
+	 *
+	 * @return `true` if the ROM ran through, otherwise `false`.
+	 */
+	virtual bool run(const UInt8* rom, size_t size, const Options &options, Result &result) = 0;
+
+	static Runner* create(void);
+	static void destroy(Runner* ptr);
+};
+
+/* ===========================================================================} */
+
+#endif /* __RUNNER_H__ */
@@ -82,6 +82,12 @@ Settings &Settings::operator = (const Settings &other) {
 	emulatorMuted = other.emulatorMuted;
 	emulatorSpeed = other.emulatorSpeed;
 	emulatorPreferedSpeed = other.emulatorPreferedSpeed;
+	emulatorThreaded = other.emulatorThreaded;
+	emulatorRewindBudget = other.emulatorRewindBudget;
+	emulatorRewindKeyframeInterval = other.emulatorRewindKeyframeInterval;
+	emulatorProfilerInterval = other.emulatorProfilerInterval;
+	emulatorRecordInput = other.emulatorRecordInput;
+	emulatorReplayInput = other.emulatorReplayInput;
 
 	canvasFixRatio = other.canvasFixRatio;
 	canvasIntegerScale = other.canvasIntegerScale;
@@ -155,7 +161,13 @@ bool Settings::operator != (const Settings &other) const {
 
 	if (emulatorMuted != other.emulatorMuted ||
 		emulatorSpeed != other.emulatorSpeed ||
-		emulatorPreferedSpeed != other.emulatorPreferedSpeed
+		emulatorPreferedSpeed != other.emulatorPreferedSpeed ||
+		emulatorThreaded != other.emulatorThreaded ||
+		emulatorRewindBudget != other.emulatorRewindBudget ||
+		emulatorRewindKeyframeInterval != other.emulatorRewindKeyframeInterval ||
+		emulatorProfilerInterval != other.emulatorProfilerInterval ||
+		emulatorRecordInput != other.emulatorRecordInput ||
+		emulatorReplayInput != other.emulatorReplayInput
 	) {
 		return true;
 	}
@@ -72,6 +72,12 @@ struct Settings {
 	bool emulatorMuted = false;
 	int emulatorSpeed = DEVICE_BASE_SPEED_FACTOR * 1;
 	int emulatorPreferedSpeed = DEVICE_BASE_SPEED_FACTOR * DEVICE_DEFAULT_PREFERED_SPEED;
+	bool emulatorThreaded = false;
+	int emulatorRewindBudget = DEVICE_DEFAULT_REWIND_BUDGET_MB; // In megabytes.
+	int emulatorRewindKeyframeInterval = DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL; // In frames.
+	int emulatorProfilerInterval = 0; // In CPU ticks, 0 to disable.
+	std::string emulatorRecordInput; // Path to record the joypad input to, empty to disable.
+	std::string emulatorReplayInput; // Path to replay the joypad input from, empty to disable; it's prior to recording.
 
 	bool canvasFixRatio = true;
 	bool canvasIntegerScale = true;
@@ -528,6 +528,7 @@ bool Workspace::open(Window* wnd, Renderer* rnd, const char* font, unsigned fps,
 	canvasIntegerScale(true);
 	canvasHovering(false);
 	canvasCursorMode(Device::CursorTypes::POINTER);
+	canvasRewoundSeconds(0.0);
 
 	// Initialize the console.
 	EditorConsole* editor = (EditorConsole*)consoleTextBox();
@@ -4332,11 +4333,7 @@ void Workspace::join(void) {
 	if (!workQueue())
 		return;
 
-	constexpr const int STEP = 10;
-	while (!workQueue()->allProcessed()) {
-		workQueue()->update();
-		DateTime::sleep(STEP);
-	}
+	workQueue()->await();
 }
 
 void Workspace::wait(void) {
@@ -4348,7 +4345,7 @@ void Workspace::wait(void) {
 
 	constexpr const int STEP = 10;
 	workQueue()->update();
-	DateTime::sleep(STEP);
+	workQueue()->wait(STEP);
 }
 
 bool Workspace::working(void) const {
@@ -4381,12 +4378,11 @@ bool Workspace::analyze(bool force) {
 			return false;
 	}
 
+	prj->assets()->materialize(true); // The analyzer reads the snapshot on another thread.
+
 	AssetsBundle::Ptr assets(new AssetsBundle());
-	prj->assets()->clone(
+	prj->assets()->snapshot(
 		assets.get(),
-		[] (const FontAssets::Entry* entry) -> FontAssets::Entry {
-			return *entry;
-		},
 		[] (const CodeAssets::Entry* entry) -> std::string {
 			std::string result = entry->data;
 			EditorCode* codeEditor = (EditorCode*)entry->editor;
@@ -4966,12 +4962,12 @@ void Workspace::compile(
 
 		GBBASIC::Program program;
 		GBBASIC::Options options;
+		Text::Array invalidOptions;
 
 		if (project) {
 			AssetsBundle::Ptr assets(new AssetsBundle());
-			project->assets()->clone(
+			project->assets()->snapshot(
 				assets.get(),
-				nullptr,
 				[] (const CodeAssets::Entry* entry) -> std::string {
 					std::string result = entry->data;
 					EditorCode* codeEditor = (EditorCode*)entry->editor;
@@ -5021,6 +5017,9 @@ void Workspace::compile(
 		Text::Dictionary::const_iterator astOpt = arguments.find(COMPILER_AST_OPTION_KEY);
 		if (vmOpt != arguments.end())
 			options.ast = astOpt->second;
+		Text::Dictionary::const_iterator lnmOpt = arguments.find(COMPILER_LINE_MAP_OPTION_KEY);
+		if (lnmOpt != arguments.end())
+			options.lineMap = lnmOpt->second;
 
 		// Initialize the cartridge options.
 		if (project) {
@@ -5100,10 +5099,24 @@ void Workspace::compile(
 		Text::Dictionary::const_iterator oppOpt = arguments.find(COMPILER_OPTIMIZE_ASSETS_OPTION_KEY);
 		if (oppOpt != arguments.end())
 			Text::fromString(oppOpt->second, options.strategies.optimizeAssets);
+		Text::Dictionary::const_iterator alcOpt = arguments.find(COMPILER_ASSETS_ALLOCATOR_OPTION_KEY);
+		if (alcOpt != arguments.end()) {
+			if (!GBBASIC::Pipeline::allocatorOf(alcOpt->second, options.strategies.assetsAllocator))
+				invalidOptions.push_back("Invalid assets allocator: \"" + alcOpt->second + "\".");
+		}
+		Text::Dictionary::const_iterator cmpOpt = arguments.find(COMPILER_COMPRESS_TILES_OPTION_KEY);
+		if (cmpOpt != arguments.end())
+			Text::fromString(cmpOpt->second, options.strategies.compressTiles);
 
 		// Initialize the pipeline options.
 		options.piping.useWorkQueue = false;
 		options.piping.lessConsoleOutput = false;
+		options.piping.parallelParsing = true;
+		Text::Dictionary::const_iterator bcOpt = arguments.find(COMPILER_BUILD_CACHE_OPTION_KEY);
+		if (bcOpt != arguments.end()) {
+			const std::string pref = Path::writableDirectory();
+			options.piping.buildCacheDirectory = Path::combine(pref.c_str(), WORKSPACE_BUILD_CACHE_NAME);
+		}
 
 		// Initialize the output methods.
 		bool resIsOk = true;
@@ -5252,9 +5265,13 @@ void Workspace::compile(
 		options.onPrint(GBBASIC_TITLE " v" GBBASIC_VERSION_STRING);
 		options.onPrint("");
 
+		for (const std::string &msg : invalidOptions)
+			options.onError(msg, false, -1, -1, -1);
+
 		const long long start = DateTime::ticks();
 
 		const bool codeIsOk =
+			invalidOptions.empty() &&
 			   GBBASIC::load(program, options) &&
 			GBBASIC::compile(program, options) &&
 			   GBBASIC::link(program, options);
@@ -5293,6 +5310,11 @@ void Workspace::compile(
 			self->_compilingParameters = CompilingParameters();
 
 			self->_compilingOutput = codeIsOk && resIsOk ? program.compiled.bytes : nullptr;
+
+			self->_canvasProfilerSymbols = program.symbols;
+			self->_canvasProfilerLines.clear();
+			for (const GBBASIC::LineLocation &loc : program.compiled.lines)
+				self->_canvasProfilerLines.push_back(Profiler::Line(loc.page, loc.line, loc.bank, loc.address, loc.size));
 		} while (false);
 
 		self->_state = States::COMPILED;
@@ -5365,6 +5387,15 @@ void Workspace::compile(
 		}
 	} while (false);
 
+	// Materialize the deferred assets on the main thread, the compiler reads a snapshot of them.
+	do {
+		const Project::Ptr &prj_ = prj ? prj : tmpPrj;
+		if (!prj_ || !prj_->assets())
+			break;
+
+		prj_->assets()->materialize(true);
+	} while (false);
+
 	// Initialize the compiling context.
 	do {
 		LockGuard<decltype(_lock)> guard(_lock);
@@ -5431,6 +5462,8 @@ Bytes::Ptr Workspace::compile(
 	options.strategies.bootstrapBank = bootstrapBank;
 	options.piping.useWorkQueue = false;
 	options.piping.lessConsoleOutput = true;
+	options.piping.parallelParsing = true;
+	options.piping.useCache = true;
 	options.onPrint = [] (const std::string &msg) -> void {
 		fprintf(stdout, "%s\n", msg.c_str());
 	};
@@ -5629,6 +5662,12 @@ bool Workspace::loadConfig(Window*, Renderer*, const rapidjson::Document &doc) {
 	Jpath::get(doc, settings().emulatorMuted, "emulator", "muted");
 	Jpath::get(doc, settings().emulatorSpeed, "emulator", "speed");
 	Jpath::get(doc, settings().emulatorPreferedSpeed, "emulator", "prefered_speed");
+	Jpath::get(doc, settings().emulatorThreaded, "emulator", "threaded");
+	Jpath::get(doc, settings().emulatorRewindBudget, "emulator", "rewind_budget");
+	Jpath::get(doc, settings().emulatorRewindKeyframeInterval, "emulator", "rewind_keyframe_interval");
+	Jpath::get(doc, settings().emulatorProfilerInterval, "emulator", "profiler_interval");
+	Jpath::get(doc, settings().emulatorRecordInput, "emulator", "record_input");
+	Jpath::get(doc, settings().emulatorReplayInput, "emulator", "replay_input");
 
 	Jpath::get(doc, settings().canvasFixRatio, "canvas", "fix_ratio");
 	Jpath::get(doc, settings().canvasIntegerScale, "canvas", "integer_scale");
@@ -5717,6 +5756,12 @@ bool Workspace::saveConfig(Window*, Renderer*, rapidjson::Document &doc) {
 	Jpath::set(doc, doc, settings().emulatorMuted, "emulator", "muted");
 	Jpath::set(doc, doc, settings().emulatorSpeed, "emulator", "speed");
 	Jpath::set(doc, doc, settings().emulatorPreferedSpeed, "emulator", "prefered_speed");
+	Jpath::set(doc, doc, settings().emulatorThreaded, "emulator", "threaded");
+	Jpath::set(doc, doc, settings().emulatorRewindBudget, "emulator", "rewind_budget");
+	Jpath::set(doc, doc, settings().emulatorRewindKeyframeInterval, "emulator", "rewind_keyframe_interval");
+	Jpath::set(doc, doc, settings().emulatorProfilerInterval, "emulator", "profiler_interval");
+	Jpath::set(doc, doc, settings().emulatorRecordInput, "emulator", "record_input");
+	Jpath::set(doc, doc, settings().emulatorReplayInput, "emulator", "replay_input");
 
 	Jpath::set(doc, doc, settings().canvasFixRatio, "canvas", "fix_ratio");
 	Jpath::set(doc, doc, settings().canvasIntegerScale, "canvas", "integer_scale");
@@ -6149,6 +6194,10 @@ bool Workspace::execute(Window* wnd, Renderer* rnd, double delta, unsigned* fpsR
 		};
 	}
 
+#if defined GBBASIC_OS_WIN || defined GBBASIC_OS_MAC || defined GBBASIC_OS_LINUX
+	rewind(wnd, rnd, delta, ImGui::IsKeyDown(SDL_SCANCODE_F10) && canUseShortcuts());
+#endif /* Platform macro. */
+
 	const Device::KeyboardModifiers keyMods(io.KeyCtrl, io.KeyShift, io.KeyAlt, io.KeySuper);
 	canvasDevice()->update(wnd, rnd, delta, canvasTexture().get(), !popupBox() && !menuOpened(), &keyMods, audioHandler);
 
@@ -6175,6 +6224,61 @@ void Workspace::saveSram(Window* wnd, Renderer* rnd) {
 	Operations::projectSaveSram(wnd, rnd, this, prj, sram, true);
 }
 
+void Workspace::saveState(Window*, Renderer*) {
+	if (!canvasDevice())
+		return;
+
+	Bytes::Ptr state(Bytes::create());
+	if (!canvasDevice()->writeState(state.get())) {
+		warn("Cannot save the emulator state.");
+
+		return;
+	}
+	canvasState(state);
+
+	print("Saved the emulator state.");
+}
+
+void Workspace::loadState(Window*, Renderer*) {
+	if (!canvasDevice())
+		return;
+
+	if (!canvasState()) {
+		warn("No emulator state saved yet.");
+
+		return;
+	}
+	if (!canvasDevice()->readState(canvasState().get())) {
+		warn("Cannot load the emulator state.");
+
+		return;
+	}
+
+	print("Loaded the emulator state.");
+}
+
+void Workspace::rewind(Window*, Renderer*, double delta, bool held) {
+	if (!canvasDevice())
+		return;
+
+	if (!held) {
+		if (canvasDevice()->rewinding())
+			canvasDevice()->rewindEnd();
+
+		return;
+	}
+
+	if (!canvasDevice()->rewinding()) {
+		if (!canvasDevice()->rewindBegin())
+			return; // Rewinding is disabled.
+
+		canvasRewoundSeconds(0.0);
+	}
+	double reached = 0;
+	if (canvasDevice()->rewindTo(canvasRewoundSeconds() + delta * WORKSPACE_REWIND_SPEED, &reached))
+		canvasRewoundSeconds(reached);
+}
+
 void Workspace::prepare(Window*, Renderer*) {
 	// Do nothing.
 }
@@ -6344,6 +6448,8 @@ void Workspace::shortcuts(Window* wnd, Renderer* rnd) {
 	const bool f6         = ImGui::IsKeyPressed(SDL_SCANCODE_F6);
 	const bool f7         = ImGui::IsKeyPressed(SDL_SCANCODE_F7);
 	const bool f8         = ImGui::IsKeyPressed(SDL_SCANCODE_F8);
+	const bool f9         = ImGui::IsKeyPressed(SDL_SCANCODE_F9);
+	const bool f10        = ImGui::IsKeyPressed(SDL_SCANCODE_F10);
 	const bool f11        = ImGui::IsKeyPressed(SDL_SCANCODE_F11);
 #endif /* Platform macro. */
 
@@ -6486,6 +6592,20 @@ void Workspace::shortcuts(Window* wnd, Renderer* rnd) {
 	if (!canUseShortcuts())
 		return;
 
+	// Emulator operations.
+#if defined GBBASIC_OS_WIN || defined GBBASIC_OS_MAC || defined GBBASIC_OS_LINUX
+	if (canvasDevice()) {
+		if (f9 && !modifier && !io.KeyShift && !io.KeyAlt) {
+			saveState(wnd, rnd);
+		} else if (f9 && !modifier && io.KeyShift && !io.KeyAlt) {
+			loadState(wnd, rnd);
+		} else if (f10 && !modifier && !io.KeyShift && !io.KeyAlt) {
+			if (canvasDevice()->rewindBudget(nullptr) == 0)
+				warn("Rewinding is disabled, set \"emulator.rewind_budget\" in the settings to enable it.");
+		}
+	}
+#endif /* Platform macro. */
+
 	// Edit operations.
 	if (opened) {
 		if (z && modifier && !io.KeyShift && !io.KeyAlt) {
@@ -11553,7 +11673,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->tilesPageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getTiles(i);
+		BaseAssets::Entry* entry = prj->assets()->tiles.peek(i); // Only the editor is needed.
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11566,7 +11686,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->mapPageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getMap(i);
+		BaseAssets::Entry* entry = prj->assets()->maps.peek(i);
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11579,7 +11699,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->musicPageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getMusic(i);
+		BaseAssets::Entry* entry = prj->assets()->music.peek(i);
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11592,7 +11712,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->sfxPageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getSfx(i);
+		BaseAssets::Entry* entry = prj->assets()->sfx.peek(i);
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11605,7 +11725,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->actorPageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getActor(i);
+		BaseAssets::Entry* entry = prj->assets()->actors.peek(i);
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11618,7 +11738,7 @@ int Workspace::withAllAssets(EditorHandler handler) const {
 	}
 
 	for (int i = 0; i < prj->scenePageCount(); ++i) {
-		BaseAssets::Entry* entry = prj->getScene(i);
+		BaseAssets::Entry* entry = prj->assets()->scenes.peek(i);
 		if (!entry)
 			continue;
 		Editable* editor = entry->editor;
@@ -11864,7 +11984,9 @@ void Workspace::runProject(Window* wnd, Renderer* rnd, Bytes::Ptr rom) {
 		);
 	}
 
-	// Start running.
+	// Start running, a saved state doesn't apply to another build.
+	canvasState(nullptr);
+
 	Bytes::Ptr sram(Bytes::create());
 	Operations::projectLoadSram(wnd, rnd, this, prj, sram)
 		.always(
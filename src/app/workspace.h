@@ -92,6 +92,9 @@
 #ifndef WORKSPACE_ACTIVITIES_NAME
 #	define WORKSPACE_ACTIVITIES_NAME "gbbasic_activities"
 #endif /* WORKSPACE_ACTIVITIES_NAME */
+#ifndef WORKSPACE_BUILD_CACHE_NAME
+#	define WORKSPACE_BUILD_CACHE_NAME "gbbasic_build_cache"
+#endif /* WORKSPACE_BUILD_CACHE_NAME */
 
 #ifndef WORKSPACE_FONT_DIR
 #	define WORKSPACE_FONT_DIR "../fonts/" /* Relative path. */
@@ -183,6 +186,10 @@
 #	endif /* Platform macro. */
 #endif /* WORKSPACE_HEAD_BAR_ADJUSTING_ENABLED */
 
+#ifndef WORKSPACE_REWIND_SPEED
+#	define WORKSPACE_REWIND_SPEED 2.0 // Emulated seconds rewound per second the key is held.
+#endif /* WORKSPACE_REWIND_SPEED */
+
 #ifndef WORKSPACE_AUTO_CLOSE_POPUP
 #	define WORKSPACE_AUTO_CLOSE_POPUP(W) \
 		ProcedureGuard<void> GBBASIC_UNIQUE_NAME(__CLOSE__)( \
@@ -582,6 +589,10 @@ public:
 	GBBASIC_PROPERTY(std::string, canvasStatusText)
 	GBBASIC_PROPERTY(std::string, canvasStatusTooltip)
 	GBBASIC_PROPERTY(Device::CursorTypes, canvasCursorMode)
+	GBBASIC_PROPERTY(std::string, canvasProfilerSymbols)
+	GBBASIC_PROPERTY(Profiler::Line::Array, canvasProfilerLines)
+	GBBASIC_PROPERTY(Bytes::Ptr, canvasState) // The quick save slot of the running program.
+	GBBASIC_PROPERTY(double, canvasRewoundSeconds)
 
 	GBBASIC_PROPERTY_READONLY(Device::Ptr, audioDevice)
 
@@ -1001,6 +1012,9 @@ private:
 	bool execute(Window* wnd, Renderer* rnd, double delta, unsigned* fpsReq);
 	bool perform(Window* wnd, Renderer* rnd, double delta, unsigned* fpsReq, Device::AudioHandler handleAudio /* nullable */);
 	void saveSram(Window* wnd, Renderer* rnd);
+	void saveState(Window* wnd, Renderer* rnd);
+	void loadState(Window* wnd, Renderer* rnd);
+	void rewind(Window* wnd, Renderer* rnd, double delta, bool held);
 
 	void prepare(Window* wnd, Renderer* rnd);
 	void finish(Window* wnd, Renderer* rnd);
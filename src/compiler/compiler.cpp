@@ -15,9 +15,11 @@
 #include "../utils/plus.h"
 #include "../utils/rom_inspector.h"
 #include "../utils/text.h"
+#include "../utils/work_queue.h"
 #include "../../lib/jpath/jpath.hpp"
 #include "../../lib/rapidfuzz_cpp/rapidfuzz/fuzz.hpp"
 #include <stack>
+#include <thread>
 
 /*
 ** Notes
@@ -166,6 +168,21 @@ namespace GBBASIC {
 #	define MAP_ON_WITH_IMAGE_ENABLED  1
 #endif /* MAP_ON_WITH_IMAGE_ENABLED  */
 
+/**< Cache. */
+
+#ifndef LEXING_CACHE_MAX_COUNT
+#	define LEXING_CACHE_MAX_COUNT 256
+#endif /* LEXING_CACHE_MAX_COUNT */
+
+/**< Loader. */
+
+#ifndef SECTION_TAG_MAX_LENGTH
+#	define SECTION_TAG_MAX_LENGTH 64 // Longer tags are searched in the content.
+#endif /* SECTION_TAG_MAX_LENGTH */
+#ifndef MAPPED_SOURCE_MIN_SIZE
+#	define MAPPED_SOURCE_MIN_SIZE (1024 * 1024 * 4)
+#endif /* MAPPED_SOURCE_MIN_SIZE */
+
 /**< Parser. */
 
 #ifndef RESERVED
@@ -248,6 +265,10 @@ namespace GBBASIC {
 #	define BOOTSTRAP_ENTRY_ADDRESS 0x4000 // DOC: ROM SCHEMA.
 #endif /* BOOTSTRAP_ENTRY_ADDRESS */
 
+#ifndef TILES_UNPACKER_ENTRY_NAME // Kernels without this symbol can't unpack compressed tiles.
+#	define TILES_UNPACKER_ENTRY_NAME "graphics_load_tiles" // DOC: ROM SCHEMA.
+#endif /* TILES_UNPACKER_ENTRY_NAME */
+
 #ifndef SCRIPT_MEMORY_ENTRY_NAME
 #	define SCRIPT_MEMORY_ENTRY_NAME "script_memory" // DOC: RAM SCHEMA.
 #endif /* SCRIPT_MEMORY_ENTRY_NAME */
@@ -1226,6 +1247,14 @@ RamLocation::RamLocation(Types y, int a, int s, Usages u, const TextLocation &tx
 {
 }
 
+LineLocation::LineLocation() {
+}
+
+LineLocation::LineLocation(int p, int l, int b, int a, int s) :
+	page(p), line(l), bank(b), address(a), size(s)
+{
+}
+
 Macro::Macro() {
 	scopeLocationRange.first = TextLocation::INVALID();
 	scopeLocationRange.second = TextLocation::INVALID();
@@ -1296,12 +1325,149 @@ int Macro::compare(const Macro &other) const {
 	return 0;
 }
 
+/**
+ * @brief Index of names for fuzzy matching. It finds the same name as scoring
+ *   every name with `rapidfuzz::fuzz::ratio`, but only scores the names whose
+ *   upper bound could beat the best score so far. The bounds come from the
+ *   lengths and from the character histograms of the names.
+ */
+class FuzzyIndex {
+private:
+	static constexpr const int HISTOGRAM_SIZE = 64;
+	static constexpr const int HISTOGRAM_MAX_LENGTH = 255; // Longer names are always scored.
+
+	struct Entry {
+		typedef std::vector<Entry> Array;
+
+		std::string name;
+		Byte histogram[HISTOGRAM_SIZE];
+
+		Entry() {
+		}
+		Entry(const std::string &name_) : name(name_) {
+			fill(name, histogram);
+		}
+	};
+	typedef std::map<int, Entry::Array> Lengths;
+
+private:
+	Lengths _lengths; // Grouped by name length.
+
+public:
+	FuzzyIndex() {
+	}
+
+	void add(const std::string &name) {
+		if (name.empty())
+			return;
+
+		_lengths[(int)name.length()].push_back(Entry(name));
+	}
+	void clear(void) {
+		_lengths.clear();
+	}
+
+	/**
+	 * @brief Finds the name with the highest score to the specific key. Picks
+	 *   the smallest name in case of a tie.
+	 *
+	 * @return The matched name, or empty if none reaches the threshold.
+	 */
+	std::string match(const std::string &key, double* score_ /* nullable */) const {
+		// Prepare.
+		if (score_)
+			*score_ = 0;
+
+		if (_lengths.empty())
+			return std::string();
+
+		const int len = (int)key.length();
+		Byte histogram[HISTOGRAM_SIZE];
+		fill(key, histogram);
+
+		const rapidfuzz::fuzz::CachedRatio<char> scorer(key);
+		double best = 0.0;
+		const std::string* bestName = nullptr;
+
+		// Visit the length groups from the nearest to the farthest, in which order
+		// the length bound decreases.
+		Lengths::const_iterator down = _lengths.upper_bound(len);
+		Lengths::const_iterator up = down;
+		for (; ; ) {
+			const bool hasDown = down != _lengths.begin();
+			const bool hasUp = up != _lengths.end();
+			if (!hasDown && !hasUp)
+				break;
+
+			Lengths::const_iterator it;
+			if (hasDown && hasUp)
+				it = bound(std::prev(down)->first, len) >= bound(up->first, len) ? --down : up++;
+			else if (hasDown)
+				it = --down;
+			else
+				it = up++;
+
+			const int length = it->first;
+			if (bestName && bound(length, len) < best)
+				break;
+
+			for (const Entry &entry : it->second) {
+				if (bestName && length <= HISTOGRAM_MAX_LENGTH && len <= HISTOGRAM_MAX_LENGTH) {
+					int common = 0;
+					for (int i = 0; i < HISTOGRAM_SIZE; ++i)
+						common += std::min(entry.histogram[i], histogram[i]);
+					if (bound(common, length, len) < best)
+						continue;
+				}
+
+				const double score = scorer.similarity(entry.name);
+				if (score < FUZZY_MATCHING_SCORE_THRESHOLD)
+					continue;
+				if (score > best || (score == best && bestName && entry.name < *bestName)) {
+					best = score;
+					bestName = &entry.name;
+				}
+			}
+		}
+
+		// Finish.
+		if (!bestName)
+			return std::string();
+
+		if (score_)
+			*score_ = best;
+
+		return *bestName;
+	}
+
+private:
+	static void fill(const std::string &name, Byte* histogram) {
+		memset(histogram, 0, HISTOGRAM_SIZE);
+		if ((int)name.length() > HISTOGRAM_MAX_LENGTH)
+			return;
+
+		for (char ch : name)
+			++histogram[(Byte)ch % HISTOGRAM_SIZE];
+	}
+	/**
+	 * @brief Gets the upper bound of the ratio score of two names, with a small
+	 *   margin for floating-point rounding.
+	 */
+	static double bound(int common, int length0, int length1) {
+		return 100.0 * (2 * common) / (length0 + length1) + 1e-6;
+	}
+	static double bound(int length0, int length1) {
+		return bound(std::min(length0, length1), length0, length1);
+	}
+};
+
 struct SymbolTable {
 private:
 	typedef std::map<std::string, RomLocation> Dictionary;
 
 private:
 	Dictionary _dictionary;
+	FuzzyIndex _fuzzyIndex;
 
 public:
 	SymbolTable() {
@@ -1309,49 +1475,56 @@ public:
 
 	bool parseSymbols(const std::string &symbols) {
 		// Prepare.
-		std::string symbols_ = symbols;
-
-		// Uniform new line characters to '\n'.
-		symbols_ = Text::replace(symbols_, "\r\n", "\n");
-		symbols_ = Text::replace(symbols_, "\r", "\n");
-
-		// Split the symbol data into lines.
-		Text::Array lines;
-		const Text::Array lines_ = Text::split(symbols_, "\n");
-		for (std::string ln : lines_) {
-			const size_t idx = Text::indexOf(ln, ";");
-			if (idx != std::string::npos)
-				ln = ln.substr(0, idx);
-
-			ln = Text::trim(ln);
+		const char* txt = symbols.c_str();
+		const char* const end = txt + symbols.length();
+		auto isSpace = [] (char ch) -> bool {
+			return ch == ' ' || ch == '\f' || ch == '\t' || ch == '\v';
+		};
 
-			if (ln.empty())
+		// Parse the symbol lines in a single pass, in form of "BB:AAAA name".
+		while (txt < end) {
+			// Take a line, with the comment and the surrounding spaces stripped.
+			const char* ln = txt;
+			while (txt < end && *txt != '\r' && *txt != '\n')
+				++txt;
+			const char* lnEnd = std::find(ln, txt, ';');
+			while (txt < end && (*txt == '\r' || *txt == '\n'))
+				++txt;
+
+			while (ln < lnEnd && isSpace(*ln))
+				++ln;
+			while (lnEnd > ln && isSpace(*(lnEnd - 1)))
+				--lnEnd;
+			if (ln == lnEnd)
 				continue;
 
-			lines.push_back(ln);
-		}
-
-		// Parse the symbol lines.
-		for (const std::string &ln : lines) {
-			const Text::Array parts = Text::split(ln, " ");
-			if (parts.size() != 2)
+			// Split the address and the name by space.
+			const char* address = ln;
+			const char* addressEnd = std::find(ln, lnEnd, ' ');
+			const char* name = addressEnd;
+			while (name < lnEnd && *name == ' ')
+				++name;
+			if (name == lnEnd || std::find(name, lnEnd, ' ') != lnEnd)
 				continue;
 
-			const std::string &address_ = parts.front();
-			std::string name = parts.back();
-			const Text::Array addressParts = Text::split(address_, ":");
-			if (addressParts.size() != 2)
+			// Parse the bank and address.
+			const char* colon = std::find(address, addressEnd, ':');
+			if (colon == address || colon == addressEnd || std::find(colon + 1, addressEnd, ':') != addressEnd)
 				continue;
 
-			const std::string &bank = addressParts.front();
-			const std::string &address = addressParts.back();
+			char* parsed = nullptr;
+			const int nbank = (int)std::strtol(address, &parsed, 16);
+			if (parsed == address)
+				continue;
+			const int naddress = (int)std::strtol(colon + 1, &parsed, 16);
+			if (parsed == colon + 1)
+				continue;
 
-			if (Text::startsWith(name, "_", true))
-				name = name.substr(1 /* after "_" */);
-			const int nbank = std::stoi(bank, 0, 16);
-			const int naddress = std::stoi(address, 0, 16);
+			// Add the symbol.
+			if (*name == '_')
+				++name; // After "_".
 			const RomLocation romLocation(nbank, naddress);
-			_dictionary.insert(std::make_pair(name, romLocation));
+			add(std::string(name, lnEnd), romLocation);
 		}
 
 		// Finish.
@@ -1398,7 +1571,7 @@ public:
 			const int nbank = refLocation->bank;
 			const int naddress = refLocation->address + offset;
 			const RomLocation romLocation(nbank, naddress);
-			_dictionary.insert(std::make_pair(name, romLocation));
+			add(name, romLocation);
 		}
 
 		return true;
@@ -1416,35 +1589,27 @@ public:
 		if (_dictionary.empty())
 			return nullptr;
 
-		double fuzzyScore = 0.0;
-		Dictionary::const_iterator fuzzyIt = _dictionary.end();
-		for (Dictionary::const_iterator it = _dictionary.begin(); it != _dictionary.end(); ++it) {
-			const std::string &name = it->first;
-			if (name == key) {
-				gotKey = name;
-
-				return &it->second;
-			}
-
+		Dictionary::const_iterator it = _dictionary.find(key);
+		if (it == _dictionary.end()) {
+			const std::string name = _fuzzyIndex.match(key, nullptr);
 			if (name.empty())
-				continue;
+				return nullptr;
 
-			const double score = rapidfuzz::fuzz::ratio(name, key);
-			if (score < FUZZY_MATCHING_SCORE_THRESHOLD)
-				continue;
-			if (score > fuzzyScore) {
-				fuzzyScore = score;
-				fuzzyIt = it;
-			}
+			it = _dictionary.find(name);
 		}
+		if (it == _dictionary.end())
+			return nullptr;
 
-		if (fuzzyIt != _dictionary.end()) {
-			gotKey = fuzzyIt->first;
+		gotKey = it->first;
 
-			return &fuzzyIt->second;
-		}
+		return &it->second;
+	}
 
-		return nullptr;
+private:
+	void add(const std::string &name, const RomLocation &romLocation) {
+		const std::pair<Dictionary::iterator, bool> ret = _dictionary.insert(std::make_pair(name, romLocation));
+		if (ret.second)
+			_fuzzyIndex.add(name);
 	}
 };
 
@@ -2616,6 +2781,17 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Clones the token including its case sensitive text, which the copy
+	 *   constructor leaves out.
+	 */
+	Ptr clone(void) const {
+		Ptr result(new Token(*this));
+		result->_caseSensitiveText = _caseSensitiveText;
+
+		return result;
+	}
+
 	Types type(void) const {
 		return _type;
 	}
@@ -3753,6 +3929,19 @@ public:
 
 			return ret.second;
 		}
+		LineLocation::Array lines(int startAddress) const {
+			LineLocation::Array result;
+			for (const Dictionary::value_type &kv : _dictionary) {
+				const SourceLocation &srcLoc = kv.first;
+				const RomLocation &dstLoc = kv.second;
+				if (!srcLoc.label.empty() || srcLoc.sub <= 0 || dstLoc.size <= 0)
+					continue; // Ignore labels, nested statements and lines without code.
+
+				result.push_back(LineLocation(srcLoc.page, srcLoc.sub, dstLoc.bank, startAddress + dstLoc.address, dstLoc.size));
+			}
+
+			return result;
+		}
 	};
 	struct RamAllocator {
 	private:
@@ -3763,6 +3952,7 @@ public:
 
 		// Stores "ID" to "RAM address" mapping.
 		Dictionary _dictionary;
+		FuzzyIndex _fuzzyIndex;
 
 	public:
 		RamAllocator() {
@@ -3783,40 +3973,30 @@ public:
 			if (score_)
 				*score_ = 0;
 
-			double fuzzyScore = 0.0;
-			Dictionary::const_iterator fuzzyIt = _dictionary.end();
-			for (Dictionary::const_iterator it = _dictionary.begin(); it != _dictionary.end(); ++it) {
-				const std::string &name = it->first;
-				if (name == key) {
-					gotKey = name;
-
-					return &it->second;
-				}
-
-				if (name.empty())
-					continue;
+			Dictionary::const_iterator it = _dictionary.find(key);
+			if (it != _dictionary.end()) {
+				gotKey = it->first;
 
-				const double score = rapidfuzz::fuzz::ratio(name, key);
-				if (score < FUZZY_MATCHING_SCORE_THRESHOLD)
-					continue;
-				if (score > fuzzyScore) {
-					fuzzyScore = score;
-					fuzzyIt = it;
-				}
+				return &it->second;
 			}
 
-			if (fuzzyIt != _dictionary.end()) {
-				gotKey = fuzzyIt->first;
-				if (score_)
-					*score_ = fuzzyScore;
+			const std::string name = _fuzzyIndex.match(key, score_);
+			if (name.empty())
+				return nullptr;
 
-				return &fuzzyIt->second;
+			it = _dictionary.find(name);
+			if (it != _dictionary.end()) {
+				gotKey = it->first;
+
+				return &it->second;
 			}
 
 			return nullptr;
 		}
 		bool put(const std::string &key, const RamLocation &val) {
 			const std::pair<Dictionary::iterator, bool> ret = _dictionary.insert(std::make_pair(key, val));
+			if (ret.second)
+				_fuzzyIndex.add(key);
 
 			return ret.second;
 		}
@@ -3943,6 +4123,22 @@ public:
 			}
 		};
 
+		struct Optimization {
+			typedef std::map<int, int> Savings;
+
+			Savings saved; // The bytes saved by optimization, indexed by page.
+
+			Optimization() {
+			}
+
+			void save(int page, int size) {
+				if (size <= 0)
+					return;
+
+				saved[page] += size;
+			}
+		};
+
 		struct Loop {
 			typedef std::list<Loop> Stack;
 
@@ -4171,6 +4367,7 @@ public:
 		Expect expect;                                         // Stores the syntax expectations.
 		Declaration declaration;                               // Stores the declaration context.
 		Expression expression;                                 // Stores the expression context.
+		Optimization optimization;                             // Stores the optimization statistics.
 		Loop::Stack loop;                                      // Stores the loop context.
 
 		const Array* array = nullptr;                          // Stores the array configuration, and user defined arrays.
@@ -4741,6 +4938,12 @@ public:
 	bool noChild(void) const {
 		return _children.empty();
 	}
+	bool lastChildIs(Types y) const {
+		if (_children.empty())
+			return false;
+
+		return _children.back()->type() == y;
+	}
 	const Array &allChildren(void) const {
 		return _children;
 	}
@@ -7070,6 +7273,29 @@ public:
 	}
 	using Node::dump;
 
+	bool constant(Context::Stack &context, Int16 &val, int* folded) const {
+		// FEAT: OPTIMIZATION.
+		// Check whether this expression can be folded to a constant at compile time.
+		Context &ctx = context.top();
+
+		if (!ctx.expression.optimize || !noChild())
+			return false;
+
+		Token::Array rpn;
+		int folded_ = 0;
+		const Error::Handler ignore = [] (const Error &, const std::string &, const TextLocation &) -> void { /* Do nothing. */ };
+		if (!toRpn(context, rpn, ignore, &folded_))
+			return false;
+		if (rpn.size() != 1 || !rpn.front()->is(Token::Types::INTEGER))
+			return false;
+
+		val = (Int16)(Variant::Long)rpn.front()->data();
+		if (folded)
+			*folded = folded_;
+
+		return true;
+	}
+
 private:
 	void generateSlot(Bytes::Ptr &bytes, Context::Stack &context, int index, Counter &stk, Error::Handler onError) {
 		// Prepare.
@@ -7238,8 +7464,21 @@ private:
 
 		// Convert the infix expression to RPN.
 		Token::Array rpn;
-		if (!toRpn(context, rpn, onError))
+		int folded = 0;
+		if (!toRpn(context, rpn, onError, &folded))
 			return; // Error occured.
+		ctx.optimization.save(ctx.currentPage, folded);
+
+		// FEAT: OPTIMIZATION.
+		// Push the result directly if the whole expression has been folded to a constant.
+		if (ctx.expression.optimize && rpn.size() == 1 && rpn.front()->is(Token::Types::INTEGER)) {
+			const Int16 data = (Int16)(Variant::Long)rpn.front()->data();
+			Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::PUSH]); INC_COUNTER(stk, 2);
+			args = fill(args, (UInt16)data);
+			ctx.optimization.save(ctx.currentPage, (std::numeric_limits<signed char>::min() <= data && data <= std::numeric_limits<signed char>::max()) ? 1 : 2); // `VM_RPN`, `VM_OP_R_INT8`/`VM_OP_R_INT16` and the terminator versus `VM_PUSH_CONST`.
+
+			return; // Finished.
+		}
 
 		// Emit the temporaries.
 		Context::Expression::Temporaries temporaries;
@@ -7509,7 +7748,7 @@ private:
 		}
 	}
 
-	bool toRpn(Context::Stack &context, Token::Array &rpn, Error::Handler onError) const {
+	bool toRpn(Context::Stack &context, Token::Array &rpn, Error::Handler onError, int* folded = nullptr) const {
 		// Prepare.
 		typedef std::stack<Token::Ptr> Stack;
 
@@ -7559,7 +7798,111 @@ private:
 
 			return tk;
 		};
-		auto add = [&rpn, &ctx, is] (const Token::Ptr &tk) -> void {
+		auto sizeOf = [] (const Token::Ptr &tk) -> int {
+			const Int16 data = (Int16)(Variant::Long)tk->data();
+			if (std::numeric_limits<signed char>::min() <= data && data <= std::numeric_limits<signed char>::max())
+				return 1 + sizeof(Int8); // `VM_OP_R_INT8`.
+
+			return 1 + sizeof(Int16); // `VM_OP_R_INT16`.
+		};
+		auto fold = [&rpn, folded, sizeOf] (const Token::Ptr &tk) -> bool {
+			// FEAT: OPTIMIZATION.
+			// Evaluate an operator with constant operands at compile time, with the same
+			// 16-bit semantics as `vm_rpn`.
+			if (!tk->is(Token::Types::OPERATOR))
+				return false;
+
+			const std::string op = (std::string)tk->data();
+			const bool unary = op == NEGATIVE || op == "not" || op == "bnot";
+			const int n = unary ? 1 : 2;
+			if ((int)rpn.size() < n)
+				return false;
+			for (int i = (int)rpn.size() - n; i < (int)rpn.size(); ++i) {
+				if (rpn[i]->type() != Token::Types::INTEGER)
+					return false;
+			}
+
+			const Int16 a = (Int16)(Variant::Long)rpn[rpn.size() - n]->data();
+			const Int16 b = (Int16)(Variant::Long)rpn.back()->data();
+			Int16 result = 0;
+			if (op == "+") {
+				result = (Int16)(a + b);
+			} else if (op == "-") {
+				result = (Int16)(a - b);
+			} else if (op == NEGATIVE) {
+				result = (Int16)-a;
+			} else if (op == "*") {
+				result = (Int16)(a * b);
+			} else if (op == "/") {
+				if (b == 0 || (a == std::numeric_limits<Int16>::min() && b == -1))
+					return false; // Leave it to the VM.
+				result = (Int16)(a / b);
+			} else if (op == "mod") {
+				if (b == 0 || (a == std::numeric_limits<Int16>::min() && b == -1))
+					return false; // Leave it to the VM.
+				result = (Int16)(a % b);
+			} else if (op == "=") {
+				result = a == b;
+			} else if (op == "<") {
+				result = a < b;
+			} else if (op == "<=") {
+				result = a <= b;
+			} else if (op == ">") {
+				result = a > b;
+			} else if (op == ">=") {
+				result = a >= b;
+			} else if (op == "<>") {
+				result = a != b;
+			} else if (op == "and") {
+				result = a && b;
+			} else if (op == "or") {
+				result = a || b;
+			} else if (op == "not") {
+				result = !a;
+			} else if (op == "band") {
+				result = (Int16)(a & b);
+			} else if (op == "bor") {
+				result = (Int16)(a | b);
+			} else if (op == "bxor") {
+				result = (Int16)(a ^ b);
+			} else if (op == "bnot") {
+				result = (Int16)~a;
+			} else if (op == "lshift") {
+				if (b < 0 || b > 15)
+					return false; // Leave it to the VM.
+				result = (Int16)(UInt16)((UInt16)a << b);
+			} else if (op == "rshift") {
+				if (b < 0 || b > 15)
+					return false; // Leave it to the VM.
+				result = (Int16)(a >> b);
+			} else {
+				return false;
+			}
+
+			int size = 1; // The operator.
+			for (int i = 0; i < n; ++i) {
+				size += sizeOf(rpn.back());
+				rpn.pop_back();
+			}
+			Token::Ptr newnum = Token::Ptr(new Token());
+			newnum
+				->type(Token::Types::INTEGER)
+				->data((int)result);
+			rpn.push_back(newnum);
+			size -= sizeOf(newnum);
+			if (folded)
+				*folded += size;
+
+			return true;
+		};
+		auto add = [&rpn, &ctx, is, fold] (const Token::Ptr &tk) -> void {
+			// FEAT: OPTIMIZATION.
+			// Fold constant sub-expressions.
+			if (ctx.expression.optimize) {
+				if (fold(tk))
+					return;
+			}
+
 			// FEAT: OPTIMIZATION.
 			// Replace some multiplication and division with bitwise shifting to optimize the code.
 			Token::Ptr newnum = nullptr;
@@ -9063,6 +9406,8 @@ public:
 
 					// Emit the right hand value.
 					Token::Ptr simpleTk = onlyTokenInOnlyChild();
+					Int16 constant = 0;
+					int folded = 0;
 					if (simpleTk && simpleTk->is(Token::Types::BOOLEAN)) { // Const.
 						Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::SET_CONST]);
 						args = fill(args, (Int16)BOOLEAN(simpleTk->data()));
@@ -9093,6 +9438,11 @@ public:
 								THROW_ID_HAS_NOT_BEEN_DECLARED(onError, simpleTk);
 							}
 						}
+					} else if (constantChild(context, constant, &folded)) { // Folded const.
+						Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::SET_CONST]);
+						args = fill(args, (Int16)constant);
+						args = fill(args, (Int16)ref);
+						ctx.optimization.save(ctx.currentPage, folded + (std::numeric_limits<signed char>::min() <= constant && constant <= std::numeric_limits<signed char>::max() ? 6 : 7)); // `VM_RPN` sequence, `VM_SET` and `VM_POP` versus `VM_SET_CONST`.
 					} else { // EXPR.
 						VAR_GUARD(ctx.expect.lnno, false);
 						VAR_GUARD(ctx.declaration.declaring, ref);
@@ -9193,6 +9543,16 @@ public:
 
 		write(bytes, context, generator, false, onError);
 	}
+
+private:
+	bool constantChild(Context::Stack &context, Int16 &val, int* folded) const {
+		if (_children.size() != 1 || _children.front()->type() != Types::EXPRESSION)
+			return false;
+
+		const NodeExpression* expr = (const NodeExpression*)_children.front().get();
+
+		return expr->constant(context, val, folded);
+	}
 };
 
 class NodeConst : public NodeDecl {
@@ -9361,6 +9721,7 @@ public:
 class NodeIf : public Node {
 private:
 	bool _singleLine = false;
+	Addresses _exits; // The offsets of the `GOTO (b)` arguments.
 
 public:
 	NodeIf() {
@@ -9404,7 +9765,7 @@ public:
 			COUNTER_GUARD(ctx, stk);
 
 			// Emit the conditions and statements.
-			Addresses endOfChunk;
+			_exits.clear();
 			for (int i = 0; i < (int)_children.size(); i += 2) {
 				// Prepare.
 				int j = i;
@@ -9439,21 +9800,22 @@ public:
 				}
 
 				// Emit the statements of the conditional body.
+				const Ptr &stmt = _children[j++];
 				if (_singleLine) {
 					VAR_GUARD(ctx.expect.lnno, false);
 
-					const Ptr &stmt = _children[j++];
 					stmt->generate(bytes, context, onError);
 				} else {
-					const Ptr &stmt = _children[j++];
 					stmt->generate(bytes, context, onError);
 				}
 
 				// `GOTO (b)`.
-				// Emit a `VM_JUMP` instruction.
-				Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::JUMP]);
-				const intptr_t offset1 = prefill<UInt16>(bytes, args);
-				endOfChunk.push_back(offset1);
+				if (jumpsToEnd(context, stmt, i + 2 >= (int)_children.size(), _exits)) {
+					// Emit a `VM_JUMP` instruction.
+					Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::JUMP]);
+					const intptr_t offset1 = prefill<UInt16>(bytes, args);
+					_exits.push_back(offset1);
+				}
 
 				// (a).
 				const int addressA = ctx.startAddress + ctx.addressCursor;
@@ -9465,7 +9827,7 @@ public:
 			// (b).
 			const int addressB = ctx.startAddress + ctx.addressCursor;
 			// Fill in the addresses.
-			for (intptr_t addr : endOfChunk)
+			for (intptr_t addr : _exits)
 				fill(bytes, addr, (UInt16)addressB);
 
 			// Check the stack footprint.
@@ -9484,6 +9846,36 @@ public:
 		return dump(depth, "IF");
 	}
 	using Node::dump;
+	const Addresses &exits(void) const {
+		return _exits;
+	}
+
+	/**
+	 * @brief Shared by `IF` and `SELECT` to decide whether a branch needs its
+	 *   `GOTO (b)`.
+	 */
+	static bool jumpsToEnd(Context::Stack &context, const Ptr &stmt, bool isLast, Addresses &exits) {
+		// FEAT: OPTIMIZATION.
+		// The `GOTO (b)` is redundant if it targets the next instruction, or if it
+		// follows an unconditional jump; the exits of a trailing nested `IF` are
+		// threaded to `(b)` directly.
+		Context &ctx = context.top();
+
+		if (!ctx.expression.optimize)
+			return true;
+
+		if (isLast || stmt->lastChildIs(Types::GOTO) || stmt->lastChildIs(Types::RETURN)) {
+			ctx.optimization.save(ctx.currentPage, 1 + sizeof(UInt16)); // `VM_JUMP`.
+
+			return false;
+		}
+		if (stmt->lastChildIs(Types::IF)) {
+			const NodeIf* nested = (const NodeIf*)stmt->allChildren().back().get();
+			exits.insert(exits.end(), nested->exits().begin(), nested->exits().end());
+		}
+
+		return true;
+	}
 };
 
 class NodeThen : public Node {
@@ -9635,6 +10027,9 @@ public:
 };
 
 class NodeSelect : public Node {
+private:
+	Addresses _exits; // The offsets of the `GOTO (b)` arguments.
+
 public:
 	NodeSelect() {
 	}
@@ -9692,7 +10087,7 @@ public:
 			}
 
 			// Emit the conditions and statements.
-			Addresses endOfChunk;
+			_exits.clear();
 			for (int i = 0; i < (int)_children.size(); i += 2) {
 				// Prepare.
 				int j = i;
@@ -9731,10 +10126,12 @@ public:
 				stmt->generate(bytes, context, onError);
 
 				// `GOTO (b)`.
-				// Emit a `VM_JUMP` instruction.
-				Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::JUMP]);
-				const intptr_t offset1 = prefill<UInt16>(bytes, args);
-				endOfChunk.push_back(offset1);
+				if (NodeIf::jumpsToEnd(context, stmt, i + 2 >= (int)_children.size(), _exits)) {
+					// Emit a `VM_JUMP` instruction.
+					Byte* args = emit(bytes, context, INSTRUCTIONS[(size_t)Asm::Types::JUMP]);
+					const intptr_t offset1 = prefill<UInt16>(bytes, args);
+					_exits.push_back(offset1);
+				}
 
 				// (a).
 				const int addressA = ctx.startAddress + ctx.addressCursor;
@@ -9746,7 +10143,7 @@ public:
 			// (b).
 			const int addressB = ctx.startAddress + ctx.addressCursor;
 			// Fill in the addresses.
-			for (intptr_t addr : endOfChunk)
+			for (intptr_t addr : _exits)
 				fill(bytes, addr, (UInt16)addressB);
 
 			// Check the stack footprint.
@@ -16439,14 +16836,12 @@ public:
 					if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 					if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 					const int bank = locations.front().bank;
-					const int address = locations.front().address;
-					const int size = locations.front().size;
-					const int offset = scheduled.target.sub * 8 * 2;
-					if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+					int address = 0;
+					if (!locations.front().tileAddress(scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 					Byte* args = scheduled.args(bytes->pointer());
 					args = fill(args, (UInt8)bank);
-					args = fill(args, (UInt16)(address + offset));
+					args = fill(args, (UInt16)address);
 				}
 			}
 
@@ -16462,14 +16857,12 @@ public:
 				if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, scheduled0.target.page, locations0)) { THROW_INVALID_ASSET_POINT(onError); }
 				if (locations0.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 				const int bank0 = locations0.front().bank;
-				const int address0 = locations0.front().address;
-				const int size0 = locations0.front().size;
-				const int offset0 = scheduled0.target.sub * 8 * 2;
-				if (offset0 >= size0) { THROW_INVALID_ASSET_POINT(onError); }
+				int address0 = 0;
+				if (!locations0.front().tileAddress(scheduled0.target.sub, address0)) { THROW_INVALID_ASSET_POINT(onError); }
 
 				Byte* args = scheduled0.args(bytes->pointer());
 				args = fill(args, (UInt8)bank0);
-				args = fill(args, (UInt16)(address0 + offset0));
+				args = fill(args, (UInt16)address0);
 
 				// Process the attributes.
 				if (_scheduled.size() == 3) {
@@ -16788,14 +17181,12 @@ public:
 		if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, _scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 		if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 		const int bank = locations.front().bank;
-		const int address = locations.front().address;
-		const int size = locations.front().size;
-		const int offset = _scheduled.target.sub * 8 * 2;
-		if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+		int address = 0;
+		if (!locations.front().tileAddress(_scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 		Byte* args = _scheduled.args(bytes->pointer());
 		args = fill(args, (UInt8)bank);
-		args = fill(args, (UInt16)(address + offset));
+		args = fill(args, (UInt16)address);
 	}
 
 	virtual Abstract abstract(void) const override {
@@ -17305,14 +17696,12 @@ public:
 				if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, _scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 				if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 				const int bank = locations.front().bank;
-				const int address = locations.front().address;
-				const int size = locations.front().size;
-				const int offset = _scheduled.target.sub * 8 * 2;
-				if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+				int address = 0;
+				if (!locations.front().tileAddress(_scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 				Byte* args = _scheduled.args(bytes->pointer());
 				args = fill(args, (UInt8)bank);
-				args = fill(args, (UInt16)(address + offset));
+				args = fill(args, (UInt16)address);
 			}
 
 			break;
@@ -17844,14 +18233,12 @@ public:
 				if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, _scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 				if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 				const int bank = locations.front().bank;
-				const int address = locations.front().address;
-				const int size = locations.front().size;
-				const int offset = _scheduled.target.sub * 8 * 2;
-				if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+				int address = 0;
+				if (!locations.front().tileAddress(_scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 				Byte* args = _scheduled.args(bytes->pointer());
 				args = fill(args, (UInt8)bank);
-				args = fill(args, (UInt16)(address + offset));
+				args = fill(args, (UInt16)address);
 			}
 
 			break;
@@ -18124,14 +18511,12 @@ public:
 		if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, _scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 		if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 		const int bank = locations.front().bank;
-		const int address = locations.front().address;
-		const int size = locations.front().size;
-		const int offset = _scheduled.target.sub * 8 * 2;
-		if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+		int address = 0;
+		if (!locations.front().tileAddress(_scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 		Byte* args = _scheduled.args(bytes->pointer());
 		args = fill(args, (UInt8)bank);
-		args = fill(args, (UInt16)(address + offset));
+		args = fill(args, (UInt16)address);
 	}
 
 	virtual Abstract abstract(void) const override {
@@ -19313,6 +19698,7 @@ public:
 
 						if (!ctx.pipeline) { THROW_INVALID_ASSET_POINT(onError); }
 						if (!ctx.pipeline->touch(ctx.assets, AssetsBundle::Categories::TILES, page, true)) { THROW_INVALID_ASSET_POINT(onError); }
+						if (!ctx.pipeline->pin(AssetsBundle::Categories::TILES, page)) { THROW_INVALID_ASSET_POINT(onError); } // Copies the raw bytes.
 
 						int len = 0;
 						if (argn == 1) {
@@ -20953,9 +21339,10 @@ public:
 				Pipeline::Resource::Array tilesLocations;
 				if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, tilesIndex, tilesLocations)) { THROW_INVALID_ASSET_POINT(onError); }
 				if (tilesLocations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
-				const int tilesCount = tilesLocations.back().size / 16;
+				const int tilesCount = tilesLocations.back().tileCount();
 				const int tilesBank = tilesLocations.back().bank;
-				const int tilesAddress = tilesLocations.back().address;
+				int tilesAddress = tilesLocations.back().address;
+				if (tilesCount > 0 && !tilesLocations.back().tileAddress(0, tilesAddress)) { THROW_INVALID_ASSET_POINT(onError); }
 
 				bool is8x16Sprite = false;
 				if (sceneEntry->data->hasActors()) {
@@ -22677,14 +23064,12 @@ public:
 		if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, _scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 		if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 		const int bank = locations.front().bank;
-		const int address = locations.front().address;
-		const int size = locations.front().size;
-		const int offset = _scheduled.target.sub * 8 * 2;
-		if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+		int address = 0;
+		if (!locations.front().tileAddress(_scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 		Byte* args = _scheduled.args(bytes->pointer());
 		args = fill(args, (UInt8)bank);
-		args = fill(args, (UInt16)(address + offset));
+		args = fill(args, (UInt16)address);
 	}
 
 	virtual Abstract abstract(void) const override {
@@ -25821,14 +26206,12 @@ public:
 					if (!ctx.pipeline->lookup(AssetsBundle::Categories::TILES, scheduled.target.page, locations)) { THROW_INVALID_ASSET_POINT(onError); }
 					if (locations.size() != 1) { THROW_INVALID_ASSET_POINT(onError); }
 					const int bank = locations.front().bank;
-					const int address = locations.front().address;
-					const int size = locations.front().size;
-					const int offset = scheduled.target.sub * 8 * 2;
-					if (offset >= size) { THROW_INVALID_ASSET_POINT(onError); }
+					int address = 0;
+					if (!locations.front().tileAddress(scheduled.target.sub, address)) { THROW_INVALID_ASSET_POINT(onError); }
 
 					Byte* args = scheduled.args(bytes->pointer());
 					args = fill(args, (UInt8)bank);
-					args = fill(args, (UInt16)(address + offset));
+					args = fill(args, (UInt16)address);
 				}
 			}
 
@@ -26920,6 +27303,51 @@ public:
 
 	typedef std::map<std::string, Variant> Macros;
 
+	/**
+	 * @brief Lexical result of a code page. It doesn't depend on any other page,
+	 *   so pages can be lexed concurrently, then parsed in order.
+	 */
+	struct Lexed {
+		typedef std::vector<Lexed> Array;
+
+		struct Diagnosis {
+			typedef std::vector<Diagnosis> Array;
+
+			Error error;
+			std::string message;
+			TextLocation location;
+
+			Diagnosis() {
+			}
+			Diagnosis(const Error &err, const std::string &msg, const TextLocation &loc) : error(err), message(msg), location(loc) {
+			}
+		};
+
+		Token::Array tokens;
+		int lines = 0;
+		int lineNumberWidth = -1; // -1 for unchanged.
+		Diagnosis::Array diagnoses; // Deferred until parsing.
+
+		Lexed() {
+		}
+
+		/**
+		 * @brief Deep copies the tokens, because parsing and compiling modify
+		 *   them in place.
+		 */
+		Lexed clone(void) const {
+			Lexed result;
+			result.tokens.reserve(tokens.size());
+			for (const Token::Ptr &tk : tokens)
+				result.tokens.push_back(tk ? tk->clone() : nullptr);
+			result.lines = lines;
+			result.lineNumberWidth = lineNumberWidth;
+			result.diagnoses = diagnoses;
+
+			return result;
+		}
+	};
+
 private:
 	struct Options {
 		GBBASIC::Options::Strategies::Compatibilities compatibility = GBBASIC::Options::Strategies::Compatibilities::CLASSIC | GBBASIC::Options::Strategies::Compatibilities::COLORED;
@@ -26933,6 +27361,24 @@ private:
 		}
 	};
 
+	/**
+	 * @brief A code line sliced in place from the source of a page, the source
+	 *   must outlive it. A completed line number is kept out of band rather than
+	 *   prepended to the text.
+	 */
+	struct Line {
+		typedef std::vector<Line> Array;
+
+		const char* text = nullptr;
+		int length = 0;
+		int lineNumber = 0; // 0 for the line doesn't need to complete line number.
+
+		Line() {
+		}
+		Line(const char* txt, int len) : text(txt), length(len) {
+		}
+	};
+
 	struct State {
 		int index = 0;
 		Token::Array tokens;
@@ -27779,6 +28225,38 @@ public:
 		Macro::List &macros,
 		const Macros &builtinMacros,
 		Error::Handler onError
+	) {
+		Lexed lexed;
+		lex(src, page, lexed);
+
+		return process(
+			lexed, page,
+			array, data, builtins, functions, operators,
+			macroAliases,
+			macroFunctions,
+			macroConstants,
+			macroIdentifierAliases,
+			macroStackReferences,
+			macros,
+			builtinMacros,
+			onError
+		);
+	}
+	bool process(
+		const Lexed &lexed, int page,
+		Node::Context::Array &array,
+		Node::Context::Data &data,
+		BuiltinTable &builtins,
+		const FunctionTable &functions,
+		const OperatorTable &operators,
+		Node::MacroAliasTable::Stack &macroAliases,
+		Node::MacroFunctionTable::Stack &macroFunctions,
+		Node::MacroConstantTable::Stack &macroConstants,
+		Node::MacroIdentifierAliasTable::Stack &macroIdentifierAliases,
+		Node::MacroStackReferenceTable::Stack &macroStackReferences,
+		Macro::List &macros,
+		const Macros &builtinMacros,
+		Error::Handler onError
 	) {
 		// Prepare.
 		_tokens.clear();
@@ -27791,14 +28269,17 @@ public:
 			onError(err, msg, loc);
 		};
 
-		// Preprocess, linearize, tokenize, sort and parse the source code.
-		const std::string code     = preprocess(src);
-		const Text::Array lines    = linearize(code, _lineNumberWidth, _options);
-		const Token::Matrix lined  = tokenize(lines, page, _statements, _options, gotError);
-		_tokens                    = sort(lined, gotError);
+		// Report the deferred lexical diagnoses.
+		for (const Lexed::Diagnosis &diag : lexed.diagnoses)
+			gotError(diag.error, diag.message, diag.location);
+		if (lexed.lineNumberWidth >= 0)
+			_lineNumberWidth = lexed.lineNumberWidth;
+
+		// Parse the sorted tokens.
+		_tokens                    = lexed.tokens;
 		_ast                       = parse(
 			                             _tokens, page,
-			                             _statements, _statementsWithReturned,
+			                             _statements,
 			                             _stackArguments,
 			                             array, data,
 			                             builtins, functions, operators,
@@ -27812,41 +28293,61 @@ public:
 			                             _options,
 			                             gotError
 			                         );
-		_linesOfCode              += (int)lines.size();
+		_linesOfCode              += lexed.lines;
 
 		// Finish.
 		return errorCount == 0;
 	}
+	/**
+	 * @brief Preprocesses, linearizes, tokenizes and sorts the source code of a
+	 *   page. Only reads the statements and options, so it's safe to call from
+	 *   multiple threads after `initialize(...)`.
+	 */
+	void lex(const std::string &src, int page, Lexed &lexed) const {
+		// Prepare.
+		Error::Handler gotError = [&lexed] (const Error &err, const std::string &msg, const TextLocation &loc) -> void {
+			lexed.diagnoses.push_back(Lexed::Diagnosis(err, msg, loc));
+		};
+
+		// Preprocess, linearize, tokenize and sort the source code.
+		Line::Array lines          = preprocess(src); // Slices of `src`.
+		linearize(lines, lexed.lineNumberWidth, _options);
+		Token::Matrix lined        = tokenize(lines, page, _statements, _options, gotError);
+		lexed.tokens               = sort(lined, gotError);
+		lexed.lines                = (int)lines.size();
+	}
 
 private:
-	static std::string preprocess(const std::string &src) {
+	static Line::Array preprocess(const std::string &src) {
 		// Prepare.
-		std::string result = src;
+		Line::Array result;
+		const char* txt = src.c_str();
+		const int len = (int)src.length();
+
+		// Slice the source code into code lines in a single pass without copying,
+		// accepts "\r\n", '\r' and '\n' as new line.
+		int begin = 0;
+		for (int i = 0; i < len; ++i) {
+			if (txt[i] != '\r' && txt[i] != '\n')
+				continue;
 
-		// Uniform new line characters to '\n'.
-		result = Text::replace(result, "\r\n", "\n");
-		result = Text::replace(result, "\r", "\n");
+			result.push_back(Line(txt + begin, i - begin));
+			if (txt[i] == '\r' && i + 1 < len && txt[i + 1] == '\n')
+				++i;
+			begin = i + 1;
+		}
+		result.push_back(Line(txt + begin, len - begin)); // The last line, might be blank.
 
 		// Finish.
 		return result;
 	}
-	static Text::Array linearize(const std::string &src, int &lineNumberWidth, const Options &options) {
-		// Prepare.
-		Text::Array result;
-
-		// Split the source code into code lines.
-		const Text::Array lines = Text::split(src, "\n", false);
-
+	static void linearize(Line::Array &lines, int &lineNumberWidth, const Options &options) {
 		bool completeLineNumber = options.completeLineNumber;
 		if (completeLineNumber) {
 			int lineNumberCount = 0;
 			for (int i = 0; i < (int)lines.size(); ++i) {
-				const std::string &ln = lines[i];
-				const Text::Array parts = Text::split(ln, " ", false);
-				if (parts.empty())
-					continue;
-
-				const std::string &head = parts.front();
+				const Line &ln = lines[i];
+				const std::string head(ln.text, std::find(ln.text, ln.text + ln.length, ' ')); // Only the leading part matters.
 				int lno = 0;
 				if (Text::fromString(head, lno)) {
 					++lineNumberCount;
@@ -27860,20 +28361,11 @@ private:
 
 		if (completeLineNumber) {
 			lineNumberWidth = 2 + 8 + 1;
-			for (int i = 0; i < (int)lines.size(); ++i) {
-				std::string ln = lines[i];
-				ln = "0x" + Text::toHex(i + 1) + " " + ln;
-				result.push_back(ln);
-			}
-		} else {
-			for (const std::string &ln : lines)
-				result.push_back(ln);
+			for (int i = 0; i < (int)lines.size(); ++i)
+				lines[i].lineNumber = i + 1; // Tokenized as "0x???????? " in front of the line.
 		}
-
-		// Finish.
-		return result;
 	}
-	static Token::Matrix tokenize(const Text::Array &lines, int page, const StatementDictionary &functions, const Options &options, Error::Handler onError) {
+	static Token::Matrix tokenize(const Line::Array &lines, int page, const StatementDictionary &functions, const Options &options, Error::Handler onError) {
 		// Prepare.
 		enum class States {
 			NORMAL,
@@ -27900,9 +28392,19 @@ private:
 		const Text::Array NUMBER_EXPONENT   = { "e", "E" };
 		const Text::Array NUMBER            = { "0123456789", "0123456789+-.eExXabcdefABCDEF" };
 		const std::string DOUBLE_QUOTE      = "\"";
-		Text::Array SYMBOLS;
-		for (const StatementDictionary::value_type &kv : functions)
-			SYMBOLS.push_back(kv.first);
+
+		// The patterns are made once here rather than per character.
+		const EitherStringOrArray COMMENT_REM_PATTERN     = Left<std::string>(COMMENT_REM);
+		const EitherStringOrArray SPACE_PATTERN           = Left<std::string>(SPACE);
+		const EitherStringOrArray PAGE_NUMBER_PATTERN     = Left<std::string>(PAGE_NUMBER);
+		const EitherStringOrArray OPERATOR_PATTERN        = Left<std::string>(OPERATOR);
+		const EitherStringOrArray POSITIVE_PATTERN        = Left<std::string>(std::string("+"));
+		const EitherStringOrArray NEGATIVE_PATTERN        = Left<std::string>(std::string("-"));
+		const EitherStringOrArray NUMBER_EXPONENT_PATTERN = Right<Text::Array>(NUMBER_EXPONENT);
+		const EitherStringOrArray NUMBER_PATTERNS[]       = { Left<std::string>(NUMBER[0]), Left<std::string>(NUMBER[1]) };
+
+		// Unicode symbols.
+		static const Codepoint::Collection UNICODE_SYMBOLS = Codepoint::UNICODE_SYMBOLS(); // Constant, built only once.
 
 		Token::Matrix result;
 		TextLocation location(page);
@@ -28010,7 +28512,7 @@ private:
 				prev = result.back().back();
 
 			// Create a new token.
-			node = Token::Ptr(new Token());
+			node = std::make_shared<Token>(); // Allocates the token and its reference counter together.
 			node
 				->type(y)
 				->begin(TextLocation(location));
@@ -28038,19 +28540,28 @@ private:
 			return node;
 		};
 
+		// Completes a line number, the same as tokenizing a "0x???????? " prefix.
+		auto lineNumber = [&] (int lno) -> void {
+			token(Token::Types::NUMBER);
+			node->add("0x" + Text::toHex(lno));
+			location.column += 2 + 8;
+			seal();
+			++location.column;
+		};
+
 		// Tokenizes one line.
-		auto tokenizeLine = [&] (const std::string &ln) -> void {
+		auto tokenizeLine = [&] (const Line &ln) -> void {
 			// Prepare.
 			int cursor = 0;
 
 			// Traverse source code.
-			typedef std::function<int(const std::string &, const std::string &, int, bool)> Traverser;
+			typedef std::function<int(const Line &, const std::string &, int, bool)> Traverser;
 			auto next = [&] (int n) -> void {
 				// Move the text cursor to the next location.
 				location.column += n;
 				cursor += n;
 			};
-			auto anyway = [&] (const std::string &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive, Traverser match) -> bool {
+			auto anyway = [&] (const Line &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive, Traverser match) -> bool {
 				// Check whether the former or latter text matches the specific pattern.
 				if (what.isLeft())
 					return !!match(txt, what.left().get(), offset, caseInsensitive);
@@ -28062,16 +28573,16 @@ private:
 
 				return false;
 			};
-			auto forward = [&] (const std::string &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive) -> int {
+			auto forward = [&] (const Line &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive) -> int {
 				// Check whether the latter text matches the specific pattern.
 				return anyway(
 					txt, what, offset, caseInsensitive,
-					[] (const std::string &txt, const std::string &what, int offset, bool caseInsensitive) -> int {
-						if (offset < 0 || offset + (int)what.length() > (int)txt.length())
+					[] (const Line &txt, const std::string &what, int offset, bool caseInsensitive) -> int {
+						if (offset < 0 || offset + (int)what.length() > txt.length)
 							return 0;
 						for (int i = 0; i < (int)what.length(); ++i) {
 							const char left = what[i];
-							const char right = txt[offset + i];
+							const char right = txt.text[offset + i];
 							if (caseInsensitive) {
 								if (tolower(left) != tolower(right))
 									return 0;
@@ -28085,16 +28596,16 @@ private:
 					}
 				);
 			};
-			auto backward = [&] (const std::string &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive) -> int {
+			auto backward = [&] (const Line &txt, const EitherStringOrArray &what, int offset, bool caseInsensitive) -> int {
 				// Check whether the former text matches the specific pattern.
 				return anyway(
 					txt, what, offset, caseInsensitive,
-					[] (const std::string &txt, const std::string &what, int offset, bool caseInsensitive) -> int {
+					[] (const Line &txt, const std::string &what, int offset, bool caseInsensitive) -> int {
 						if (offset < 0 || offset + 1 - (int)what.length() < 0)
 							return 0;
 						for (int i = 0; i < (int)what.length(); ++i) {
 							const char left = what[i];
-							const char right = txt[offset + 1 - (int)what.length() + i];
+							const char right = txt.text[offset + 1 - (int)what.length() + i];
 							if (caseInsensitive) {
 								if (tolower(left) != tolower(right))
 									return 0;
@@ -28112,11 +28623,12 @@ private:
 			// Generic matching.
 			auto contains = [] (const EitherStringOrArray &pattern, const std::string &what) -> bool {
 				if (pattern.isLeft())
-					return Text::indexOf(pattern.left().get(), what) != std::string::npos;
+					return Text::indexOf(pattern.left().ref(), what) != std::string::npos;
 
-				const Text::Array patterns = pattern.right().get();
+				const Maybe<Text::Array> patterns = pattern.right();
+				const Text::Array &patterns_ = patterns.ref();
 
-				return std::find(patterns.begin(), patterns.end(), what) != patterns.end();
+				return std::find(patterns_.begin(), patterns_.end(), what) != patterns_.end();
 			};
 
 			// Character calculation and operation.
@@ -28142,15 +28654,27 @@ private:
 				return false;
 			};
 
-			// Unicode symbols.
-			const Codepoint::Collection UNICODE_SYMBOLS = Codepoint::UNICODE_SYMBOLS();
+			// Character access, reads as if the line were a zero terminated string.
+			auto at = [&ln] (int idx) -> char {
+				return idx < ln.length ? ln.text[idx] : '\0';
+			};
+			auto expect = [&ln, at] (int idx) -> int {
+				if (idx + 4 <= ln.length)
+					return Unicode::expectUtf8(ln.text + idx);
+
+				char tail[4 + 1] = { '\0' }; // A UTF-8 character takes up to 4 bytes.
+				for (int i = 0; i < 4; ++i)
+					tail[i] = at(idx + i);
+
+				return Unicode::expectUtf8(tail);
+			};
 
 			// Traverse through all the characters.
-			while (cursor < (int)ln.length()) {
+			while (cursor < ln.length) {
 				// Take a character.
-				int n = Unicode::expectUtf8(ln.c_str() + cursor);
+				int n = expect(cursor);
 				if (n == 0) {
-					const char ch = ln[cursor];
+					const char ch = ln.text[cursor];
 					const Error err("Invalid character \"{0}\"", false);
 					onError(err, err.format({ Text::toString(ch) }), location);
 
@@ -28158,16 +28682,16 @@ private:
 				}
 				std::string ch;
 				for (int i = 0; i < n; ++i)
-					ch += ln[cursor + i];
+					ch += at(cursor + i);
 				std::string chlow = ch;
 				Text::toLowerCase(chlow);
 
-				const int n1 = Unicode::expectUtf8(ln.c_str() + cursor + n);
+				const int n1 = expect(cursor + n);
 				std::string ch1;
 				std::string chlow1;
 				if (n1 > 0) {
 					for (int i = 0; i < n1; ++i)
-						ch1 += ln[cursor + n + i];
+						ch1 += at(cursor + n + i);
 					chlow1 = ch1;
 					Text::toLowerCase(chlow1);
 				}
@@ -28185,7 +28709,7 @@ private:
 						state = States::COMMENT;
 
 						token(Token::Types::COMMENT);
-					} else if (Text::startsWith(COMMENT_REM, chlow, options.caseInsensitive) && forward(ln, EitherStringOrArray(Left<std::string>(COMMENT_REM)), cursor, options.caseInsensitive)) {
+					} else if (Text::startsWith(COMMENT_REM, chlow, options.caseInsensitive) && forward(ln, COMMENT_REM_PATTERN, cursor, options.caseInsensitive)) {
 						// Met `REM` comment; transport to comment state.
 						state = States::COMMENT;
 
@@ -28206,7 +28730,7 @@ private:
 					} else {
 						// Determine the character's ascribing.
 						Token::Types met = Token::Types::NONE;
-						if (contains(EitherStringOrArray(Left<std::string>(SPACE)), ch)) {
+						if (contains(SPACE_PATTERN, ch)) {
 							// Met space.
 							if (isNot(Token::Types::SPACE)) {
 								seal();
@@ -28220,7 +28744,7 @@ private:
 							node->add(ch);
 
 							met = Token::Types::PAGE;
-						} else if (is(Token::Types::PAGE) && contains(EitherStringOrArray(Left<std::string>(PAGE_NUMBER)), ch)) {
+						} else if (is(Token::Types::PAGE) && contains(PAGE_NUMBER_PATTERN, ch)) {
 							// Met page number.
 							node->add(ch);
 
@@ -28231,8 +28755,8 @@ private:
 						} else if (
 							isNot(Token::Types::NUMBER) &&
 							(
-								backward(ln, EitherStringOrArray(Left<std::string>(std::string("+"))), cursor - 1, false) ||
-								backward(ln, EitherStringOrArray(Left<std::string>(std::string("-"))), cursor - 1, false)
+								backward(ln, POSITIVE_PATTERN, cursor - 1, false) ||
+								backward(ln, NEGATIVE_PATTERN, cursor - 1, false)
 							) &&
 							!(prev && (
 								(prev->is(Token::Types::OPERATOR) && prev->data() == ")") ||
@@ -28247,7 +28771,7 @@ private:
 							met = Token::Types::NUMBER;
 						} else if (
 							isNot(Token::Types::NUMBER) &&
-							contains(EitherStringOrArray(Left<std::string>(NUMBER[0])), ch)
+							contains(NUMBER_PATTERNS[0], ch)
 						) {
 							// Met number; start a number.
 							token(Token::Types::NUMBER);
@@ -28257,12 +28781,12 @@ private:
 							met = Token::Types::NUMBER;
 						} else if (
 							is(Token::Types::NUMBER) &&
-							contains(EitherStringOrArray(Left<std::string>(NUMBER[1])), ch)
+							contains(NUMBER_PATTERNS[1], ch)
 						) {
 							// Met number; the current character is a part of the current number token.
 							if (
 								(ch == "+" || ch == "-") &&
-								!backward(ln, EitherStringOrArray(Right<Text::Array>(NUMBER_EXPONENT)), cursor - 1, false)
+								!backward(ln, NUMBER_EXPONENT_PATTERN, cursor - 1, false)
 							) {
 								// Do nothing.
 							} else if (ch == "." && has(".")) {
@@ -28278,7 +28802,7 @@ private:
 						if (GBBASIC::is(met, Token::Types::ANY)) {
 							// Already handled above.
 							// Do nothing.
-						} else if (contains(EitherStringOrArray(Left<std::string>(OPERATOR)), ch)) {
+						} else if (contains(OPERATOR_PATTERN, ch)) {
 							// Met operator.
 							if (is(Token::Types::SYMBOL) && ch == ":") {
 								// Met `:`; the token should be a destination label.
@@ -28295,7 +28819,7 @@ private:
 
 									node->add(ch);
 								} else {
-									if (!contains(EitherStringOrArray(Right<Text::Array>(OPERATORS)), node->text() + ch)) {
+									if (std::find(OPERATORS.begin(), OPERATORS.end(), node->text() + ch) == OPERATORS.end()) {
 										token(Token::Types::OPERATOR);
 									}
 
@@ -28306,7 +28830,7 @@ private:
 							}
 						} else if (isSymbolic(ch)) {
 							// Met symbol.
-							if (isNot(Token::Types::SYMBOL) && !contains(EitherStringOrArray(Left<std::string>(NUMBER[0])), ch)) {
+							if (isNot(Token::Types::SYMBOL) && !contains(NUMBER_PATTERNS[0], ch)) {
 								token(Token::Types::SYMBOL);
 
 								node->add(ch);
@@ -28386,7 +28910,9 @@ private:
 		};
 
 		// Tokenizes all the lines.
-		for (const std::string &ln : lines) {
+		for (const Line &ln : lines) {
+			if (ln.lineNumber > 0)
+				lineNumber(ln.lineNumber);
 			tokenizeLine(ln);
 
 			if (state != States::NORMAL) {
@@ -28415,7 +28941,7 @@ private:
 
 		return result;
 	}
-	static Token::Array sort(const Token::Matrix &lined, Error::Handler onError) {
+	static Token::Array sort(Token::Matrix &lined, Error::Handler onError) {
 		// Prepare.
 		typedef std::map<int, int> OrderedByLineNumber;
 
@@ -28454,11 +28980,16 @@ private:
 			}
 		}
 
-		// Construct the ordered tokens.
+		// Construct the ordered tokens, move them rather than copy as the lined
+		// tokens are discarded after sorting.
+		size_t count = 0;
+		for (const Token::Array &line : lined)
+			count += line.size();
+		result.reserve(count);
 		for (const OrderedByLineNumber::value_type &kv : ordered) {
-			const Token::Array &line = lined[kv.second];
-			for (const Token::Ptr &tk : line)
-				result.push_back(tk);
+			Token::Array &line = lined[kv.second];
+			for (Token::Ptr &tk : line)
+				result.push_back(std::move(tk));
 		}
 
 		// Finish.
@@ -28466,7 +28997,7 @@ private:
 	}
 	static Node::Ptr parse(
 		const Token::Array &tokens, int page,
-		const StatementDictionary &statements, const Text::Array &returned,
+		const StatementDictionary &statements,
 		const Text::Array &stackArguments,
 		Node::Context::Array &array,
 		Node::Context::Data &data,
@@ -30370,8 +30901,8 @@ private:
 							continue;
 						}
 					}
-					Text::Array::const_iterator it = std::find(returned.begin(), returned.end(), name);
-					if (it != returned.end()) { // Statement with return value.
+					StatementDictionary::const_iterator it = statements.find(name); // Keyed lookup instead of scanning all the returning statements.
+					if (it != statements.end() && it->second.withReturned) { // Statement with return value.
 						const int qi = q.index;
 						if (Invoking(q, children, false)) {
 							Intermedia(q, children, Token::Types::STATEMENT);
@@ -35840,7 +36371,7 @@ public:
 		return _bytes;
 	}
 
-	bool process(const Node::Ptr &ast, AssetsBundle::Ptr assets, Pipeline::Ptr pipeline, RamLocation::Dictionary* allocations, int* compiledSize, Error::Handler onError) {
+	bool process(const Node::Ptr &ast, AssetsBundle::Ptr assets, Pipeline::Ptr pipeline, RamLocation::Dictionary* allocations, LineLocation::Array* lines, int* compiledSize, Node::Context::Optimization::Savings* optimizedSizes, Error::Handler onError) {
 		// Prepare.
 		_bytes = nullptr;
 		if (!ast)
@@ -35870,7 +36401,9 @@ public:
 			_assets,
 			pipeline,
 			allocations,
+			lines,
 			compiledSize,
+			optimizedSizes,
 			gotError
 		);
 
@@ -35905,7 +36438,9 @@ private:
 		AssetsBundle::Ptr assets,
 		Pipeline::Ptr pipeline,
 		RamLocation::Dictionary* allocations,
+		LineLocation::Array* lines,
 		int* compiledSize,
+		Node::Context::Optimization::Savings* optimizedSizes,
 		Error::Handler onError
 	) {
 		// Prepare.
@@ -36008,6 +36543,8 @@ private:
 
 		// Finish.
 		*allocations = context.top().allocations();
+		*lines = context.top().lines(context.top().startAddress);
+		*optimizedSizes = context.top().optimization.saved;
 
 		return bytes;
 	}
@@ -36485,6 +37022,177 @@ private:
 
 /* ===========================================================================} */
 
+/*
+** {===========================================================================
+** Compiling cache
+*/
+
+namespace GBBASIC {
+
+/**
+ * @brief Keeps the lexical results of the code pages across compilings, so that
+ *   the unchanged pages are not lexed again. The parsing and code generation
+ *   depend on the former pages and on the final addresses, so they always run.
+ */
+class LexingCache final {
+private:
+	struct Entry {
+		std::string code;
+		int page = 0;
+		size_t strategies = 0;
+		Parser::Lexed lexed;
+		unsigned long long tick = 0;
+
+		Entry() {
+		}
+	};
+	typedef std::map<size_t, Entry> Entries;
+
+private:
+	Mutex _lock;
+	Entries _entries;
+	unsigned long long _tick = 0;
+	int _hits = 0;
+	int _misses = 0;
+
+public:
+	static LexingCache &instance(void) {
+		static LexingCache self;
+
+		return self;
+	}
+
+	/**
+	 * @brief Gets a copy of the cached lexical result of a code page.
+	 *
+	 * @return `true` for hit, otherwise `false`.
+	 */
+	bool get(const std::string &code, int page, size_t strategies, Parser::Lexed &lexed) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		const size_t key = Math::hash(strategies, page, code);
+		Entries::iterator it = _entries.find(key);
+		if (it == _entries.end()) {
+			++_misses;
+
+			return false;
+		}
+		Entry &entry = it->second;
+		if (entry.page != page || entry.strategies != strategies || entry.code != code) { // Hash collision.
+			++_misses;
+
+			return false;
+		}
+
+		++_hits;
+		entry.tick = ++_tick;
+		lexed = entry.lexed.clone();
+
+		return true;
+	}
+	/**
+	 * @brief Caches a copy of the lexical result of a code page, evicts the least
+	 *   recently used entry if it's full.
+	 */
+	void set(const std::string &code, int page, size_t strategies, const Parser::Lexed &lexed) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		const size_t key = Math::hash(strategies, page, code);
+		Entry &entry = _entries[key];
+		entry.code = code;
+		entry.page = page;
+		entry.strategies = strategies;
+		entry.lexed = lexed.clone();
+		entry.tick = ++_tick;
+
+		while ((int)_entries.size() > LEXING_CACHE_MAX_COUNT) {
+			Entries::iterator oldest = _entries.begin();
+			for (Entries::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+				if (it->second.tick < oldest->second.tick)
+					oldest = it;
+			}
+			_entries.erase(oldest);
+		}
+	}
+
+	CacheStatistics statistics(void) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		CacheStatistics result;
+		result.hits = _hits;
+		result.misses = _misses;
+		result.entries = (int)_entries.size();
+
+		return result;
+	}
+	void clear(void) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_entries.clear();
+		_tick = 0;
+		_hits = 0;
+		_misses = 0;
+	}
+};
+
+/**
+ * @brief Keeps the last parsed symbol table of the kernel, which rarely
+ *   changes across compilings.
+ */
+class SymbolTableCache final {
+private:
+	Mutex _lock;
+	std::string _symbols;
+	std::string _aliases;
+	SymbolTable _table;
+	bool _valid = false;
+
+public:
+	static SymbolTableCache &instance(void) {
+		static SymbolTableCache self;
+
+		return self;
+	}
+
+	/**
+	 * @brief Gets a copy of the cached symbol table parsed from the specific
+	 *   symbols and aliases.
+	 *
+	 * @return `true` for hit, otherwise `false`.
+	 */
+	bool get(const std::string &symbols, const std::string &aliases, SymbolTable &table) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		if (!_valid || _symbols != symbols || _aliases != aliases)
+			return false;
+
+		table = _table;
+
+		return true;
+	}
+	void set(const std::string &symbols, const std::string &aliases, const SymbolTable &table) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_symbols = symbols;
+		_aliases = aliases;
+		_table = table;
+		_valid = true;
+	}
+
+	void clear(void) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_symbols.clear();
+		_aliases.clear();
+		_table = SymbolTable();
+		_valid = false;
+	}
+};
+
+}
+
+/* ===========================================================================} */
+
 /*
 ** {===========================================================================
 ** Public functions
@@ -36492,6 +37200,102 @@ private:
 
 namespace GBBASIC {
 
+Sections::Sections() {
+}
+
+Sections::Sections(const char* content, size_t len) : _content(content), _length(len) {
+	index();
+}
+
+Sections::Sections(const std::string &content) : _content(content.c_str()), _length(content.length()) {
+	index();
+}
+
+const char* Sections::content(void) const {
+	return _content;
+}
+
+size_t Sections::length(void) const {
+	return _length;
+}
+
+size_t Sections::indexOf(const std::string &tag, size_t start) const {
+	// Prepare.
+	if (start > _length)
+		return std::string::npos;
+
+	// Look up the indexed tags.
+	if (indexable(tag.c_str(), tag.length())) {
+		Tags::const_iterator it = _tags.find(tag);
+		if (it == _tags.end())
+			return std::string::npos;
+
+		const Offsets &offsets = it->second;
+		Offsets::const_iterator off = std::lower_bound(offsets.begin(), offsets.end(), start);
+		if (off == offsets.end())
+			return std::string::npos;
+
+		return *off;
+	}
+
+	// Search in the content for tags that are not indexed.
+	const char* end = _content + _length;
+	const char* pos = std::search(_content + start, end, tag.begin(), tag.end());
+	if (pos == end && !tag.empty())
+		return std::string::npos;
+
+	return (size_t)(pos - _content);
+}
+
+bool Sections::retrieve(const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) const {
+	const size_t beginIndex = indexOf(sectionBegin);
+	if (beginIndex == std::string::npos)
+		return false;
+	const size_t endIndex = indexOf(sectionEnd, beginIndex + sectionBegin.length());
+	if (endIndex == std::string::npos)
+		return false;
+
+	section = substr(beginIndex + sectionBegin.length(), endIndex);
+
+	return true;
+}
+
+std::string Sections::substr(size_t begin, size_t end) const {
+	return std::string(_content + begin, _content + end);
+}
+
+void Sections::index(void) {
+	// Walk through the content once, a tag starts with '<' and ends at the next
+	// '>' without any other '<' in between.
+	const char* const last = _content + _length;
+	const char* begin = _content;
+	while ((begin = (const char*)memchr(begin, '<', last - begin)) != nullptr) {
+		const char* limit = begin + std::min(last - begin, (ptrdiff_t)SECTION_TAG_MAX_LENGTH);
+		const char* end = std::find_if(begin + 1, limit, [] (char ch) -> bool { return ch == '<' || ch == '>'; });
+		if (end == limit || *end != '>') {
+			++begin;
+
+			continue;
+		}
+
+		if (indexable(begin, end - begin + 1))
+			_tags[std::string(begin, end + 1)].push_back(begin - _content);
+		begin = end + 1;
+	}
+}
+
+bool Sections::indexable(const char* tag, size_t len) {
+	// Only the tags like "<name ...>" and "</name>" are indexed.
+	if (len < 3 || len > SECTION_TAG_MAX_LENGTH)
+		return false;
+	if (tag[0] != '<' || tag[len - 1] != '>')
+		return false;
+	if (!isalpha((unsigned char)tag[1]) && tag[1] != '/')
+		return false;
+
+	return std::find_if(tag + 1, tag + len - 1, [] (char ch) -> bool { return ch == '<' || ch == '>'; }) == tag + len - 1;
+}
+
 bool load(Program &program, Options &options) {
 	// Prepare.
 	const std::string &src              = options.input;
@@ -36650,7 +37454,7 @@ bool load(Program &program, Options &options) {
 		if (hasAssets)
 			break;
 
-		// Read the source.
+		// Read the source, or map it if it's large.
 		File::Ptr file(File::create());
 		if (!file->open(src.c_str(), Stream::READ)) {
 			onError("Cannot open the source file.", false, -1, -1, -1);
@@ -36658,8 +37462,13 @@ bool load(Program &program, Options &options) {
 
 			break;
 		}
+		FileMapping::Ptr mapping(FileMapping::create());
+		const bool mapped =
+			options.piping.mapLargeSource &&
+			file->count() >= MAPPED_SOURCE_MIN_SIZE &&
+			mapping->open(src.c_str());
 		std::string source;
-		if (!file->readString(source)) {
+		if (!mapped && !file->readString(source)) {
 			file->close();
 			onError("Failed to read the source.", false, -1, -1, -1);
 			++errors;
@@ -36668,34 +37477,37 @@ bool load(Program &program, Options &options) {
 		}
 		file->close();
 
+		// Index the sections in a single pass. Unlike searching, it doesn't need
+		// the source to be trimmed, since no tag starts or ends with space.
+		const Sections prog = mapped ? Sections(mapping->data(), mapping->size()) : Sections(source);
+
 		// Split the pages.
 		const std::string sectionBegin = COMPILER_PROGRAM_BEGIN;
 		const std::string sectionEnd = COMPILER_PROGRAM_END;
-		const size_t beginIndex = Text::indexOf(source, sectionBegin);
-		const size_t endIndex = Text::indexOf(source, sectionEnd, beginIndex + sectionBegin.length());
+		const size_t beginIndex = prog.indexOf(sectionBegin);
+		const size_t endIndex = prog.indexOf(sectionEnd, beginIndex + sectionBegin.length());
 		if (beginIndex == std::string::npos && endIndex == std::string::npos) { // Is a plain source code file.
 			program.isPlain = true;
 
 			CodeAssets code;
-			code.add(source);
+			code.add(mapped ? prog.substr(0, prog.length()) : source);
 			program.assets->code = code;
 		} else { // Is a rich project file.
 			// Prepare.
-			std::string prog = Text::trim(source);
 			int i = 0;
 			int j = 0;
 
-			auto retrieve = [&j] (const std::string &prog, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) -> bool {
-				const size_t beginIndex = Text::indexOf(prog, sectionBegin);
+			auto retrieve = [&j] (const Sections &prog, const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) -> bool {
+				const size_t beginIndex = prog.indexOf(sectionBegin);
 				if (beginIndex == std::string::npos)
 					return false;
 				++j;
-				const size_t endIndex = Text::indexOf(prog, sectionEnd, beginIndex + sectionBegin.length());
+				const size_t endIndex = prog.indexOf(sectionEnd, beginIndex + sectionBegin.length());
 				if (endIndex == std::string::npos)
 					return false;
 				--j;
 
-				section = prog.substr(beginIndex + sectionBegin.length(), endIndex - (beginIndex + sectionBegin.length()));
+				section = prog.substr(beginIndex + sectionBegin.length(), endIndex);
 
 				return true;
 			};
@@ -36823,6 +37635,8 @@ bool compile(Program &program, const Options &options) {
 	const bool failOnError                                                     = strategies.failOnError;
 	const bool optimizeCode                                                    = strategies.optimizeCode;
 	const bool optimizeAssets                                                  = strategies.optimizeAssets;
+	const Pipeline::Allocators assetsAllocator                                 = strategies.assetsAllocator;
+	const bool compressTiles_                                                  = strategies.compressTiles;
 	const Options::Piping &piping                                              = options.piping;
 	const Options::PrintHandler onPrint                                        = options.onPrint;
 	const Options::ErrorHandler onError_                                       = options.onError;
@@ -36848,18 +37662,25 @@ bool compile(Program &program, const Options &options) {
 		if (program.symbols.empty())
 			break;
 
-		// Parse the symbols.
-		if (!symbols.parseSymbols(program.symbols)) {
-			onError_("Failed to parse the symbols.", true, -1, -1, -1);
+		// Reuse the cached symbols.
+		const bool cached = piping.useCache && SymbolTableCache::instance().get(program.symbols, program.aliases, symbols);
+		if (!cached) {
+			// Parse the symbols.
+			if (!symbols.parseSymbols(program.symbols)) {
+				onError_("Failed to parse the symbols.", true, -1, -1, -1);
 
-			break;
-		}
+				break;
+			}
 
-		// Parse the aliases.
-		if (!symbols.parseAliases(program.aliases)) {
-			onError_("Failed to parse the aliases.", true, -1, -1, -1);
+			// Parse the aliases.
+			if (!symbols.parseAliases(program.aliases)) {
+				onError_("Failed to parse the aliases.", true, -1, -1, -1);
 
-			break;
+				break;
+			}
+
+			if (piping.useCache)
+				SymbolTableCache::instance().set(program.symbols, program.aliases, symbols);
 		}
 
 		// Get the entry address.
@@ -36872,6 +37693,14 @@ bool compile(Program &program, const Options &options) {
 		onPrint("Succeeded to parse the symbols.");
 	} while (false);
 
+	// Compress tiles only if the kernel can unpack them.
+	bool compressTiles = compressTiles_;
+	if (compressTiles && !symbols.find(TILES_UNPACKER_ENTRY_NAME)) {
+		onError_("The kernel cannot unpack compressed tiles, storing them raw. Rebuild the kernel to compress tiles.", true, -1, -1, -1);
+
+		compressTiles = false;
+	}
+
 	// Prepare the processors.
 	Error::Handler onError = [onError_] (const Error &err, const std::string &msg, const TextLocation &loc) -> void {
 		onError_(msg, err.isWarning, loc.page, loc.row, loc.column);
@@ -36921,12 +37750,16 @@ bool compile(Program &program, const Options &options) {
 
 	parser.initialize(compiler.builtins(), compiler.functions(), compiler.operators());
 	parser.linesOfCode(0);
+	const size_t cacheStrategies = Math::hash(0, (unsigned)compatibility, caseInsensitive, completeLineNumber, indexBase); // The parser options, which are part of the cache key.
 
 	Pipeline::Ptr pipeline(Pipeline::create(piping.useWorkQueue, piping.lessConsoleOutput));
 	pipeline->open();
 	pipeline->isPlayerBehaviour(isPlayerBehaviour);
 	pipeline->onPrint(onPipelinePrint);
 	pipeline->onError(onPipelineError);
+	pipeline->cacheDirectory(piping.buildCacheDirectory);
+	pipeline->allocator(assetsAllocator);
+	pipeline->compressTiles(compressTiles);
 
 	// Define builtin macros.
 	const bool colored = (compatibility & GBBASIC::Options::Strategies::Compatibilities::COLORED) != GBBASIC::Options::Strategies::Compatibilities::NONE;
@@ -36947,14 +37780,83 @@ bool compile(Program &program, const Options &options) {
 		Organizer::Nodes asts;
 		int parsingErrors = 0;
 
+		// Reuse the cached lexical results of the unchanged pages.
+		Parser::Lexed::Array lexed;
+		std::vector<bool> cached;
+		if (piping.useCache) {
+			lexed.resize(program.assets->code.count());
+			lexed.shrink_to_fit();
+			cached.resize(program.assets->code.count(), false);
+			for (int i = 0; i < program.assets->code.count(); ++i) {
+				std::string code;
+				CodeAssets::Entry* entry = program.assets->code.get(i);
+				entry->toString(code, nullptr);
+				cached[i] = LexingCache::instance().get(code, i, cacheStrategies, lexed[i]);
+			}
+		}
+
+		// Lex concurrently.
+		// The lexical results of the pages are independent from each other, but
+		// macros, declarations and data flow from former pages to latter ones,
+		// so the parsing still goes in page order below.
+		const bool lexConcurrently = piping.parallelParsing && program.assets->code.count() > 1;
+		if (lexConcurrently) {
+			lexed.resize(program.assets->code.count());
+			lexed.shrink_to_fit();
+
+			const int threadCount = std::min(
+				(int)std::max(std::thread::hardware_concurrency(), 1u), // Might be 0 if not computable.
+				program.assets->code.count()
+			);
+			WorkQueue* workQueue = WorkQueue::create();
+			workQueue->startup("COMPILER", threadCount);
+			for (int i = 0; i < program.assets->code.count(); ++i) {
+				if (!cached.empty() && cached[i])
+					continue;
+
+				std::string code;
+				CodeAssets::Entry* entry = program.assets->code.get(i);
+				entry->toString(code, nullptr);
+				workQueue->push(
+					WorkTaskFunction::create(
+						std::bind(
+							[&parser] (WorkTask* /* task */, const std::string &code, int page, Parser::Lexed* lexed) -> uintptr_t { // On work thread.
+								parser.lex(code, page, *lexed);
+
+								return 0;
+							},
+							std::placeholders::_1, code, i, &lexed[i]
+						),
+						[] (WorkTask* /* task */, uintptr_t) -> void { // On main thread.
+							// Do nothing.
+						},
+						[] (WorkTask* task, uintptr_t) -> void { // On main thread.
+							task->disassociated(true);
+						}
+					)
+				);
+			}
+			workQueue->await();
+			workQueue->shutdown();
+			WorkQueue::destroy(workQueue);
+		}
+
 		// Parse.
 		Macro::List macros;
 		for (int i = 0; i < program.assets->code.count(); ++i) {
 			std::string code;
 			CodeAssets::Entry* entry = program.assets->code.get(i);
 			entry->toString(code, nullptr);
+			Parser::Lexed lexed_;
+			if (lexed.empty())
+				parser.lex(code, i, lexed_); // Lex sequentially.
+			else if (!cached.empty() && !cached[i] && !lexConcurrently)
+				parser.lex(code, i, lexed[i]); // Lex the missed page sequentially.
+			const Parser::Lexed &lexedPage = lexed.empty() ? lexed_ : lexed[i];
+			if (!cached.empty() && !cached[i])
+				LexingCache::instance().set(code, i, cacheStrategies, lexedPage); // Cache before parsing modifies the tokens.
 			const bool ok = parser.process(
-				code, i,
+				lexedPage, i,
 				compiler.array(), compiler.data(), compiler.builtins(), compiler.functions(), compiler.operators(),
 				compiler.macroAliases(),
 				compiler.macroFunctions(),
@@ -37019,8 +37921,10 @@ bool compile(Program &program, const Options &options) {
 
 		// Compile.
 		RamLocation::Dictionary allocations;
+		LineLocation::Array lines;
 		int compiledSize = 0;
-		if (!compiler.process(organizer.ast(), program.assets, pipeline, &allocations, &compiledSize, onError)) {
+		Node::Context::Optimization::Savings optimizedSizes;
+		if (!compiler.process(organizer.ast(), program.assets, pipeline, &allocations, &lines, &compiledSize, &optimizedSizes, onError)) {
 			program.compiled.allocations = allocations;
 
 			onError_("Failed to compile the source code.", false, -1, -1, -1);
@@ -37031,11 +37935,15 @@ bool compile(Program &program, const Options &options) {
 		const int fontSize = pipeline->effectiveSize().font();
 		const int codeSize = compiledSize - fontSize; // Minus font size because it also counts in the `bytes`.
 		program.compiled.allocations = allocations;
+		program.compiled.lines = lines;
 		program.compiled.effectiveSize.addCode(codeSize);
 		program.compiled.effectiveSize += pipeline->effectiveSize();
 
 		onPrint("Succeeded to compile the source code.");
 
+		for (const Node::Context::Optimization::Savings::value_type &kv : optimizedSizes)
+			onPrint(Text::format("Optimized page {0}, saved {1} bytes.", { Text::toString(kv.first), Text::toString(kv.second) }));
+
 		if (passes <= Options::Passes::GENERATE)
 			return errors == 0;
 	} while (false);
@@ -37085,6 +37993,7 @@ bool compile(Program &program, const Options &options) {
 bool link(Program &program, const Options &options) {
 	// Prepare.
 	const std::string &dst              = options.output;
+	const std::string &lineMap          = options.lineMap;
 	const Options::PrintHandler onPrint = options.onPrint;
 	const Options::ErrorHandler onError = options.onError;
 
@@ -37122,6 +38031,31 @@ bool link(Program &program, const Options &options) {
 		file->close();
 	} while (false);
 
+	// Output the line map.
+	do {
+		// Prepare.
+		if (errors || lineMap.empty())
+			break;
+
+		// Serialize the line map.
+		std::string txt = "; GB BASIC line map, in the form of \"BB:AAAA SIZE PAGE:LINE\"\n";
+		for (const LineLocation &loc : program.compiled.lines) {
+			txt += Text::toHex(loc.bank, 2, '0', true) + ":" + Text::toHex(loc.address, 4, '0', true) + " ";
+			txt += Text::toString(loc.size) + " ";
+			txt += Text::toString(loc.page) + ":" + Text::toString(loc.line) + "\n";
+		}
+
+		// Write the line map.
+		File::Ptr file(File::create());
+		if (!file->open(lineMap.c_str(), Stream::WRITE)) {
+			onError("Failed to open the line map file.", true, -1, -1, -1);
+
+			break;
+		}
+		file->writeString(txt);
+		file->close();
+	} while (false);
+
 	// Output the saving state.
 	if (errors == 0) {
 		const size_t romSize = program.compiled.bytes->count();
@@ -37146,6 +38080,15 @@ bool link(Program &program, const Options &options) {
 	return errors == 0;
 }
 
+CacheStatistics cacheStatistics(void) {
+	return LexingCache::instance().statistics();
+}
+
+void clearCache(void) {
+	LexingCache::instance().clear();
+	SymbolTableCache::instance().clear();
+}
+
 void identifiers(IdentifierHandler handler) {
 	if (!handler)
 		return;
@@ -20,18 +20,27 @@
 #ifndef COMPILER_ALIASES_OPTION_KEY
 #	define COMPILER_ALIASES_OPTION_KEY "l"
 #endif /* COMPILER_ALIASES_OPTION_KEY */
+#ifndef COMPILER_ASSETS_ALLOCATOR_OPTION_KEY
+#	define COMPILER_ASSETS_ALLOCATOR_OPTION_KEY "e"
+#endif /* COMPILER_ASSETS_ALLOCATOR_OPTION_KEY */
 #ifndef COMPILER_AST_OPTION_KEY
 #	define COMPILER_AST_OPTION_KEY "a"
 #endif /* COMPILER_AST_OPTION_KEY */
 #ifndef COMPILER_BOOTSTRAP_OPTION_KEY
 #	define COMPILER_BOOTSTRAP_OPTION_KEY "b"
 #endif /* COMPILER_BOOTSTRAP_OPTION_KEY */
+#ifndef COMPILER_BUILD_CACHE_OPTION_KEY
+#	define COMPILER_BUILD_CACHE_OPTION_KEY "u"
+#endif /* COMPILER_BUILD_CACHE_OPTION_KEY */
 #ifndef COMPILER_CART_TYPE_OPTION_KEY
 #	define COMPILER_CART_TYPE_OPTION_KEY "g"
 #endif /* COMPILER_CART_TYPE_OPTION_KEY */
 #ifndef COMPILER_CASE_INSENSITIVE_OPTION_KEY
 #	define COMPILER_CASE_INSENSITIVE_OPTION_KEY "i"
 #endif /* COMPILER_CASE_INSENSITIVE_OPTION_KEY */
+#ifndef COMPILER_COMPRESS_TILES_OPTION_KEY
+#	define COMPILER_COMPRESS_TILES_OPTION_KEY "x"
+#endif /* COMPILER_COMPRESS_TILES_OPTION_KEY */
 #ifndef COMPILER_DECLARATION_REQUIRED_OPTION_KEY
 #	define COMPILER_DECLARATION_REQUIRED_OPTION_KEY "d"
 #endif /* COMPILER_DECLARATION_REQUIRED_OPTION_KEY */
@@ -47,6 +56,9 @@
 #ifndef COMPILER_INPUT_OPTION_KEY
 #	define COMPILER_INPUT_OPTION_KEY ""
 #endif /* COMPILER_INPUT_OPTION_KEY */
+#ifndef COMPILER_LINE_MAP_OPTION_KEY
+#	define COMPILER_LINE_MAP_OPTION_KEY "j"
+#endif /* COMPILER_LINE_MAP_OPTION_KEY */
 #ifndef COMPILER_OPTIMIZE_CODE_OPTION_KEY
 #	define COMPILER_OPTIMIZE_CODE_OPTION_KEY "z"
 #endif /* COMPILER_OPTIMIZE_CODE_OPTION_KEY */
@@ -263,6 +275,22 @@ struct RamLocation {
 	RamLocation(Types y, int a, int s, Usages u, const TextLocation &txtLoc);
 };
 
+/**
+ * @brief Location of the compiled code of a source line.
+ */
+struct LineLocation {
+	typedef std::vector<LineLocation> Array;
+
+	int page = 0;
+	int line = 0;
+	int bank = 0;
+	int address = 0; // Absolute address in the switchable ROM area.
+	int size = 0;
+
+	LineLocation();
+	LineLocation(int p, int l, int b, int a, int s);
+};
+
 /**
  * @brief Information of macros.
  */
@@ -554,6 +582,11 @@ struct Program {
 		 * @brief The RAM allocations on the heap.
 		 */
 		RamLocation::Dictionary allocations;
+		/**
+		 * @brief The compiled code locations of the source lines, ordered by
+		 *   page and line.
+		 */
+		LineLocation::Array lines;
 		/**
 		 * @brief The compiled ROM.
 		 */
@@ -706,6 +739,15 @@ struct Options {
 		 * @brief Whether to optimize assets.
 		 */
 		bool optimizeAssets = true;
+		/**
+		 * @brief The strategy to allocate ROM space for assets.
+		 */
+		Pipeline::Allocators assetsAllocator = Pipeline::Allocators::FIRST_FIT;
+		/**
+		 * @brief Whether to compress the tiles assets in ROM, which are unpacked
+		 *   by the VM on loading.
+		 */
+		bool compressTiles = false;
 	};
 	/**
 	 * @brief Pipeline config.
@@ -719,6 +761,28 @@ struct Options {
 		 * @brief Whether to output less to the console.
 		 */
 		bool lessConsoleOutput = false;
+		/**
+		 * @brief Whether to lex the code pages concurrently before parsing them
+		 *   in order; the output is identical to the sequential way.
+		 */
+		bool parallelParsing = false;
+		/**
+		 * @brief Whether to reuse the lexical results of the unchanged code pages
+		 *   and the parsed kernel symbols from former compilings; the output is
+		 *   identical to the uncached way.
+		 */
+		bool useCache = false;
+		/**
+		 * @brief The directory to keep the generated asset bytes across builds,
+		 *   empty to disable the build cache; the output is identical to the
+		 *   uncached way.
+		 */
+		std::string buildCacheDirectory;
+		/**
+		 * @brief Whether to memory-map a large source file rather than reading
+		 *   it, falls back to reading if mapping is not supported.
+		 */
+		bool mapLargeSource = true;
 	};
 
 	/**< Configs. */
@@ -754,6 +818,12 @@ struct Options {
 	 *   file path.
 	 */
 	std::string ast = "none";
+	/**
+	 * @brief The path of the line map output, will output to
+	 *   `program.compiled.lines` only if this field is empty; each line of the
+	 *   file is in the form of "BB:AAAA SIZE PAGE:LINE", for profiling.
+	 */
+	std::string lineMap;
 	/**
 	 * @brief The desired compiling passes to be executed.
 	 */
@@ -809,6 +879,64 @@ struct Options {
 
 IMPLEMENT_ENUM_OPERATORS(Options::Strategies::Compatibilities)
 
+/**
+ * @brief Index of the section tags (e.g. `COMPILER_CODE_BEGIN`) in a rich
+ *   project, made by walking the content once. Finding a tag is equivalent to
+ *   searching it in the content, but doesn't scan the content again. The
+ *   content must outlive the index.
+ */
+class Sections {
+private:
+	typedef std::vector<size_t> Offsets;
+	typedef std::map<std::string, Offsets> Tags;
+
+private:
+	const char* _content = nullptr;
+	size_t _length = 0;
+	Tags _tags; // "Tag" to ascending offsets.
+
+public:
+	Sections();
+	Sections(const char* content, size_t len);
+	Sections(const std::string &content);
+
+	const char* content(void) const;
+	size_t length(void) const;
+
+	/**
+	 * @brief Finds the specific tag, the same as `std::string::find(...)` on the
+	 *   content.
+	 *
+	 * @return The offset of the tag, or `std::string::npos` if not found.
+	 */
+	size_t indexOf(const std::string &tag, size_t start = 0) const;
+	/**
+	 * @brief Copies the section between the first `sectionBegin` tag and the
+	 *   first `sectionEnd` tag after it.
+	 *
+	 * @param[out] section
+	 */
+	bool retrieve(const std::string &sectionBegin, const std::string &sectionEnd, std::string &section) const;
+	/**
+	 * @brief Copies the content between the specific offsets.
+	 */
+	std::string substr(size_t begin, size_t end) const;
+
+private:
+	void index(void);
+
+	static bool indexable(const char* tag, size_t len);
+};
+
+/**
+ * @brief Statistics of the compiling cache.
+ */
+struct CacheStatistics {
+	int hits = 0;
+	int misses = 0;
+	int entries = 0;
+};
+
 /**
  * @brief Handler to traverse identifiers.
  */
@@ -827,6 +955,16 @@ bool compile(Program &program, const Options &options);
  */
 bool link(Program &program, const Options &options);
 
+/**
+ * @brief Gets the hit and miss counts of the compiling cache since the last
+ *   clearing.
+ */
+CacheStatistics cacheStatistics(void);
+/**
+ * @brief Clears the compiling cache and its counters.
+ */
+void clearCache(void);
+
 /**
  * @brief Traverses all identifiers.
  */
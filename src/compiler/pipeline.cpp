@@ -9,9 +9,41 @@
 #include "compiler.h"
 #include "pipeline.h"
 #include "../utils/datetime.h"
+#include "../utils/file_handle.h"
+#include "../utils/filesystem.h"
 #include "../utils/platform.h"
+#include "../utils/plus.h"
 #include "../utils/text.h"
 #include "../utils/work_queue.h"
+#include "../../lib/lz4/lib/xxhash.h"
+#include "../../lib/zlib/zlib.h"
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef PIPELINE_BUILD_CACHE_HEADER
+#	define PIPELINE_BUILD_CACHE_HEADER { 'G', 'B', 'B', 'C' }
+#endif /* PIPELINE_BUILD_CACHE_HEADER */
+#ifndef PIPELINE_BUILD_CACHE_FORMAT_VERSION
+#	define PIPELINE_BUILD_CACHE_FORMAT_VERSION 2
+#endif /* PIPELINE_BUILD_CACHE_FORMAT_VERSION */
+#ifndef PIPELINE_BUILD_CACHE_ENTRY_EXT
+#	define PIPELINE_BUILD_CACHE_ENTRY_EXT "cache"
+#endif /* PIPELINE_BUILD_CACHE_ENTRY_EXT */
+#ifndef PIPELINE_BUILD_CACHE_INDEX_FILE
+#	define PIPELINE_BUILD_CACHE_INDEX_FILE "index.txt"
+#endif /* PIPELINE_BUILD_CACHE_INDEX_FILE */
+#ifndef PIPELINE_BUILD_CACHE_MAX_SIZE
+#	define PIPELINE_BUILD_CACHE_MAX_SIZE (1024 * 1024 * 32)
+#endif /* PIPELINE_BUILD_CACHE_MAX_SIZE */
+
+#ifndef PIPELINE_TILES_COMPRESSED_FLAG
+#	define PIPELINE_TILES_COMPRESSED_FLAG 0x8000 /* Assets are always in 0x4000-0x7FFF, leaving bit 15 of an address free. */
+#endif /* PIPELINE_TILES_COMPRESSED_FLAG */
+
+/* ===========================================================================} */
 
 /*
 ** {===========================================================================
@@ -94,6 +126,7 @@ struct Destination {
 		Bytes::Ptr bytes = nullptr;
 		Scheduled::Array scheduled;
 		int layer = -1;
+		std::vector<int> tiles; // The offset of each tile block for compressed tiles, empty for raw.
 
 		Chunk() {
 		}
@@ -113,6 +146,7 @@ struct Destination {
 
 	Chunk::Array chunks;
 	int refCount = 0;
+	bool pinned = false; // Whether to store as is.
 
 	Destination() {
 	}
@@ -135,7 +169,8 @@ struct FreeSpace {
 	};
 	typedef std::vector<Cluster> Array;
 
-	Array entries;
+	Array entries; // Ordered by bank and address.
+	Pipeline::Allocators strategy = Pipeline::Allocators::FIRST_FIT;
 
 	FreeSpace() {
 	}
@@ -147,6 +182,22 @@ struct FreeSpace {
 		entries.clear();
 	}
 	int find(int size) const {
+		if (strategy == Pipeline::Allocators::BEST_FIT || strategy == Pipeline::Allocators::BIN_PACKING) {
+			int result = -1;
+			for (int i = 0; i < (int)entries.size(); ++i) {
+				const Cluster &cluster = entries[i];
+				if (cluster.size < size)
+					continue;
+
+				if (result == -1 || cluster.size < entries[result].size) // The tightest one, earlier bank on tie.
+					result = i;
+				if (cluster.size == size)
+					break;
+			}
+
+			return result;
+		}
+
 		for (int i = 0; i < (int)entries.size(); ++i) {
 			const Cluster &cluster = entries[i];
 			if (cluster.size >= size)
@@ -175,21 +226,20 @@ struct FreeSpace {
 	bool allocate(int size, int* bank, int* addressCursor) {
 		*bank = 0;
 		*addressCursor = 0;
-		for (int i = 0; i < (int)entries.size(); ++i) {
-			Cluster &cluster = entries[i];
-			if (cluster.size >= size) {
-				*bank = cluster.bank;
-				*addressCursor = cluster.addressCursor;
-				cluster.addressCursor += size;
-				cluster.size -= size;
-				if (cluster.size == 0)
-					entries.erase(entries.begin() + i);
+		const int clusterIndex = find(size);
+		if (clusterIndex == -1)
+			return false;
 
-				return true;
-			}
+		return allocate(clusterIndex, size, bank, addressCursor);
+	}
+	int available(int bank) const {
+		int result = 0;
+		for (const Cluster &cluster : entries) {
+			if (cluster.bank == bank)
+				result += cluster.size;
 		}
 
-		return false;
+		return result;
 	}
 };
 
@@ -236,6 +286,458 @@ static void write(Bytes* bytes, UInt16 val, Endians endian) {
 	bytes->writeUInt8(u.bytes[1]);
 }
 
+/**< Packers. */
+
+/**
+ * @brief Packs the 8x8 tiles of a paletted image as 2bpp, tile by tile and
+ *   line by line, with the low bits of a line before the high bits.
+ */
+static void pack2Bpp(const Image* img, Bytes* bytes) {
+	static_assert(GBBASIC_TILE_SIZE == 8 && GBBASIC_PALETTE_DEPTH == 2, "Wrong size.");
+
+	const int w = img->width() / GBBASIC_TILE_SIZE;
+	const int h = img->height() / GBBASIC_TILE_SIZE;
+	if (w <= 0 || h <= 0)
+		return;
+
+	Bytes::Collection buf((size_t)(w * h * GBBASIC_TILE_SIZE * 2), 0);
+	if (img->paletted()) { // Leave it zero for a colored image, which has no index.
+		Byte* ptr = &buf.front();
+		for (int j = 0; j < h; ++j) {
+			for (int i = 0; i < w; ++i) {
+				for (int y = 0; y < GBBASIC_TILE_SIZE; ++y) {
+					// Gather a line of 8 indices into one word, then extract each
+					// bit plane with a multiplication that puts the leftmost pixel
+					// at the most significant bit.
+					const Byte* px = img->row(j * GBBASIC_TILE_SIZE + y) + i * GBBASIC_TILE_SIZE;
+					const UInt64 ln =
+						((UInt64)px[0] << 0) | ((UInt64)px[1] << 8) | ((UInt64)px[2] << 16) | ((UInt64)px[3] << 24) |
+						((UInt64)px[4] << 32) | ((UInt64)px[5] << 40) | ((UInt64)px[6] << 48) | ((UInt64)px[7] << 56);
+					const UInt64 lo = ln & 0x0101010101010101ull; // `index % 2` per pixel.
+					UInt64 hi = (ln >> 1) & 0x7f7f7f7f7f7f7f7full; // `index / 2 != 0` per pixel.
+					hi = (((hi + 0x7f7f7f7f7f7f7f7full) | hi) & 0x8080808080808080ull) >> 7;
+					*ptr++ = (Byte)((lo * 0x8040201008040201ull) >> 56); // The low bits of a line.
+					*ptr++ = (Byte)((hi * 0x8040201008040201ull) >> 56); // The high bits of a line.
+				}
+			}
+		}
+	}
+	bytes->writeBytes(&buf.front(), buf.size());
+}
+
+/**
+ * @brief The operations of compressed tiles, in the high nibble of an operation
+ *   byte; the low nibble of a literal or run is its count minus 1.
+ */
+enum class TileOps : Byte {
+	LITERAL  = 0x00, // Followed by the bytes.
+	BYTE_RUN = 0x10, // Followed by a byte to repeat.
+	WORD_RUN = 0x20, // Followed by two bytes to repeat.
+	REPEAT   = 0xf0  // Followed by the 16-bit distance back to an earlier block.
+};
+
+/**
+ * @brief Compresses 2bpp tiles into independent blocks which unpack to one tile
+ *   each, so that loading can start from any tile; fills in the offset of each
+ *   block.
+ *
+ * @return `true` if the result is smaller than the raw bytes.
+ */
+static bool compress2Bpp(const Bytes* raw, Bytes* bytes, std::vector<int> &offsets) {
+	constexpr const int TILE_BYTES = GBBASIC_TILE_SIZE * 2;
+	typedef std::array<Byte, TILE_BYTES> Block;
+
+	const int n = (int)raw->count() / TILE_BYTES;
+	if (n <= 0)
+		return false;
+
+	std::map<Block, int> originals;
+	for (int t = 0; t < n; ++t) {
+		const Byte* tile = raw->pointer() + t * TILE_BYTES;
+		const int offset = (int)bytes->count();
+		offsets.push_back(offset);
+
+		// Refer to an earlier block with the same tile.
+		Block block;
+		std::copy(tile, tile + TILE_BYTES, block.begin());
+		std::map<Block, int>::const_iterator it = originals.find(block);
+		if (it != originals.end()) {
+			bytes->writeUInt8((UInt8)TileOps::REPEAT);
+			write(bytes, (UInt16)(offset - it->second), Endians::LITTLE);
+
+			continue;
+		}
+		originals.insert(std::make_pair(block, offset));
+
+		// Find the shortest operations from the tail of the tile.
+		int costs[TILE_BYTES + 1];
+		int lengths[TILE_BYTES + 1];
+		TileOps ops[TILE_BYTES + 1];
+		costs[TILE_BYTES] = 0;
+		for (int i = TILE_BYTES - 1; i >= 0; --i) {
+			auto consider = [&] (TileOps op, int len, int cost) -> void {
+				if (cost + costs[i + len] < costs[i]) {
+					costs[i] = cost + costs[i + len];
+					lengths[i] = len;
+					ops[i] = op;
+				}
+			};
+
+			costs[i] = TILE_BYTES * 2;
+			for (int l = 1; i + l <= TILE_BYTES; ++l)
+				consider(TileOps::LITERAL, l, 1 + l);
+			for (int l = 2; i + l <= TILE_BYTES && tile[i + l - 1] == tile[i]; ++l)
+				consider(TileOps::BYTE_RUN, l, 2);
+			for (int w = 2; i + w * 2 <= TILE_BYTES && tile[i + w * 2 - 2] == tile[i] && tile[i + w * 2 - 1] == tile[i + 1]; ++w)
+				consider(TileOps::WORD_RUN, w * 2, 3);
+		}
+
+		// Emit the operations.
+		for (int i = 0; i < TILE_BYTES; i += lengths[i]) {
+			switch (ops[i]) {
+			case TileOps::LITERAL:
+				bytes->writeUInt8((UInt8)((UInt8)ops[i] | (lengths[i] - 1)));
+				bytes->writeBytes(tile + i, (size_t)lengths[i]);
+
+				break;
+			case TileOps::BYTE_RUN:
+				bytes->writeUInt8((UInt8)((UInt8)ops[i] | (lengths[i] - 1)));
+				bytes->writeUInt8(tile[i]);
+
+				break;
+			case TileOps::WORD_RUN:
+				bytes->writeUInt8((UInt8)((UInt8)ops[i] | (lengths[i] / 2 - 1)));
+				bytes->writeUInt8(tile[i]);
+				bytes->writeUInt8(tile[i + 1]);
+
+				break;
+			default:
+				GBBASIC_ASSERT(false && "Impossible.");
+
+				break;
+			}
+		}
+	}
+
+	return bytes->count() < raw->count();
+}
+
+}
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Build cache
+*/
+
+namespace GBBASIC {
+
+/**
+ * @brief Persistent cache of the generated asset bytes across builds.
+ *
+ * @details Each entry is a file named after the checksum of its key, it keeps
+ *   the key itself, which is the geometry and a 64-bit hash of the source
+ *   rather than the source, thus an entry costs about the size of its value;
+ *   another checksum over the whole entry detects corruption, a corrupted
+ *   entry is removed and regenerated. The entries are evicted in LRU order
+ *   once the total size exceeds `PIPELINE_BUILD_CACHE_MAX_SIZE`.
+ */
+class BuildCache final {
+public:
+	struct Statistics {
+		int hits = 0;
+		int misses = 0;
+		int corrupted = 0;
+		size_t savedBytes = 0;
+
+		Statistics() {
+		}
+	};
+
+private:
+	struct Entry {
+		size_t size = 0;
+		UInt64 tick = 0;
+
+		Entry() {
+		}
+	};
+	typedef std::map<std::string, Entry> Entries;
+
+private:
+	Mutex _lock;
+	std::string _directory;
+	Entries _entries;
+	size_t _size = 0;
+	UInt64 _tick = 0;
+	bool _dirty = false;
+
+public:
+	static BuildCache &instance(void) {
+		static BuildCache self;
+
+		return self;
+	}
+
+	/**
+	 * @brief Opens the cache in the specific directory, loads its index if it's
+	 *   not the opened one.
+	 */
+	bool open(const std::string &dir) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		if (_directory == dir)
+			return true;
+
+		flush();
+
+		_directory.clear();
+		_entries.clear();
+		_size = 0;
+		_tick = 0;
+		_dirty = false;
+
+		if (!Path::existsDirectory(dir.c_str())) {
+			if (!Path::touchDirectory(dir.c_str()))
+				return false;
+		}
+		_directory = dir;
+
+		if (!loadIndex()) {
+			scan();
+			_dirty = true;
+		}
+
+		return true;
+	}
+	/**
+	 * @brief Writes the index of the opened cache if it's changed.
+	 */
+	void close(void) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		flush();
+	}
+
+	/**
+	 * @brief Gets the cached bytes of the specific key.
+	 *
+	 * @param[out] val
+	 * @return `true` for hit, otherwise `false`.
+	 */
+	bool get(const Bytes* key, Bytes* val, Statistics &stats) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		if (_directory.empty())
+			return false;
+
+		const std::string name = nameOf(key);
+		Entries::iterator it = _entries.find(name);
+		if (it == _entries.end()) {
+			++stats.misses;
+
+			return false;
+		}
+
+		const std::string path = Path::combine(_directory.c_str(), name.c_str());
+		Bytes::Ptr buf(Bytes::create());
+		File::Ptr file(File::create());
+		if (file->open(path.c_str(), Stream::READ)) {
+			file->readBytes(buf.get());
+			file->close();
+		}
+		file = nullptr;
+
+		bool corrupted = false;
+		const bool ok = parse(buf.get(), key, val, corrupted);
+		if (!ok) {
+			++stats.misses;
+			if (corrupted) {
+				++stats.corrupted;
+				remove(it);
+			}
+
+			return false;
+		}
+
+		++stats.hits;
+		stats.savedBytes += val->count();
+		it->second.tick = ++_tick;
+		_dirty = true;
+
+		return true;
+	}
+	/**
+	 * @brief Caches the bytes of the specific key, evicts the least recently used
+	 *   entries if it's full.
+	 */
+	void set(const Bytes* key, const Bytes* val) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		if (_directory.empty())
+			return;
+
+		const char header[] = PIPELINE_BUILD_CACHE_HEADER;
+		Bytes::Ptr buf(Bytes::create());
+		buf->writeBytes((const Byte*)header, sizeof(header));
+		buf->writeUInt32(PIPELINE_BUILD_CACHE_FORMAT_VERSION);
+		buf->writeUInt32((UInt32)key->count());
+		buf->writeBytes(key);
+		buf->writeUInt32((UInt32)val->count());
+		buf->writeBytes(val);
+		buf->writeUInt32(checksum(buf->pointer(), buf->count()));
+
+		const std::string name = nameOf(key);
+		const std::string path = Path::combine(_directory.c_str(), name.c_str());
+		File::Ptr file(File::create());
+		if (!file->open(path.c_str(), Stream::WRITE))
+			return;
+		file->writeBytes(buf.get());
+		file->close();
+		file = nullptr;
+
+		Entry &entry = _entries[name];
+		_size -= entry.size;
+		entry.size = buf->count();
+		entry.tick = ++_tick;
+		_size += entry.size;
+		_dirty = true;
+
+		while (_size > PIPELINE_BUILD_CACHE_MAX_SIZE && _entries.size() > 1) {
+			Entries::iterator oldest = _entries.begin();
+			for (Entries::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+				if (it->second.tick < oldest->second.tick)
+					oldest = it;
+			}
+			remove(oldest);
+		}
+	}
+
+private:
+	static UInt32 checksum(const Byte* data, size_t len) {
+		uLong result = crc32(0L, Z_NULL, 0);
+		result = crc32(result, (const Bytef*)data, (uInt)len);
+
+		return (UInt32)result;
+	}
+	static std::string nameOf(const Bytes* key) {
+		const UInt32 crc = checksum(key->pointer(), key->count());
+
+		return Text::toHex(crc) + Text::toHex((UInt32)key->count()) + "." PIPELINE_BUILD_CACHE_ENTRY_EXT;
+	}
+
+	/**
+	 * @param[out] val
+	 * @param[out] corrupted
+	 */
+	static bool parse(Bytes* buf, const Bytes* key, Bytes* val, bool &corrupted) {
+		// Check the integrity.
+		const char header[] = PIPELINE_BUILD_CACHE_HEADER;
+		corrupted = true;
+		const size_t total = buf->count();
+		if (total < sizeof(header) + sizeof(UInt32) * 4)
+			return false;
+		UInt32 crc = 0;
+		memcpy(&crc, buf->pointer() + total - sizeof(UInt32), sizeof(UInt32));
+		if (crc != checksum(buf->pointer(), total - sizeof(UInt32)))
+			return false;
+
+		if (memcmp(buf->pointer(), header, sizeof(header)) != 0)
+			return false;
+		buf->poke(sizeof(header));
+		const UInt32 version = buf->readUInt32();
+		const UInt32 keySize = buf->readUInt32();
+		if (buf->peek() + keySize + sizeof(UInt32) * 2 > total)
+			return false;
+		const Byte* key_ = buf->pointer() + buf->peek();
+		buf->poke(buf->peek() + keySize);
+		const UInt32 valSize = buf->readUInt32();
+		if (buf->peek() + valSize + sizeof(UInt32) != total)
+			return false;
+		corrupted = false;
+
+		// Check the key.
+		if (version != PIPELINE_BUILD_CACHE_FORMAT_VERSION)
+			return false;
+		if (keySize != key->count() || memcmp(key_, key->pointer(), keySize) != 0) // Checksum collision.
+			return false;
+
+		// Read the value.
+		val->clear();
+		if (valSize > 0)
+			val->writeBytes(buf->pointer() + buf->peek(), valSize);
+
+		return true;
+	}
+
+	void remove(Entries::iterator it) {
+		const std::string path = Path::combine(_directory.c_str(), it->first.c_str());
+		Path::removeFile(path.c_str(), false);
+		_size -= it->second.size;
+		_entries.erase(it);
+		_dirty = true;
+	}
+
+	bool loadIndex(void) {
+		const std::string path = Path::combine(_directory.c_str(), PIPELINE_BUILD_CACHE_INDEX_FILE);
+		File::Ptr file(File::create());
+		if (!file->open(path.c_str(), Stream::READ))
+			return false;
+		std::string buf;
+		file->readString(buf);
+		file->close();
+		file = nullptr;
+
+		const Text::Array lines = Text::split(buf, "\n", false);
+		for (const std::string &ln : lines) {
+			const Text::Array parts = Text::split(ln, " ", false);
+			if (parts.size() != 3)
+				continue;
+			Entry entry;
+			UInt64 size = 0;
+			if (!Text::fromString(parts[1], size) || !Text::fromString(parts[2], entry.tick))
+				return false;
+			entry.size = (size_t)size;
+			_entries[parts[0]] = entry;
+			_size += entry.size;
+			_tick = Math::max(_tick, entry.tick);
+		}
+
+		return true;
+	}
+	void scan(void) {
+		DirectoryInfo::Ptr dirInfo = DirectoryInfo::make(_directory.c_str());
+		FileInfos::Ptr fileInfos = dirInfo->getFiles("*." PIPELINE_BUILD_CACHE_ENTRY_EXT, false);
+		for (int i = 0; i < fileInfos->count(); ++i) {
+			FileInfo::Ptr fileInfo = fileInfos->get(i);
+			Entry entry;
+			entry.size = Path::countFile(fileInfo->fullPath().c_str());
+			_entries[fileInfo->fileName() + "." + fileInfo->extName()] = entry;
+			_size += entry.size;
+		}
+	}
+	void flush(void) {
+		if (_directory.empty() || !_dirty)
+			return;
+
+		std::string buf;
+		for (Entries::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+			buf += it->first + " " + Text::toString((UInt64)it->second.size) + " " + Text::toString(it->second.tick) + "\n";
+		}
+
+		const std::string path = Path::combine(_directory.c_str(), PIPELINE_BUILD_CACHE_INDEX_FILE);
+		File::Ptr file(File::create());
+		if (!file->open(path.c_str(), Stream::WRITE))
+			return;
+		file->writeString(buf);
+		file->close();
+		file = nullptr;
+
+		_dirty = false;
+	}
+};
+
 }
 
 /* ===========================================================================} */
@@ -247,7 +749,7 @@ static void write(Bytes* bytes, UInt16 val, Endians endian) {
 
 namespace GBBASIC {
 
-static bool generate_toBytes(const TilesAssets::Entry* entry, Pipeline* pipeline, Table &table, int page, bool includeUnused) {
+static bool generate_toBytes(const TilesAssets::Entry* entry, Pipeline* pipeline, Table &table, int page, bool includeUnused, BuildCache::Statistics* cached /* nullable */) {
 	// Prepare.
 	const Image::Ptr &data = entry->data;
 	if (!data)
@@ -263,35 +765,43 @@ static bool generate_toBytes(const TilesAssets::Entry* entry, Pipeline* pipeline
 			inuse = false;
 	}
 
-	// Generate the bytes.
+	// Look for the bytes in the build cache.
 	Bytes::Ptr bytes(Bytes::create());
-	if (inuse) {
-		const int w = data->width() / GBBASIC_TILE_SIZE;
-		const int h = data->height() / GBBASIC_TILE_SIZE;
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				for (int y = 0; y < GBBASIC_TILE_SIZE; ++y) {
-					UInt8 ln0 = 0;
-					UInt8 ln1 = 0;
-					for (int x = 0; x < GBBASIC_TILE_SIZE; ++x) {
-						int idx = 0;
-						data->get(i * GBBASIC_TILE_SIZE + x, j * GBBASIC_TILE_SIZE + y, idx);
-						const bool px0 = !!(idx % GBBASIC_PALETTE_DEPTH);
-						const bool px1 = !!(idx / GBBASIC_PALETTE_DEPTH);
-						ln0 <<= 1;
-						ln0 |= px0 ? 0x01 : 0x00;
-						ln1 <<= 1;
-						ln1 |= px1 ? 0x01 : 0x00;
-					}
-					bytes->writeUInt8(ln0); // The low bits of a line.
-					bytes->writeUInt8(ln1); // The high bits of a line.
-				}
-			}
-		}
+	Bytes::Ptr key = nullptr;
+	bool generating = inuse;
+	if (inuse && cached) {
+		key = Bytes::Ptr(Bytes::create());
+		key->writeUInt8((UInt8)AssetsBundle::Categories::TILES);
+		key->writeInt32(data->width());
+		key->writeInt32(data->height());
+		key->writeInt32(data->paletted());
+		key->writeInt32(data->channels());
+		key->writeUInt64(XXH64(data->pixels(), (size_t)(data->width() * data->height() * data->channels()), 0));
+		if (BuildCache::instance().get(key.get(), bytes.get(), *cached))
+			generating = false;
+	}
+
+	// Generate the bytes.
+	if (generating) {
+		pack2Bpp(data.get(), bytes.get());
+
+		if (key)
+			BuildCache::instance().set(key.get(), bytes.get());
+	}
+
+	// Compress the bytes.
+	std::vector<int> tiles;
+	if (inuse && pipeline->compressTiles() && (it == table.end() || !it->second.pinned)) {
+		Bytes::Ptr compressed(Bytes::create());
+		if (compress2Bpp(bytes.get(), compressed.get(), tiles))
+			bytes = compressed;
+		else
+			tiles.clear();
 	}
 
 	// Fill in with the destination data.
-	const Destination::Chunk chunk(bytes);
+	Destination::Chunk chunk(bytes);
+	chunk.tiles = tiles;
 	if (it == table.end()) {
 		const Destination::Chunk::Array dst({ chunk });
 		const std::pair<Table::iterator, bool> ret = table.insert(std::make_pair(src, dst));
@@ -1029,30 +1539,7 @@ static bool generate_toBytes(const ActorAssets::Entry* entry, Pipeline* pipeline
 			for (int k = 0; k < (int)slices.size(); ++k) {
 				const Actor::Slice &slice = slices[k];
 				const Image::Ptr &img = slice.image;
-				const int sw = img->width();
-				const int sh = img->height();
-				const int w = sw / GBBASIC_TILE_SIZE;
-				const int h = sh / GBBASIC_TILE_SIZE;
-				for (int j = 0; j < h; ++j) {
-					for (int i = 0; i < w; ++i) {
-						for (int y = 0; y < GBBASIC_TILE_SIZE; ++y) {
-							UInt8 ln0 = 0;
-							UInt8 ln1 = 0;
-							for (int x = 0; x < GBBASIC_TILE_SIZE; ++x) {
-								int idx = 0;
-								img->get(i * GBBASIC_TILE_SIZE + x, j * GBBASIC_TILE_SIZE + y, idx);
-								const bool px0 = !!(idx % GBBASIC_PALETTE_DEPTH);
-								const bool px1 = !!(idx / GBBASIC_PALETTE_DEPTH);
-								ln0 <<= 1;
-								ln0 |= px0 ? 0x01 : 0x00;
-								ln1 <<= 1;
-								ln1 |= px1 ? 0x01 : 0x00;
-							}
-							bytes->writeUInt8(ln0); // The low bits of a line.
-							bytes->writeUInt8(ln1); // The high bits of a line.
-						}
-					}
-				}
+				pack2Bpp(img.get(), bytes.get());
 			}
 		}
 
@@ -2161,6 +2648,14 @@ private:
 	 * @brief The ROM allocator.
 	 */
 	FreeSpace _allocator;
+	/**
+	 * @brief Whether to compress the tiles assets.
+	 */
+	bool _compressTiles = false;
+	/**
+	 * @brief The first and last banks that the assets were allocated in.
+	 */
+	std::pair<int, int> _allocatedBanks = std::make_pair(0, -1);
 	/**
 	 * @brief The lookup table.
 	 */
@@ -2187,6 +2682,14 @@ private:
 	 * @brief Whether to output less to the console.
 	 */
 	bool _lessConsoleOutput = false;
+	/**
+	 * @brief The directory of the build cache, empty for disabled.
+	 */
+	std::string _cacheDirectory;
+	/**
+	 * @brief The build cache statistics of this pipeline.
+	 */
+	BuildCache::Statistics _cacheStatistics;
 	/**
 	 * @brief Asynchronized work queue.
 	 */
@@ -2319,14 +2822,46 @@ public:
 		_onError = val;
 	}
 
+	virtual const std::string &cacheDirectory(void) const override {
+		return _cacheDirectory;
+	}
+	virtual void cacheDirectory(const std::string &val) override {
+		_cacheDirectory = val;
+	}
+
+	virtual Allocators allocator(void) const override {
+		return _allocator.strategy;
+	}
+	virtual void allocator(Allocators val) override {
+		_allocator.strategy = val;
+	}
+
+	virtual bool compressTiles(void) const override {
+		return _compressTiles;
+	}
+	virtual void compressTiles(bool val) override {
+		_compressTiles = val;
+	}
+
 	virtual bool pipe(AssetsBundle::ConstPtr assets, bool includeUnused, bool optimizeAssets) override {
 		const long long start = DateTime::ticks();
 
+		BuildCache::Statistics* cached = nullptr;
+		if (!_cacheDirectory.empty()) {
+			if (BuildCache::instance().open(_cacheDirectory))
+				cached = &_cacheStatistics;
+			else
+				_onError("Cannot open the build cache.", true, AssetsBundle::Categories::NONE, -1);
+		}
+
 		Ordered<int>::Pages orderedActorsInScene;
 		const bool ok =
-			generate(assets, includeUnused, orderedActorsInScene) &&           // Generate assets into pieces of bytes.
+			generate(assets, includeUnused, cached, orderedActorsInScene) &&   // Generate assets into pieces of bytes.
 			post(assets, includeUnused, optimizeAssets, orderedActorsInScene); // Fill in the final bytes with the generated ones.
 
+		if (cached)
+			BuildCache::instance().close();
+
 		const long long end = DateTime::ticks();
 		const long long diff = end - start;
 		const double secs = _effectiveSize.total() != 0 ? DateTime::toSeconds(diff) : 0;
@@ -2337,6 +2872,21 @@ public:
 				const std::string time = Text::toString(secs, 6, 0, ' ', std::ios::fixed);
 				const std::string msg = Text::format("Succeeded to process the assets to {0} in {1}s.", { dstn, time });
 				_onPrint(msg, AssetsBundle::Categories::NONE);
+
+				if (cached) {
+					const std::string msg_ = Text::format(
+						"Build cache: {0} hit(s), {1} miss(es), {2} corrupted, {3} saved.",
+						{
+							Text::toString(_cacheStatistics.hits),
+							Text::toString(_cacheStatistics.misses),
+							Text::toString(_cacheStatistics.corrupted),
+							Text::toScaledBytes((Int64)_cacheStatistics.savedBytes)
+						}
+					);
+					_onPrint(msg_, AssetsBundle::Categories::NONE);
+				}
+
+				report();
 			}
 		} else {
 			_onError("Failed to process the assets.", false, AssetsBundle::Categories::NONE, -1);
@@ -2377,6 +2927,17 @@ public:
 
 		return true;
 	}
+	virtual bool pin(AssetsBundle::Categories category, int page) override {
+		const Source src(category, page);
+		Table::iterator it = _table.find(src);
+		if (it == _table.end())
+			return false;
+
+		Destination &dst = it->second;
+		dst.pinned = true;
+
+		return true;
+	}
 	virtual bool lookup(AssetsBundle::Categories category, int page, Resource::Array &locations) const override {
 		locations.clear();
 
@@ -2387,7 +2948,8 @@ public:
 
 		const Destination &dst = it->second;
 		for (const Destination::Chunk &chunk : dst.chunks) {
-			const Resource inRom(chunk.bank, chunk.address, (int)chunk.bytes->count());
+			Resource inRom(chunk.bank, chunk.address, (int)chunk.bytes->count());
+			inRom.tiles = chunk.tiles;
 			locations.push_back(inRom);
 		}
 
@@ -2562,7 +3124,7 @@ public:
 	}
 
 private:
-	bool generate(AssetsBundle::ConstPtr assets, bool includeUnused, Ordered<int>::Pages &orderedActorsInScene) {
+	bool generate(AssetsBundle::ConstPtr assets, bool includeUnused, BuildCache::Statistics* cached /* nullable */, Ordered<int>::Pages &orderedActorsInScene) {
 		// Prepare.
 		bool result = true;
 
@@ -2576,7 +3138,7 @@ private:
 		const TilesAssets &tiles = assets->tiles;
 		for (int i = 0; i < tiles.count(); ++i) {
 			const TilesAssets::Entry* entry = tiles.get(i);
-			if (!generate_toBytes(entry, this, _table, i, includeUnused))
+			if (!generate_toBytes(entry, this, _table, i, includeUnused, cached))
 				result = false;
 		}
 
@@ -2783,13 +3345,16 @@ private:
 
 			Table::iterator iterator;
 			int size = 0;
+			bool contiguous = false;
 
 			OrderedAssets() {
 			}
-			OrderedAssets(Table::iterator it, int sz) : iterator(it), size(sz) {
+			OrderedAssets(Table::iterator it, int sz, bool contiguous_) : iterator(it), size(sz), contiguous(contiguous_) {
 			}
 		};
 
+		_allocatedBanks = std::make_pair(0, -1);
+
 		if (_effectiveSize.total() == 0)
 			return true;
 
@@ -2797,20 +3362,22 @@ private:
 			return true;
 
 		// Get the free space.
-		_allocator.clear();
 		const std::div_t div = std::div((int)_bytes->count(), _bankSize);
 		const int startBank = _startBank + div.quot;
 		const int offset = div.rem;
 		GBBASIC_ASSERT(offset == *_addressCursor && "Wrong data.");
-		const int rest = _bankSize - offset;
-		const FreeSpace::Cluster fs(startBank, offset, rest);
-		_allocator.add(fs);
 		const int maxBanks = _romMaxSize / _bankSize;
-		for (int i = startBank + 1; i < maxBanks; ++i) {
-			const FreeSpace::Cluster fs(i, 0, _bankSize);
+		_allocatedBanks = std::make_pair(startBank, startBank);
+		auto freeSpace = [&] (void) -> void {
+			_allocator.clear();
+			const int rest = _bankSize - offset;
+			const FreeSpace::Cluster fs(startBank, offset, rest);
 			_allocator.add(fs);
-		}
-
+			for (int i = startBank + 1; i < maxBanks; ++i) {
+				const FreeSpace::Cluster fs(i, 0, _bankSize);
+				_allocator.add(fs);
+			}
+		};
 		// Allocate ROM space for the resources.
 		auto shouldAllocateContiguously = [] (const Source &src) -> bool {
 			return src.category == AssetsBundle::Categories::MUSIC;
@@ -2830,25 +3397,13 @@ private:
 				return false;
 			}
 		};
-		auto allocateOne = [&] (Table::iterator it) -> bool {
+		auto placeOne = [&] (Table::iterator it) -> bool {
 			// Prepare.
 			const Source &src = it->first;
 			Destination &dst = it->second;
 			if (!includeUnused && dst.refCount == 0) // Not referenced.
 				return true; // Skip, continue outer loop.
 
-			// Check whether is allocatable.
-			if (!canAllocate(src)) {
-				const std::string cat = AssetsBundle::nameOf(src.category);
-				const std::string page = Text::toPageNumber(src.page);
-				const std::string msg = Text::format("Unknown allocator for {0} at page {1}.", { cat, page });
-				_onError(msg, false, src.category, src.page);
-
-				GBBASIC_ASSERT(false && "Wrong data.");
-
-				return false;
-			}
-
 			// Find a contiguously piece of space if needed.
 			int clusterIndex = -1;
 			if (shouldAllocateContiguously(src)) {
@@ -2859,17 +3414,11 @@ private:
 				}
 
 				clusterIndex = _allocator.find(totalSize);
-				if (clusterIndex == -1) {
-					const std::string cat = AssetsBundle::nameOf(src.category);
-					const std::string page = Text::toPageNumber(src.page);
-					const std::string msg = Text::format("Cannot allocate ROM space for {0} at page {1}.", { cat, page });
-					_onError(msg, false, src.category, src.page);
-
+				if (clusterIndex == -1)
 					return false;
-				}
 			}
 
-			// Allocate and assign the space.
+			// Allocate the space.
 			for (int i = 0; i < (int)dst.chunks.size(); ++i) {
 				Destination::Chunk &chunk = dst.chunks[i];
 				int bank = 0;
@@ -2877,54 +3426,83 @@ private:
 				const bool ok = clusterIndex != -1 ?                                                      // With prefered cluster?
 					_allocator.allocate(clusterIndex, (int)chunk.bytes->count(), &bank, &addressCursor) : // Allocate from the prefered cluster, or
 					_allocator.allocate((int)chunk.bytes->count(), &bank, &addressCursor);                // allocate from available space.
-				if (ok) {
-					chunk.bank = bank;
-					chunk.address = _startAddress + addressCursor;
-
-					const int begin = (bank - _startBank) * _bankSize + addressCursor;
-					const int end = begin + (int)chunk.bytes->count();
-					_bytes->resize(Math::max(end, (int)_bytes->count()));
-					chunk.beginOffset = begin;
-					chunk.endOffset = end;
-					if (chunk.bank >= *_bank) {
-						*_bank = chunk.bank;
-						if (end > *_addressCursor)
-							*_addressCursor = end;
-					}
-				} else { // ROM overflow.
-					const std::string cat = AssetsBundle::nameOf(src.category);
-					const std::string page = Text::toPageNumber(src.page);
-					const std::string msg = Text::format("Cannot allocate ROM space for {0} at page {1}.", { cat, page });
-					_onError(msg, false, src.category, src.page);
-
+				if (!ok) // ROM overflow.
 					return false;
-				}
+
+				chunk.bank = bank;
+				chunk.address = _startAddress + addressCursor;
+				chunk.beginOffset = (bank - _startBank) * _bankSize + addressCursor;
+				chunk.endOffset = chunk.beginOffset + (int)chunk.bytes->count();
 			}
 
 			// Finish.
 			return true; // Ok, continue outer loop.
 		};
+		auto assignOne = [&] (Table::iterator it) -> void {
+			// Prepare.
+			const Destination &dst = it->second;
+			if (!includeUnused && dst.refCount == 0) // Not referenced.
+				return;
+
+			// Assign the space.
+			for (int i = 0; i < (int)dst.chunks.size(); ++i) {
+				const Destination::Chunk &chunk = dst.chunks[i];
+				const int end = chunk.endOffset;
+				_bytes->resize(Math::max(end, (int)_bytes->count()));
+				if (chunk.bank >= *_bank) {
+					*_bank = chunk.bank;
+					if (end > *_addressCursor)
+						*_addressCursor = end;
+				}
+				if (chunk.bank > _allocatedBanks.second)
+					_allocatedBanks.second = chunk.bank;
+			}
+		};
 
 		OrderedAssets::List orderedAssetList;
-		if (optimizeAssets) { // Sort the resources.
-			for (Table::iterator it = _table.begin(); it != _table.end(); ++it) {
-				const Destination &dst = it->second;
-				if (!includeUnused && dst.refCount == 0) { // Not referenced.
-					orderedAssetList.push_back(OrderedAssets(it, 0));
+		const bool sortAssets = optimizeAssets || _allocator.strategy == Allocators::BIN_PACKING;
+		int contiguousCount = 0;
+		for (Table::iterator it = _table.begin(); it != _table.end(); ++it) {
+			const Source &src = it->first;
+			const Destination &dst = it->second;
+			if (!includeUnused && dst.refCount == 0) { // Not referenced.
+				orderedAssetList.push_back(OrderedAssets(it, 0, false));
 
-					continue;
-				}
+				continue;
+			}
 
-				int totalSize = 0;
+			// Check whether is allocatable.
+			if (!canAllocate(src)) {
+				const std::string cat = AssetsBundle::nameOf(src.category);
+				const std::string page = Text::toPageNumber(src.page);
+				const std::string msg = Text::format("Unknown allocator for {0} at page {1}.", { cat, page });
+				_onError(msg, false, src.category, src.page);
+
+				GBBASIC_ASSERT(false && "Wrong data.");
+
+				return false;
+			}
+
+			const bool contiguous = shouldAllocateContiguously(src);
+			if (contiguous)
+				++contiguousCount;
+
+			int totalSize = 0;
+			if (sortAssets) {
 				for (int i = 0; i < (int)dst.chunks.size(); ++i) {
 					const Destination::Chunk &chunk = dst.chunks[i];
 					totalSize += (int)chunk.bytes->count();
 				}
-				orderedAssetList.push_back(OrderedAssets(it, totalSize));
 			}
-
+			orderedAssetList.push_back(OrderedAssets(it, totalSize, contiguous));
+		}
+		if (sortAssets) { // Sort the resources.
+			const bool contiguousAhead = _allocator.strategy == Allocators::BIN_PACKING;
 			orderedAssetList.sort(
-				[] (const OrderedAssets &l, const OrderedAssets &r) -> bool {
+				[contiguousAhead] (const OrderedAssets &l, const OrderedAssets &r) -> bool {
+					if (contiguousAhead && l.contiguous != r.contiguous) // Contiguous ahead, they cannot be split to fill the holes.
+						return l.contiguous;
+
 					if (l.size > r.size) // Larger ahead.
 						return true;
 
@@ -2933,18 +3511,40 @@ private:
 			);
 		}
 
-		if (!optimizeAssets || orderedAssetList.empty()) {
-			for (Table::iterator it = _table.begin(); it != _table.end(); ++it) { // Iterate the resources.
-				if (!allocateOne(it))
-					return false;
+		for (int retries = 0; ; ++retries) {
+			freeSpace();
+			OrderedAssets::List::iterator failed = orderedAssetList.end();
+			for (OrderedAssets::List::iterator it = orderedAssetList.begin(); it != orderedAssetList.end(); ++it) { // Iterate the ordered resources.
+				if (!placeOne(it->iterator)) {
+					failed = it;
+
+					break;
+				}
 			}
-		} else {
-			for (OrderedAssets &ordered : orderedAssetList) { // Iterate the ordered resources.
-				Table::iterator it = ordered.iterator;
-				if (!allocateOne(it))
-					return false;
+			if (failed == orderedAssetList.end())
+				break;
+
+			const Source &src = failed->iterator->first;
+			const bool backtrack =
+				_allocator.strategy == Allocators::BIN_PACKING &&
+				shouldAllocateContiguously(src) &&
+				failed != orderedAssetList.begin() &&
+				retries < contiguousCount;
+			if (backtrack) { // Place the contiguous block that does not fit ahead of the others, then retry.
+				orderedAssetList.splice(orderedAssetList.begin(), orderedAssetList, failed);
+
+				continue;
 			}
+
+			const std::string cat = AssetsBundle::nameOf(src.category);
+			const std::string page = Text::toPageNumber(src.page);
+			const std::string msg = Text::format("Cannot allocate ROM space for {0} at page {1}.", { cat, page });
+			_onError(msg, false, src.category, src.page);
+
+			return false;
 		}
+		for (OrderedAssets &ordered : orderedAssetList)
+			assignOne(ordered.iterator);
 
 		// Post the tiles assets.
 		const TilesAssets &tiles = assets->tiles;
@@ -3008,6 +3608,40 @@ private:
 		return true;
 	}
 
+	void report(void) const {
+		// Prepare.
+		if (_allocatedBanks.second < _allocatedBanks.first)
+			return;
+
+		// Gather the utilization of the banks.
+		int used = 0;
+		int fragmented = 0;
+		std::string banks;
+		for (int i = _allocatedBanks.first; i <= _allocatedBanks.second; ++i) {
+			const int available = _allocator.available(i);
+			used += _bankSize - available;
+			if (i != _allocatedBanks.second)
+				fragmented += available; // Free space left behind in the banks before the last one.
+
+			if (!banks.empty())
+				banks += ", ";
+			banks += Text::toString(i) + ": " + Text::toString((_bankSize - available) * 100 / _bankSize) + "%";
+		}
+
+		// Output the report.
+		const std::string msg = Text::format(
+			"Assets allocated with {0} in {1} bank(s), {2} used, {3} fragmented.",
+			{
+				nameOf(_allocator.strategy),
+				Text::toString(_allocatedBanks.second - _allocatedBanks.first + 1),
+				Text::toScaledBytes(used),
+				Text::toScaledBytes(fragmented)
+			}
+		);
+		_onPrint(msg, AssetsBundle::Categories::NONE);
+		_onPrint("Bank utilization: " + banks + ".", AssetsBundle::Categories::NONE);
+	}
+
 	void asyncCompactActors(AssetsBundle::ConstPtr assets) const {
 		auto compactActor = [] (const ActorAssets::Entry* entry) -> void {
 			Actor::Animation &animation = entry->animation;
@@ -3145,11 +3779,7 @@ private:
 		if (!_workQueue)
 			return;
 
-		constexpr const int STEP = 10;
-		while (!_workQueue->allProcessed()) {
-			_workQueue->update();
-			DateTime::sleep(STEP);
-		}
+		_workQueue->await();
 	}
 
 	template<typename T> void calculateHash(HashArray &hashed, const T &entries) const {
@@ -3202,6 +3832,34 @@ Pipeline::Resource::Resource() {
 Pipeline::Resource::Resource(int b, int a, int s) : bank(b), address(a), size(s) {
 }
 
+int Pipeline::Resource::tileCount(void) const {
+	if (!tiles.empty())
+		return (int)tiles.size();
+
+	return size / (GBBASIC_TILE_SIZE * 2);
+}
+
+bool Pipeline::Resource::tileAddress(int tile, int &addr) const {
+	addr = 0;
+
+	if (tiles.empty()) {
+		const int offset = tile * GBBASIC_TILE_SIZE * 2;
+		if (offset >= size)
+			return false;
+
+		addr = address + offset;
+
+		return true;
+	}
+
+	if (tile < 0 || tile >= (int)tiles.size())
+		return false;
+
+	addr = (address + tiles[tile]) | PIPELINE_TILES_COMPRESSED_FLAG;
+
+	return true;
+}
+
 Pipeline::Size::Size() {
 }
 
@@ -3348,6 +4006,33 @@ std::string Pipeline::Size::toString(int indent) const {
 	return ret;
 }
 
+std::string Pipeline::nameOf(Allocators allocator) {
+	switch (allocator) {
+	case Allocators::FIRST_FIT:
+		return "first_fit";
+	case Allocators::BEST_FIT:
+		return "best_fit";
+	case Allocators::BIN_PACKING:
+		return "bin_packing";
+	default:
+		GBBASIC_ASSERT(false && "Impossible.");
+
+		return "unknown";
+	}
+}
+
+bool Pipeline::allocatorOf(const std::string &name, Allocators &allocator) {
+	for (int i = (int)Allocators::FIRST_FIT; i <= (int)Allocators::BIN_PACKING; ++i) {
+		if (name == nameOf((Allocators)i)) {
+			allocator = (Allocators)i;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
 Pipeline* Pipeline::create(bool useWorkQueue, bool lessConsoleOutput) {
 	PipelineImpl* result = new PipelineImpl(useWorkQueue, lessConsoleOutput);
 
@@ -23,15 +23,35 @@ class Pipeline : public virtual Object {
 public:
 	typedef std::shared_ptr<Pipeline> Ptr;
 
+	/**
+	 * @brief The strategies to allocate ROM space for assets.
+	 */
+	enum class Allocators {
+		FIRST_FIT,  // Takes the first free space that fits, in bank order.
+		BEST_FIT,   // Takes the free space that leaves the least behind.
+		BIN_PACKING // Packs the contiguous blocks then the rest, larger first with best fit; retries with a failed block moved ahead.
+	};
+
 	struct Resource {
 		typedef std::vector<Resource> Array;
 
 		int bank = 0;
 		int address = 0;
 		int size = 0;
+		std::vector<int> tiles; // The offset of each tile block for compressed tiles, empty for raw.
 
 		Resource();
 		Resource(int b, int a, int s);
+
+		/**
+		 * @brief Gets the count of the 8x8 tiles of a tiles asset.
+		 */
+		int tileCount(void) const;
+		/**
+		 * @brief Gets the address to load a tiles asset from the specific tile,
+		 *   with the compressed flag for compressed tiles.
+		 */
+		bool tileAddress(int tile, int &addr) const;
 	};
 
 	struct Size {
@@ -122,6 +142,21 @@ public:
 	virtual ErrorHandler onError(void) const = 0;
 	virtual void onError(ErrorHandler val) = 0;
 
+	virtual const std::string &cacheDirectory(void) const = 0;
+	/**
+	 * @brief Sets the directory of the persistent build cache, empty to disable.
+	 */
+	virtual void cacheDirectory(const std::string &val) = 0;
+
+	virtual Allocators allocator(void) const = 0;
+	virtual void allocator(Allocators val) = 0;
+
+	virtual bool compressTiles(void) const = 0;
+	/**
+	 * @brief Sets whether to compress the tiles assets which are not pinned.
+	 */
+	virtual void compressTiles(bool val) = 0;
+
 	/**
 	 * @brief Pipes all source assets to target bytes.
 	 */
@@ -131,6 +166,11 @@ public:
 	 * @brief Touches an asset page as inuse.
 	 */
 	virtual bool touch(AssetsBundle::ConstPtr assets, AssetsBundle::Categories category, int page, bool incRef) = 0;
+	/**
+	 * @brief Pins an asset page to be stored as is, for code that reads its raw
+	 *   bytes.
+	 */
+	virtual bool pin(AssetsBundle::Categories category, int page) = 0;
 	/**
 	 * @brief Looks for the specific asset's location in ROM.
 	 */
@@ -145,6 +185,9 @@ public:
 	 */
 	virtual void prompt(AssetsBundle::ConstPtr assets) = 0;
 
+	static std::string nameOf(Allocators allocator);
+	static bool allocatorOf(const std::string &name, Allocators &allocator);
+
 	static Pipeline* create(bool useWorkQueue, bool lessConsoleOutput);
 	static void destroy(Pipeline* ptr);
 };
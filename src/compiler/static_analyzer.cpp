@@ -39,14 +39,103 @@ private:
 		RamLocation::Dictionary ramAllocations;
 		CodePageName::Array codePageNames;
 
+		bool reused = false;
+		double seconds = 0.0;
+
 		Result() {
 		}
 	};
 
+	/**
+	 * @brief The kernel artifacts and the last result, which are kept in memory
+	 *   across passes.
+	 */
+	struct Resident {
+		std::string rom;
+		std::string sym;
+		std::string aliases;
+		std::string stamp; // Of the files, to tell a kernel rebuilt in place.
+		Bytes::Ptr kernelRom = nullptr;
+		std::string kernelSymbols;
+		std::string kernelAliases;
+
+		size_t strategies = 0; // Of the compiler options.
+		size_t assets = 0; // Of the non-code assets.
+		Text::Array code;
+		bool analyzed = false;
+		Result result;
+
+		Resident() {
+		}
+
+		bool sameKernel(const std::string &rom_, const std::string &sym_, const std::string &aliases_, const std::string &stamp_) const {
+			return !!kernelRom && rom == rom_ && sym == sym_ && aliases == aliases_ && stamp == stamp_;
+		}
+
+		static std::string stampOf(const std::string &rom_, const std::string &sym_, const std::string &aliases_) {
+			std::string result;
+			for (const std::string* path : { &rom_, &sym_, &aliases_ }) {
+				long long size = 0, modified = 0;
+				Path::stampFile(path->c_str(), &size, &modified);
+				result += Text::toString((Int64)size) + ":" + Text::toString((Int64)modified) + ";";
+			}
+
+			return result;
+		}
+		static size_t strategiesOf(const Options &options) {
+			const Options::Strategies &strategies = options.strategies;
+
+			return Math::hash(
+				0,
+				(unsigned)options.passes,
+				(unsigned)strategies.compatibility,
+				strategies.sramType,
+				strategies.cartridgeHasRtc,
+				strategies.caseInsensitive,
+				strategies.completeLineNumber,
+				strategies.declarationRequired,
+				strategies.indexBase,
+				strategies.bootstrapBank,
+				strategies.heapSize,
+				strategies.stackSize,
+				strategies.failOnError,
+				strategies.optimizeCode,
+				strategies.optimizeAssets
+			);
+		}
+		static size_t assetsOf(const AssetsBundle &assets) {
+			size_t result = 0;
+
+			std::string palette;
+			assets.palette.serializeBasic(palette);
+			result = Math::hash(result, palette);
+			for (const FontAssets::Entry &entry : assets.fonts.entries)
+				result = Math::hash(result, entry.name, entry.hash());
+			for (const TilesAssets::Entry &entry : assets.tiles.entries)
+				result = Math::hash(result, entry.name, entry.hash());
+			for (const MapAssets::Entry &entry : assets.maps.entries)
+				result = Math::hash(result, entry.name, entry.hash());
+			for (const MusicAssets::Entry &entry : assets.music.entries)
+				result = Math::hash(result, entry.data->pointer()->name, entry.hash());
+			for (const SfxAssets::Entry &entry : assets.sfx.entries)
+				result = Math::hash(result, entry.data->pointer()->name, entry.hash());
+			for (const ActorAssets::Entry &entry : assets.actors.entries)
+				result = Math::hash(result, entry.name, entry.hash());
+			for (const SceneAssets::Entry &entry : assets.scenes.entries)
+				result = Math::hash(result, entry.name, entry.hash());
+
+			return result;
+		}
+	};
+
 private:
 	AnalyzeHandler _analyzeHandler = nullptr; // Foreign.
 	int _analyzing = 0;
 
+	Mutex _lock;
+	Resident _resident; // Accessed on work thread.
+	Statistics _statistics;
+
 	unsigned _languageDefinitionRevision = 1;
 	Macro::List _macrosDefinitions;
 	Text::Array _destinations;
@@ -110,6 +199,13 @@ public:
 				std::swap(_codePageNames, result->codePageNames);
 				_codePageNames.shrink_to_fit();
 
+				if (result->reused)
+					++_statistics.reuses;
+				else
+					++_statistics.runs;
+				_statistics.lastSeconds = result->seconds;
+				_statistics.totalSeconds += result->seconds;
+
 				if (diff) {
 					if (++_languageDefinitionRevision == 0)
 						_languageDefinitionRevision = 1;
@@ -154,16 +250,26 @@ public:
 		return &_codePageNames[page];
 	}
 
+	virtual Statistics getStatistics(void) const override {
+		return _statistics;
+	}
+
 	virtual void clear(void) override {
 		_languageDefinitionRevision = 1;
 		_macrosDefinitions.clear();
 		_destinations.clear();
 		_ramAllocations.clear();
 		_codePageNames.clear();
+
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_resident.code.clear();
+		_resident.analyzed = false;
+		_resident.result = Result();
 	}
 
 private:
-	static void doAnalyze(Result* result, const Kernel* krnl, const AssetsBundle::Ptr &assets) { // On work thread.
+	void doAnalyze(Result* result, const Kernel* krnl, const AssetsBundle::Ptr &assets) { // On work thread.
 		// Prepare.
 		std::string dir;
 		Path::split(krnl->path(), nullptr, nullptr, &dir);
@@ -186,6 +292,7 @@ private:
 		options.strategies.bootstrapBank = bootstrapBank;
 		options.piping.useWorkQueue = false;
 		options.piping.lessConsoleOutput = true;
+		options.piping.useCache = true;
 
 		// Initialize the output methods.
 		options.onPrint = [] (const std::string &msg) -> void {
@@ -217,27 +324,106 @@ private:
 
 		const long long start = DateTime::ticks();
 
-		const bool codeIsOk =
-			   load(program, options) &&
-			compile(program, options);
-		(void)codeIsOk;
+		Text::Array code;
+		for (int i = 0; i < assets->code.count(); ++i) {
+			std::string txt;
+			const CodeAssets::Entry* entry = assets->code.get(i);
+			entry->toString(txt, nullptr);
+			code.push_back(txt);
+		}
+
+		const size_t strategies = Resident::strategiesOf(options);
+		const size_t assets_ = Resident::assetsOf(*assets); // The snapshot has been materialized.
+
+		if (doReuse(result, rom, sym, aliases, strategies, assets_, code)) {
+			fprintf(stdout, "[ANALYZER INFO] Nothing changed, reused the former result.\n");
+		} else {
+			const bool codeIsOk =
+				doLoad(program, options) &&
+				compile(program, options);
+			(void)codeIsOk;
 
-		doAnalyzeMacroDefinitions(result, program);
+			doAnalyzeMacroDefinitions(result, program);
 
-		doAnalyzeRamAllocations(result, program);
+			doAnalyzeRamAllocations(result, program);
 
-		doAnalyzeProgram(result, program);
+			doAnalyzeProgram(result, program);
 
-		doAnalyzeCodePages(result, program);
+			doAnalyzeCodePages(result, program);
+
+			doRemember(result, strategies, assets_, code);
+		}
 
 		const long long end = DateTime::ticks();
 		const long long diff = end - start;
 		const double secs = DateTime::toSeconds(diff);
+		result->seconds = secs;
 		const std::string msg = "[ANALYZER INFO] Analyzed in " + Text::toString(secs) + "s.\n";
 		fprintf(stdout, msg.c_str());
 
 		fprintf(stdout, "[ANALYZER INFO] End analyzing.\n");
 	}
+	bool doReuse(Result* result, const std::string &rom, const std::string &sym, const std::string &aliases, size_t strategies, size_t assets, const Text::Array &code) {
+		const std::string stamp = Resident::stampOf(rom, sym, aliases);
+
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		if (!_resident.analyzed)
+			return false;
+		if (!_resident.sameKernel(rom, sym, aliases, stamp))
+			return false;
+		if (_resident.strategies != strategies || _resident.assets != assets)
+			return false;
+		if (_resident.code != code)
+			return false;
+
+		*result = _resident.result;
+		result->reused = true;
+
+		return true;
+	}
+	bool doLoad(Program &program, Options &options) {
+		// Reuse the resident kernel, unless it's been rebuilt since loaded.
+		const std::string stamp = Resident::stampOf(options.rom, options.sym, options.aliases);
+		do {
+			LockGuard<decltype(_lock)> guard(_lock);
+
+			if (!_resident.sameKernel(options.rom, options.sym, options.aliases, stamp))
+				break;
+
+			program.rom = _resident.kernelRom;
+			program.symbols = _resident.kernelSymbols;
+			program.aliases = _resident.kernelAliases;
+
+			return true;
+		} while (false);
+
+		// Load the kernel from disk.
+		if (!load(program, options))
+			return false;
+
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_resident.rom = options.rom;
+		_resident.sym = options.sym;
+		_resident.aliases = options.aliases;
+		_resident.stamp = stamp;
+		_resident.kernelRom = program.rom;
+		_resident.kernelSymbols = program.symbols;
+		_resident.kernelAliases = program.aliases;
+		_resident.analyzed = false;
+
+		return true;
+	}
+	void doRemember(const Result* result, size_t strategies, size_t assets, const Text::Array &code) {
+		LockGuard<decltype(_lock)> guard(_lock);
+
+		_resident.strategies = strategies;
+		_resident.assets = assets;
+		_resident.code = code;
+		_resident.analyzed = true;
+		_resident.result = *result;
+	}
 	static void doAnalyzeMacroDefinitions(Result* result, Program &program) {
 		result->macrosDefinitions.clear();
 		std::swap(result->macrosDefinitions, program.compiled.macros);
@@ -307,6 +493,9 @@ StaticAnalyzer::CodePageName::CodePageName() {
 StaticAnalyzer::CodePageName::CodePageName(const std::string &n) : name(n) {
 }
 
+StaticAnalyzer::Statistics::Statistics() {
+}
+
 StaticAnalyzer* StaticAnalyzer::create(AnalyzeHandler analyzeHandler) {
 	StaticAnalyzerImpl* result = new StaticAnalyzerImpl(analyzeHandler);
 
@@ -57,6 +57,15 @@ public:
 		CodePageName(const std::string &n);
 	};
 
+	struct Statistics {
+		int runs = 0;              // Passes that ran the compiler.
+		int reuses = 0;            // Passes that reused the former result since no code changed.
+		double lastSeconds = 0.0;  // Time of the last pass.
+		double totalSeconds = 0.0; // Time of all passes.
+
+		Statistics();
+	};
+
 public:
 	GBBASIC_CLASS_TYPE('A', 'N', 'L', 'Z')
 
@@ -73,6 +82,8 @@ public:
 
 	virtual const CodePageName* getCodePageName(int page) const = 0;
 
+	virtual Statistics getStatistics(void) const = 0;
+
 	virtual void clear(void) = 0;
 
 	static StaticAnalyzer* create(AnalyzeHandler analyzeHandler);
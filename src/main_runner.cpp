@@ -0,0 +1,340 @@
+/*
+** GB BASIC
+**
+** Copyright (C) 2023-2025 Tony Wang, all rights reserved
+**
+** For the latest info, see https://paladin-t.github.io/kits/gbb/
+*/
+
+#include "gbbasic.h"
+#include "app/runner.h"
+#include "utils/bytes.h"
+#include "utils/file_handle.h"
+#include "utils/text.h"
+#include <inttypes.h>
+
+/*
+** {===========================================================================
+** Macros and constants
+*/
+
+#ifndef MAIN_RUNNER_CPU_TICKS_PER_SECOND
+#	define MAIN_RUNNER_CPU_TICKS_PER_SECOND 4194304
+#endif /* MAIN_RUNNER_CPU_TICKS_PER_SECOND */
+
+/* ===========================================================================} */
+
+/*
+** {===========================================================================
+** Entry
+**
+** @note Usage: gbbrunner ROM [-f FRAMES] [-i INPUT] [-o OUTPUT] [-v] [-e N]
+**   [-r ADDR:SIZE]... [-d classic|colored|classic_ext|colored_ext]
+**   [-w MB [-k FRAMES]] [-p SYM [-l LINES] [-n TICKS]]
+**
+**   -f  frames to run, defaults to the recorded frames of the input, or
+**       `RUNNER_DEFAULT_FRAME_COUNT`
+**   -i  joypad input script or recording, see `Recording::parse(...)`; the
+**       run fails if it ends at the recorded frame with a different state
+**   -o  writes the input and the final state of the run as a recording
+**   -v  runs twice and fails if the two runs diverge
+**   -e  hashes every N frames besides the last one
+**   -r  RAM region to dump in hexadecimal, e.g. "c0dc:0800", repeatable
+**   -d  device type, defaults to the recorded one of the input, or
+**       "colored_ext"
+**   -w  captures every frame into a rewind buffer of the budget, to measure
+**       its memory and cost
+**   -k  keyframe interval of the rewind buffer, defaults to
+**       `DEVICE_DEFAULT_REWIND_KEYFRAME_INTERVAL`
+**   -p  profiles with the kernel's ".sym" file, and dumps the hotspots
+**   -l  line map written by the compiler, to break the hotspots down by
+**       BASIC source line
+**   -n  profiler sampling interval in CPU ticks, defaults to
+**       `PROFILER_DEFAULT_INTERVAL`
+**
+**   Everything but the "time:" lines is deterministic for the same ROM and
+**   arguments, so the output is diffable for regression tests. It exits with
+**   2 if the ROM didn't run through, or 3 if a replay or verification
+**   diverged.
+*/
+
+static bool mainReadFile(const char* path, std::string &txt, Bytes* bytes) {
+	File::Ptr file(File::create());
+	if (!file->open(path, Stream::READ))
+		return false;
+
+	if (bytes)
+		file->readBytes(bytes);
+	else
+		file->readString(txt);
+	file->close();
+
+	return true;
+}
+
+static bool mainParseRegion(const std::string &arg, Runner::Region &region) {
+	const Text::Array parts = Text::split(arg, ":");
+	if (parts.size() != 2)
+		return false;
+
+	char* end = nullptr;
+	const unsigned long addr = strtoul(parts[0].c_str(), &end, 16);
+	if (*end || addr > 0xffff)
+		return false;
+	const unsigned long size = strtoul(parts[1].c_str(), &end, 16);
+	if (*end || size == 0 || addr + size > 0x10000)
+		return false;
+
+	region = Runner::Region((UInt16)addr, (UInt16)size);
+
+	return true;
+}
+
+static bool mainParseDeviceType(const std::string &arg, Device::DeviceTypes &type) {
+	if (arg == "classic")
+		type = Device::DeviceTypes::CLASSIC;
+	else if (arg == "colored")
+		type = Device::DeviceTypes::COLORED;
+	else if (arg == "classic_ext")
+		type = Device::DeviceTypes::CLASSIC_EXTENDED;
+	else if (arg == "colored_ext")
+		type = Device::DeviceTypes::COLORED_EXTENDED;
+	else
+		return false;
+
+	return true;
+}
+
+static int mainUsage(void) {
+	fprintf(
+		stderr,
+		"Usage: gbbrunner ROM [-f FRAMES] [-i INPUT] [-o OUTPUT] [-v] [-e N]\n"
+		"  [-r ADDR:SIZE]... [-d classic|colored|classic_ext|colored_ext]\n"
+		"  [-w MB [-k FRAMES]] [-p SYM [-l LINES] [-n TICKS]]\n"
+	);
+
+	return 1;
+}
+
+int main(int argc, const char* argv[]) {
+	// Parse the arguments.
+	const char* romPath = nullptr;
+	const char* inputPath = nullptr;
+	const char* outputPath = nullptr;
+	const char* symPath = nullptr;
+	const char* linesPath = nullptr;
+	bool hasFrameCount = false;
+	bool hasDeviceType = false;
+	bool verify = false;
+	Runner::Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (arg == "-f" && hasValue) {
+			if (!Text::fromString(argv[++i], options.frameCount) || options.frameCount <= 0)
+				return mainUsage();
+			hasFrameCount = true;
+		} else if (arg == "-i" && hasValue) {
+			inputPath = argv[++i];
+		} else if (arg == "-o" && hasValue) {
+			outputPath = argv[++i];
+		} else if (arg == "-v") {
+			verify = true;
+		} else if (arg == "-e" && hasValue) {
+			if (!Text::fromString(argv[++i], options.hashInterval) || options.hashInterval < 0)
+				return mainUsage();
+		} else if (arg == "-r" && hasValue) {
+			Runner::Region region;
+			if (!mainParseRegion(argv[++i], region))
+				return mainUsage();
+			options.regions.push_back(region);
+		} else if (arg == "-d" && hasValue) {
+			if (!mainParseDeviceType(argv[++i], options.deviceType))
+				return mainUsage();
+			hasDeviceType = true;
+		} else if (arg == "-w" && hasValue) {
+			int mb = 0;
+			if (!Text::fromString(argv[++i], mb) || mb <= 0)
+				return mainUsage();
+			options.rewindCapacity = (size_t)mb * 1024 * 1024;
+		} else if (arg == "-k" && hasValue) {
+			if (!Text::fromString(argv[++i], options.rewindKeyframeInterval) || options.rewindKeyframeInterval <= 0)
+				return mainUsage();
+		} else if (arg == "-p" && hasValue) {
+			symPath = argv[++i];
+		} else if (arg == "-l" && hasValue) {
+			linesPath = argv[++i];
+		} else if (arg == "-n" && hasValue) {
+			if (!Text::fromString(argv[++i], options.profilerInterval) || options.profilerInterval <= 0)
+				return mainUsage();
+		} else if (!arg.empty() && arg.front() != '-' && !romPath) {
+			romPath = argv[i];
+		} else {
+			return mainUsage();
+		}
+	}
+	if (!romPath || ((linesPath || options.profilerInterval > 0) && !symPath))
+		return mainUsage();
+
+	// Load the ROM and input.
+	std::string txt;
+	Bytes::Ptr rom(Bytes::create());
+	if (!mainReadFile(romPath, txt, rom.get()) || rom->empty()) {
+		fprintf(stderr, "Cannot read ROM \"%s\".\n", romPath);
+
+		return 1;
+	}
+	if (inputPath) {
+		int ln = 0;
+		if (!mainReadFile(inputPath, txt, nullptr)) {
+			fprintf(stderr, "Cannot read input \"%s\".\n", inputPath);
+
+			return 1;
+		}
+		if (!options.input.parse(txt, &ln)) {
+			fprintf(stderr, "Invalid input at \"%s\":%d.\n", inputPath, ln);
+
+			return 1;
+		}
+		if (!options.input.device.empty() && !hasDeviceType)
+			mainParseDeviceType(options.input.device, options.deviceType);
+		if (options.input.frameCount > 0 && !hasFrameCount)
+			options.frameCount = options.input.frameCount;
+	}
+	if (symPath) {
+		if (!mainReadFile(symPath, options.profilerSymbols, nullptr)) {
+			fprintf(stderr, "Cannot read symbols \"%s\".\n", symPath);
+
+			return 1;
+		}
+		if (options.profilerInterval <= 0)
+			options.profilerInterval = PROFILER_DEFAULT_INTERVAL;
+	}
+	if (linesPath) {
+		if (!mainReadFile(linesPath, txt, nullptr) || !Profiler::parseLines(txt, options.profilerLines)) {
+			fprintf(stderr, "Cannot read line map \"%s\".\n", linesPath);
+
+			return 1;
+		}
+	}
+
+	// Run.
+	Runner* runner = Runner::create();
+	Runner::Result result;
+	Runner::Result again;
+	bool ok = runner->run(rom->pointer(), rom->count(), options, result);
+	if (verify)
+		ok = runner->run(rom->pointer(), rom->count(), options, again) && ok;
+	Runner::destroy(runner);
+
+	// Verify.
+	bool diverged = false;
+	std::string divergence;
+	if (verify) {
+		if (again.frameHashes != result.frameHashes) {
+			for (int i = 0; i < (int)result.frameHashes.size(); ++i) {
+				if (i >= (int)again.frameHashes.size() || again.frameHashes[i] != result.frameHashes[i]) {
+					divergence = Text::cformat("verify: diverged by frame %d", result.frameHashes[i].first);
+
+					break;
+				}
+			}
+		}
+		if (divergence.empty() && (again.stateHash != result.stateHash || again.lagFrames != result.lagFrames || again.regions != result.regions))
+			divergence = "verify: diverged";
+		diverged = !divergence.empty();
+	}
+	std::string replay;
+	if (options.input.frameCount > 0 && result.frameCount == options.input.frameCount) {
+		if (result.stateHash == options.input.hash) {
+			replay = "replay: matched";
+		} else {
+			replay = Text::cformat("replay: diverged from %016" PRIx64, (uint64_t)options.input.hash);
+			diverged = true;
+		}
+	}
+	if (outputPath) {
+		File::Ptr file(File::create());
+		if (!file->open(outputPath, Stream::WRITE)) {
+			fprintf(stderr, "Cannot write output \"%s\".\n", outputPath);
+
+			return 1;
+		}
+		file->writeString(result.recording.toString());
+		file->close();
+	}
+
+	// Report.
+	fprintf(stdout, "rom: %s\n", romPath);
+	fprintf(stdout, "frames: %d\n", result.frameCount);
+	fprintf(stdout, "ticks: %" PRIu64 "\n", (uint64_t)result.ticks);
+	fprintf(
+		stdout, "busy ticks: %" PRIu64 " (%.1f%%)\n",
+		(uint64_t)result.busyTicks, result.ticks ? (double)result.busyTicks / result.ticks * 100 : 0.0
+	);
+	fprintf(
+		stdout, "lag frames: %d (%.1f%%)\n",
+		result.lagFrames, result.frameCount ? (double)result.lagFrames / result.frameCount * 100 : 0.0
+	);
+	for (const std::pair<int, UInt64> &fh : result.frameHashes)
+		fprintf(stdout, "frame %d: %016" PRIx64 "\n", fh.first, (uint64_t)fh.second);
+	fprintf(stdout, "state: %016" PRIx64 "\n", (uint64_t)result.stateHash);
+	for (int i = 0; i < (int)result.streams.size(); ++i) {
+		const Runner::Stream &stream = result.streams[i];
+		fprintf(
+			stdout, "stream %d: %d bytes, %016" PRIx64 ", ended at frame %d\n",
+			i, (int)stream.data.size(), (uint64_t)stream.hash, stream.frame
+		);
+	}
+	for (int i = 0; i < (int)result.regions.size(); ++i) {
+		const Runner::Region &region = options.regions[i];
+		const std::vector<UInt8> &data = result.regions[i];
+		fprintf(stdout, "ram %04x:%04x:", region.address, region.size);
+		for (UInt8 b : data)
+			fprintf(stdout, " %02x", b);
+		fprintf(stdout, "\n");
+	}
+	if (result.profile.samples > 0) {
+		const Text::Array lines = Profiler::format(result.profile, PROFILER_DEFAULT_TOP_COUNT);
+		for (const std::string &ln : lines)
+			fprintf(stdout, "%s\n", ln.c_str());
+	}
+	if (result.invalidOpcode)
+		fprintf(stdout, "invalid opcode\n");
+	if (!replay.empty())
+		fprintf(stdout, "%s\n", replay.c_str());
+	if (verify)
+		fprintf(stdout, "%s\n", divergence.empty() ? "verify: matched" : divergence.c_str());
+	const double emulated = (double)result.ticks / MAIN_RUNNER_CPU_TICKS_PER_SECOND;
+	if (result.rewindFrames > 0 && emulated > 0) {
+		fprintf(
+			stdout, "rewind: %d frames, %" PRIu64 " bytes (%.1f%% of uncompressed), %.1fKB per emulated minute\n",
+			result.rewindFrames, (uint64_t)result.rewindBytes,
+			result.rewindUncompressedBytes ? (double)result.rewindBytes / result.rewindUncompressedBytes * 100 : 0.0,
+			result.rewindBytes / 1024.0 / (emulated / 60)
+		);
+	}
+	if (result.seconds > 0) {
+		fprintf(
+			stdout, "time: %.3fs, %.1f fps, %.1fx, %.3fms per frame\n",
+			result.seconds, result.frameCount / result.seconds, emulated / result.seconds,
+			result.frameCount ? result.seconds * 1000 / result.frameCount : 0.0
+		);
+	}
+	if (result.rewindFrames > 0) {
+		fprintf(
+			stdout, "rewind time: %.2fus per frame\n",
+			result.rewindSeconds * 1000000 / result.rewindFrames
+		);
+	}
+
+	// Finish.
+	if (!ok)
+		return 2;
+	if (diverged)
+		return 3;
+
+	return 0;
+}
+
+/* ===========================================================================} */
@@ -261,38 +261,89 @@ public:
 
 	virtual bool compact(Animation &animation, Shadow::Array &shadow, Slice::Array &slices, Image* fullImage) const override {
 		// Prepare.
-		auto indexOfSlice = [] (const Slice::Array &coll, const Slice &what, bool &hFlip, bool &vFlip) -> int {
-			for (int i = 0; i < (int)coll.size(); ++i) {
-				if (coll[i] == what) // Compare the slices' images.
-					return i;
-
-				Image* ptr = nullptr;
-				what.image->clone(&ptr);
-				Image::Ptr tmp(ptr);
-				tmp->flip(true, false);
-				if (coll[i] == Slice(tmp, what.offset)) {
-					hFlip = true;
-
-					return i;
-				}
-
-				tmp->flip(false, true);
-				if (coll[i] == Slice(tmp, what.offset)) {
-					hFlip = true;
-					vFlip = true;
-
-					return i;
+		typedef std::vector<Byte> Pixels;
+		typedef std::multimap<size_t, int> SliceIndex;
+
+		Pixels variants[4];             // In the matching priority: none, horizontal, both, vertical.
+		std::vector<Pixels> sliceData;  // Canonical pixels of the collected slices, parallel to `slices`.
+		SliceIndex sliceIndex;          // Hashes of the collected slices to their indices.
+		auto canonicalize = [] (const Image* img, Pixels &pixels) -> void {
+			const int c = img->channels();
+			pixels.resize(img->width() * img->height() * c);
+			if (pixels.empty())
+				return;
+
+			img->get(0, 0, img->width(), img->height(), &pixels.front());
+			if (img->paletted() || c != 4)
+				return;
+
+			for (size_t k = 0; k < pixels.size(); k += c) { // Transparent pixels compare equal regardless of their colour.
+				if (pixels[k + 3] == 0)
+					pixels[k] = pixels[k + 1] = pixels[k + 2] = 255;
+			}
+		};
+		auto flip = [] (const Pixels &src, int w, int h, int c, bool hFlip, bool vFlip, Pixels &dst) -> void {
+			dst.resize(src.size());
+			for (int j = 0; j < h; ++j) {
+				const int sj = vFlip ? h - 1 - j : j;
+				for (int i = 0; i < w; ++i) {
+					const int si = hFlip ? w - 1 - i : i;
+					memcpy(&dst[(i + j * w) * c], &src[(si + sj * w) * c], c);
 				}
+			}
+		};
+		auto hashOf = [] (const Image* img, const Pixels &pixels) -> size_t {
+			size_t result = Math::hash(0, img->paletted(), img->width(), img->height());
+			for (Byte b : pixels)
+				result = Math::hash(result, b);
 
-				tmp->flip(true, false);
-				if (coll[i] == Slice(tmp, what.offset)) {
-					vFlip = true;
-
-					return i;
+			return result;
+		};
+		auto indexOfSlice = [&] (const Slice &what, bool &hFlip, bool &vFlip) -> int {
+			// Hash all four flip variants of the slice once, then take the earliest collected
+			// slice that equals any of them; ties go to the first variant in the priority.
+			const Image* img = what.image.get();
+			const int w = img->width();
+			const int h = img->height();
+			const int c = img->channels();
+			canonicalize(img, variants[0]);
+			flip(variants[0], w, h, c, true, false, variants[1]);
+			flip(variants[0], w, h, c, true, true, variants[2]);
+			flip(variants[0], w, h, c, false, true, variants[3]);
+
+			int result = -1;
+			int variant = -1;
+			for (int k = 0; k < 4; ++k) {
+				const std::pair<SliceIndex::const_iterator, SliceIndex::const_iterator> range = sliceIndex.equal_range(hashOf(img, variants[k]));
+				for (SliceIndex::const_iterator it = range.first; it != range.second; ++it) {
+					const int i = it->second;
+					if (result != -1 && i >= result)
+						continue;
+
+					const Image* other = slices[i].image.get();
+					if (other->paletted() != img->paletted() || other->width() != w || other->height() != h)
+						continue;
+					if (sliceData[i] != variants[k]) // Verify on hash collision.
+						continue;
+
+					result = i;
+					variant = k;
 				}
 			}
 
-			return -1;
+			hFlip = variant == 1 || variant == 2;
+			vFlip = variant == 2 || variant == 3;
+
+			return result;
+		};
+		auto addSlice = [&] (const Slice &what) -> int {
+			// Expects `variants` to be filled by `indexOfSlice(...)` for the same slice.
+			const int result = (int)slices.size();
+			slices.push_back(what);
+			sliceData.push_back(variants[0]);
+			sliceIndex.insert(std::make_pair(hashOf(what.image.get(), variants[0]), result));
+
+			return result;
 		};
 		auto indexOfShadow = [this] (const Shadow::Array &coll, const Shadow &what, int i_) -> int {
 			for (int i = 0; i < (int)coll.size(); ++i) {
@@ -335,10 +386,9 @@ public:
 				int index = -1;
 				bool hFlip = false;
 				bool vFlip = false;
-				const int exists = indexOfSlice(slices, slice, hFlip, vFlip);
+				const int exists = indexOfSlice(slice, hFlip, vFlip);
 				if (exists == -1) {
-					slices.push_back(slice);
-					index = (int)slices.size() - 1;
+					index = addSlice(slice);
 				} else {
 					index = exists;
 				}
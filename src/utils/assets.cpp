@@ -11,9 +11,12 @@
 #include "file_handle.h"
 #include "filesystem.h"
 #include "text.h"
+#include "work_queue.h"
 #include "../compiler/compiler.h"
 #include "../../lib/jpath/jpath.hpp"
 #include "../../lib/rapidfuzz_cpp/rapidfuzz/fuzz.hpp"
+#include <atomic>
+#include <thread>
 
 /*
 ** {===========================================================================
@@ -884,6 +887,111 @@ unsigned BaseAssets::Invalidatable::synchronizeRefRevision(const Versionable* ve
 	return latestRefRevision;
 }
 
+/**
+ * @brief Scans for the name of a pending entry, without building a DOM.
+ */
+struct AssetsNameScanner : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, AssetsNameScanner> {
+	const char* parent = nullptr; // The object that holds the name, or `nullptr` for the root.
+	std::string name;
+	bool found = false;
+	int depth = 0;
+	int holder = 1; // Depth of the object that holds the name, -1 until it's entered.
+	bool entering = false; // The next value is the holder.
+	bool naming = false; // The next value is the name.
+
+	AssetsNameScanner(const char* parent_) : parent(parent_), holder(parent_ ? -1 : 1) {
+	}
+
+	bool Default(void) {
+		entering = naming = false;
+
+		return true;
+	}
+	bool StartObject(void) {
+		++depth;
+		if (entering)
+			holder = depth;
+
+		return Default();
+	}
+	bool EndObject(rapidjson::SizeType /* memberCount */) {
+		if (depth == holder)
+			return false; // Left the holder without a name.
+		--depth;
+
+		return Default();
+	}
+	bool Key(const char* str, rapidjson::SizeType len, bool /* copy */) {
+		entering = parent && holder < 0 && depth == 1 && len == strlen(parent) && memcmp(str, parent, len) == 0;
+		naming = depth == holder && len == 4 && memcmp(str, "name", 4) == 0;
+
+		return true;
+	}
+	bool String(const char* str, rapidjson::SizeType len, bool /* copy */) {
+		if (!naming)
+			return Default();
+
+		name.assign(str, len);
+		found = true;
+
+		return false; // Stop scanning.
+	}
+};
+
+static bool assetsScanName(const BaseAssets::Lazy::Pending &val, const char* parent /* nullable */, std::string &name) {
+	if (!val)
+		return false;
+
+	AssetsNameScanner scanner(parent);
+	rapidjson::StringStream stream(val->c_str());
+	rapidjson::Reader reader;
+	reader.Parse(stream, scanner);
+	if (!scanner.found)
+		return false;
+
+	name = scanner.name;
+
+	return true;
+}
+
+static std::atomic<int> assetsDeferredCount(0);
+static std::atomic<int> assetsMaterializedCount(0);
+
+bool BaseAssets::Lazy::lazy(void) const {
+	return !!pending;
+}
+
+BaseAssets::Lazy::Statistics BaseAssets::Lazy::statistics(void) {
+	Statistics result;
+	result.deferred = assetsDeferredCount;
+	result.materialized = assetsMaterializedCount;
+
+	return result;
+}
+
+void BaseAssets::Lazy::resetStatistics(void) {
+	assetsDeferredCount = 0;
+	assetsMaterializedCount = 0;
+}
+
+void BaseAssets::Lazy::defer(const Pending &val) {
+	pending = val;
+
+	++assetsDeferredCount;
+}
+
+bool BaseAssets::Lazy::undefer(Pending &val) {
+	if (!pending)
+		return false;
+
+	val = pending;
+	pending = nullptr;
+
+	++assetsMaterializedCount;
+
+	return true;
+}
+
 /* ===========================================================================} */
 
 /*
@@ -2783,6 +2891,34 @@ TilesAssets::Entry::Entry(Renderer* rnd, const std::string &val, PaletteAssets::
 	}
 }
 
+TilesAssets::Entry::Entry(Renderer* rnd, const Pending &val, PaletteAssets::Getter getplt) :
+	renderer(rnd),
+	getPalette(getplt)
+{
+	palette = Indexed::Ptr(Indexed::create(GBBASIC_PALETTE_PER_GROUP_COUNT));
+	data = Image::Ptr(Image::create(palette));
+
+	assetsScanName(val, nullptr, name);
+
+	defer(val);
+}
+
+bool TilesAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	if (!fromString(*val, nullptr)) {
+		data->fromBlank(
+			GBBASIC_TILES_DEFAULT_WIDTH * GBBASIC_TILE_SIZE,
+			GBBASIC_TILES_DEFAULT_HEIGHT * GBBASIC_TILE_SIZE,
+			GBBASIC_PALETTE_DEPTH
+		);
+	}
+
+	return true;
+}
+
 size_t TilesAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -3303,6 +3439,13 @@ bool TilesAssets::Entry::parseImage(Image::Ptr &img, const Bytes* val, ParsingSt
 }
 
 bool TilesAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -3441,6 +3584,23 @@ TilesAssets::Entry* TilesAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const TilesAssets::Entry* TilesAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+TilesAssets::Entry* TilesAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -3562,6 +3722,31 @@ MapAssets::Entry::Entry(const std::string &val, TilesAssets::Getter gettls, Text
 	fromString(val, nullptr);
 }
 
+MapAssets::Entry::Entry(const Pending &val, TilesAssets::Getter gettls, Texture::Ptr attribtex) :
+	getTiles(gettls)
+{
+	data = Map::Ptr(Map::create(nullptr, true));
+
+	hasAttributes = false;
+	Math::Vec2i attribcount(attribtex->width() / GBBASIC_TILE_SIZE, attribtex->height() / GBBASIC_TILE_SIZE);
+	Map::Tiles attribtiles(attribtex, attribcount);
+	attributes = Map::Ptr(Map::create(&attribtiles, true));
+
+	assetsScanName(val, nullptr, name);
+
+	defer(val);
+}
+
+bool MapAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	fromString(*val, nullptr);
+
+	return true;
+}
+
 size_t MapAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -3957,6 +4142,13 @@ bool MapAssets::Entry::parseJson(Map::Ptr &map, bool &hasAttrib, Map::Ptr &attri
 }
 
 bool MapAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -4175,6 +4367,23 @@ MapAssets::Entry* MapAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const MapAssets::Entry* MapAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+MapAssets::Entry* MapAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -4810,6 +5019,31 @@ MusicAssets::Entry::Entry(const std::string &val) {
 	fromString(val, nullptr);
 }
 
+MusicAssets::Entry::Entry(const Pending &val) {
+	data = Music::Ptr(Music::create());
+
+	Music::Song* song = data->pointer();
+	Music::Channels &channels = song->channels;
+	for (int i = 0; i < (int)channels.size(); ++i) {
+		Music::Sequence &seq = channels[i];
+		seq.push_back(0);
+	}
+
+	assetsScanName(val, "song", song->name);
+
+	defer(val);
+}
+
+bool MusicAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	fromString(*val, nullptr);
+
+	return true;
+}
+
 size_t MusicAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -4996,6 +5230,13 @@ bool MusicAssets::Entry::parseJson(Music::Ptr &music, const std::string &val) co
 }
 
 bool MusicAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -5140,6 +5381,23 @@ MusicAssets::Entry* MusicAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const MusicAssets::Entry* MusicAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+MusicAssets::Entry* MusicAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -5238,12 +5496,30 @@ SfxAssets::Entry::Entry(const std::string &val) {
 	fromString(val, nullptr);
 }
 
+SfxAssets::Entry::Entry(const Pending &val) {
+	data = Sfx::Ptr(Sfx::create());
+
+	assetsScanName(val, "sound", data->pointer()->name);
+
+	defer(val);
+}
+
 SfxAssets::Entry::Entry(const Sfx::Sound &val) {
 	data = Sfx::Ptr(Sfx::create());
 
 	*data->pointer() = val;
 }
 
+bool SfxAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	fromString(*val, nullptr);
+
+	return true;
+}
+
 size_t SfxAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -5361,6 +5637,13 @@ bool SfxAssets::Entry::parseJson(Sfx::Ptr &sfx, const std::string &val) const {
 }
 
 bool SfxAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -5500,6 +5783,23 @@ SfxAssets::Entry* SfxAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const SfxAssets::Entry* SfxAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+SfxAssets::Entry* SfxAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -5652,6 +5952,38 @@ ActorAssets::Entry::Entry(Renderer* rnd, const std::string &val, PaletteAssets::
 	fromString(val, nullptr);
 }
 
+ActorAssets::Entry::Entry(Renderer* rnd, const Pending &val, PaletteAssets::Getter getplt, active_t::BehaviourSerializer serializeBhvr, active_t::BehaviourParser parseBhvr) :
+	renderer(rnd),
+	getPalette(getplt),
+	serializeBehaviour(serializeBhvr), parseBehaviour(parseBhvr)
+{
+	palette = Indexed::Ptr(Indexed::create(GBBASIC_PALETTE_PER_GROUP_COUNT));
+	const PaletteAssets::Entry* ref_ = getPalette(GBBASIC_ACTOR_DEFAULT_PALETTE);
+	if (ref_) {
+		for (int i = 0; i < GBBASIC_PALETTE_PER_GROUP_COUNT; ++i) {
+			Colour col;
+			ref_->data->get(i, col);
+			palette->set(i, &col);
+		}
+	}
+	data = Actor::Ptr(Actor::create());
+	data->load(false);
+
+	assetsScanName(val, nullptr, name);
+
+	defer(val);
+}
+
+bool ActorAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	fromString(*val, nullptr);
+
+	return true;
+}
+
 size_t ActorAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -6287,6 +6619,13 @@ bool ActorAssets::Entry::parseSpriteSheet(Actor::Ptr &actor, const Bytes* val, c
 }
 
 bool ActorAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -6441,6 +6780,23 @@ ActorAssets::Entry* ActorAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const ActorAssets::Entry* ActorAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+ActorAssets::Entry* ActorAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -6767,6 +7123,29 @@ SceneAssets::Entry::Entry(const std::string &val, MapAssets::Getter getmap, Acto
 	fromString(val, nullptr);
 }
 
+SceneAssets::Entry::Entry(const Pending &val, MapAssets::Getter getmap, ActorAssets::Getter getact, Texture::Ptr propstex, Texture::Ptr actorstex) :
+	getMap(getmap), getActor(getact),
+	propertiesTexture(propstex), actorsTexture(actorstex)
+{
+	assetsScanName(val, nullptr, name);
+
+	defer(val);
+}
+
+bool SceneAssets::Entry::materialize(void) {
+	Pending val = nullptr;
+	if (!undefer(val))
+		return false;
+
+	// The layers are built upon the referenced map, which is resolved (and
+	// materialized) only now; so construct eagerly and take over the result.
+	Entry entry(*val, getMap, getActor, propertiesTexture, actorsTexture);
+	entry.editor = editor;
+	*this = entry;
+
+	return true;
+}
+
 size_t SceneAssets::Entry::hash(void) const {
 	size_t result = 0;
 
@@ -7335,6 +7714,13 @@ bool SceneAssets::Entry::parseJson(Scene::Ptr &scene, scene_t &def, ActorRoutine
 }
 
 bool SceneAssets::Entry::toString(std::string &val, WarningOrErrorHandler onWarningOrError) const {
+	// Write the pending text verbatim.
+	if (pending) {
+		val = *pending;
+
+		return true;
+	}
+
 	// Prepare.
 	val.clear();
 
@@ -7523,6 +7909,23 @@ SceneAssets::Entry* SceneAssets::get(int index) {
 	if (index < 0 || index >= (int)entries.size())
 		return nullptr;
 
+	Entry &entry = entries[index];
+	entry.materialize();
+
+	return &entry;
+}
+
+const SceneAssets::Entry* SceneAssets::peek(int index) const {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
+	return &entries[index];
+}
+
+SceneAssets::Entry* SceneAssets::peek(int index) {
+	if (index < 0 || index >= (int)entries.size())
+		return nullptr;
+
 	return &entries[index];
 }
 
@@ -7622,15 +8025,7 @@ void AssetsBundle::clone(AssetsBundle* other, FontGetter getFont, CodeGetter get
 	if (!other)
 		return;
 
-	other->palette = palette;
-	other->fonts = fonts;
-	other->code = code;
-	other->tiles = tiles;
-	other->maps = maps;
-	other->music = music;
-	other->sfx = sfx;
-	other->actors = actors;
-	other->scenes = scenes;
+	snapshot(other, getCode);
 
 	if (getFont) {
 		FontAssets fonts_;
@@ -7641,16 +8036,6 @@ void AssetsBundle::clone(AssetsBundle* other, FontGetter getFont, CodeGetter get
 		}
 		other->fonts = fonts_;
 	}
-
-	if (getCode) {
-		CodeAssets code_;
-		for (int i = 0; i < other->code.count(); ++i) {
-			const CodeAssets::Entry* entry = other->code.get(i);
-			const CodeAssets::Entry newEntry(getCode(entry));
-			code_.add(newEntry);
-		}
-		other->code = code_;
-	}
 }
 
 void AssetsBundle::clone(CodeAssets* other, CodeGetter getCode) const {
@@ -7670,6 +8055,93 @@ void AssetsBundle::clone(CodeAssets* other, CodeGetter getCode) const {
 	}
 }
 
+void AssetsBundle::materialize(bool parallel) {
+	// Prepare.
+	typedef std::function<bool(void)> Materializer;
+	typedef std::vector<Materializer> Materializers;
+
+	Materializers materializers;
+	for (TilesAssets::Entry &entry : tiles.entries) {
+		if (entry.lazy())
+			materializers.push_back(std::bind(&TilesAssets::Entry::materialize, &entry));
+	}
+	for (MusicAssets::Entry &entry : music.entries) {
+		if (entry.lazy())
+			materializers.push_back(std::bind(&MusicAssets::Entry::materialize, &entry));
+	}
+	for (SfxAssets::Entry &entry : sfx.entries) {
+		if (entry.lazy())
+			materializers.push_back(std::bind(&SfxAssets::Entry::materialize, &entry));
+	}
+	for (ActorAssets::Entry &entry : actors.entries) {
+		if (entry.lazy())
+			materializers.push_back(std::bind(&ActorAssets::Entry::materialize, &entry));
+	}
+
+	// Materialize the renderer-free entries, they are independent from each other.
+	if (parallel && materializers.size() > 1) {
+		const int threadCount = std::min(
+			(int)std::max(std::thread::hardware_concurrency(), 1u), // Might be 0 if not computable.
+			(int)materializers.size()
+		);
+		WorkQueue* workQueue = WorkQueue::create();
+		workQueue->startup("ASSETS", threadCount);
+		for (const Materializer &materializer : materializers) {
+			workQueue->push(
+				WorkTaskFunction::create(
+					[materializer] (WorkTask* /* task */) -> uintptr_t { // On work thread.
+						materializer();
+
+						return 0;
+					},
+					[] (WorkTask* /* task */, uintptr_t) -> void { // On main thread.
+						// Do nothing.
+					},
+					[] (WorkTask* task, uintptr_t) -> void { // On main thread.
+						task->disassociated(true);
+					}
+				)
+			);
+		}
+		workQueue->await();
+		workQueue->shutdown();
+		WorkQueue::destroy(workQueue);
+	} else {
+		for (const Materializer &materializer : materializers)
+			materializer();
+	}
+
+	// Materialize the maps and scenes, they touch textures thus stay on the calling thread.
+	for (MapAssets::Entry &entry : maps.entries)
+		entry.materialize();
+	for (SceneAssets::Entry &entry : scenes.entries)
+		entry.materialize();
+}
+
+void AssetsBundle::snapshot(AssetsBundle* other, CodeGetter getCode) const {
+	if (!other)
+		return;
+
+	// Copy every collection here, `clone()` builds on this.
+	other->palette = palette;
+	other->fonts = fonts;
+	other->tiles = tiles;
+	other->maps = maps;
+	other->music = music;
+	other->sfx = sfx;
+	other->actors = actors;
+	other->scenes = scenes;
+
+	if (getCode) {
+		other->code.entries.clear();
+		other->code.entries.reserve(code.entries.size());
+		for (const CodeAssets::Entry &entry : code.entries)
+			other->code.entries.push_back(CodeAssets::Entry(getCode(&entry)));
+	} else {
+		other->code = code;
+	}
+}
+
 std::string AssetsBundle::nameOf(Categories category) {
 	switch (category) {
 	case Categories::PALETTE:
@@ -443,6 +443,28 @@ struct BaseAssets {
 		bool isRefRevisionChanged(const Versionable* versionable) const;
 		unsigned synchronizeRefRevision(const Versionable* versionable);
 	};
+	/**
+	 * @brief Defers deserialization of an entry until it is first used.
+	 */
+	struct Lazy {
+		typedef std::shared_ptr<const std::string> Pending;
+
+		struct Statistics {
+			int deferred = 0;
+			int materialized = 0; // Including the entries of the snapshots for compiling.
+		};
+
+		Pending pending = nullptr; // Non-serialized. The serialized text, until the entry is materialized.
+
+		bool lazy(void) const;
+
+		static Statistics statistics(void);
+		static void resetStatistics(void);
+
+	protected:
+		void defer(const Pending &val);
+		bool undefer(Pending &val);
+	};
 };
 
 typedef std::function<void(const char*)> PrintHandler;
@@ -678,7 +700,7 @@ struct CodeAssets {
 */
 
 struct TilesAssets {
-	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable, public BaseAssets::Lazy {
 		Image::Ptr data = nullptr;
 		int ref = 0; // To a palette.
 		std::string name;
@@ -691,6 +713,9 @@ struct TilesAssets {
 
 		Entry(Renderer* rnd, PaletteAssets::Getter getplt);
 		Entry(Renderer* rnd, const std::string &val, PaletteAssets::Getter getplt);
+		Entry(Renderer* rnd, const Pending &val, PaletteAssets::Getter getplt);
+
+		bool materialize(void);
 
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
@@ -727,8 +752,10 @@ struct TilesAssets {
 	int count(void) const;
 	bool add(const Entry &entry);
 	bool remove(int index);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
@@ -742,7 +769,7 @@ struct TilesAssets {
 */
 
 struct MapAssets {
-	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable, public BaseAssets::Lazy {
 		Map::Ptr data = nullptr;
 		int ref = 0; // To a tiles.
 		bool hasAttributes = false;
@@ -755,6 +782,9 @@ struct MapAssets {
 
 		Entry(int ref_, TilesAssets::Getter gettls, Texture::Ptr attribtex);
 		Entry(const std::string &val, TilesAssets::Getter gettls, Texture::Ptr attribtex);
+		Entry(const Pending &val, TilesAssets::Getter gettls, Texture::Ptr attribtex);
+
+		bool materialize(void);
 
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
@@ -802,8 +832,10 @@ struct MapAssets {
 	int count(void) const;
 	bool add(const Entry &entry);
 	bool remove(int index);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
@@ -916,7 +948,7 @@ struct Tracker {
 };
 
 struct MusicAssets {
-	struct Entry : public BaseAssets::Entry {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Lazy {
 		Music::Ptr data = nullptr;
 		int magnification = -1; // Non-polluting.
 
@@ -926,6 +958,9 @@ struct MusicAssets {
 
 		Entry(void);
 		Entry(const std::string &val);
+		Entry(const Pending &val);
+
+		bool materialize(void);
 
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
@@ -952,23 +987,28 @@ struct MusicAssets {
 	int count(void) const;
 	bool add(const Entry &entry);
 	bool remove(int index);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
 };
 
 struct SfxAssets {
-	struct Entry : public BaseAssets::Entry {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Lazy {
 		Sfx::Ptr data = nullptr;
 
 		Texture::Ptr shape = nullptr; // Non-serialized.
 
 		Entry(void);
 		Entry(const std::string &val);
+		Entry(const Pending &val);
 		Entry(const Sfx::Sound &val);
 
+		bool materialize(void);
+
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
 
@@ -993,8 +1033,10 @@ struct SfxAssets {
 	bool insert(const Entry &entry, int index);
 	bool remove(int index);
 	void clear(void);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
@@ -1009,7 +1051,7 @@ struct SfxAssets {
 */
 
 struct ActorAssets {
-	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Versionable, public BaseAssets::Invalidatable, public BaseAssets::Lazy {
 		typedef std::function<Colour(int, int, int, Byte)> PaletteResolver;
 		typedef std::function<bool(UInt8)> PlayerBehaviourCheckingHandler;
 
@@ -1032,6 +1074,9 @@ struct ActorAssets {
 
 		Entry(Renderer* rnd, bool is8x16, PaletteAssets::Getter getplt, active_t::BehaviourSerializer serializeBhvr, active_t::BehaviourParser parseBhvr);
 		Entry(Renderer* rnd, const std::string &val, PaletteAssets::Getter getplt, active_t::BehaviourSerializer serializeBhvr, active_t::BehaviourParser parseBhvr);
+		Entry(Renderer* rnd, const Pending &val, PaletteAssets::Getter getplt, active_t::BehaviourSerializer serializeBhvr, active_t::BehaviourParser parseBhvr);
+
+		bool materialize(void);
 
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
@@ -1073,8 +1118,10 @@ struct ActorAssets {
 	int count(void) const;
 	bool add(const Entry &entry);
 	bool remove(int index);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
@@ -1148,7 +1195,7 @@ struct Routine {
 };
 
 struct SceneAssets {
-	struct Entry : public BaseAssets::Entry {
+	struct Entry : public BaseAssets::Entry, public BaseAssets::Lazy {
 		typedef std::vector<int> Ref;
 		typedef std::set<int> UniqueRef;
 		typedef std::map<int, unsigned> Revisions;
@@ -1166,9 +1213,14 @@ struct SceneAssets {
 		Revisions actorRevisions; // Non-serialized.
 		MapAssets::Getter getMap = nullptr; // Non-serialized. Foreign.
 		ActorAssets::Getter getActor = nullptr; // Non-serialized. Foreign.
+		Texture::Ptr propertiesTexture = nullptr; // Non-serialized. Foreign. Kept until the entry is materialized.
+		Texture::Ptr actorsTexture = nullptr; // Non-serialized. Foreign. Kept until the entry is materialized.
 
 		Entry(int refMap_, MapAssets::Getter getmap, ActorAssets::Getter getact, Texture::Ptr propstex, Texture::Ptr actorstex);
 		Entry(const std::string &val, MapAssets::Getter getmap, ActorAssets::Getter getact, Texture::Ptr propstex, Texture::Ptr actorstex);
+		Entry(const Pending &val, MapAssets::Getter getmap, ActorAssets::Getter getact, Texture::Ptr propstex, Texture::Ptr actorstex);
+
+		bool materialize(void);
 
 		size_t hash(void) const;
 		int compare(const Entry &other) const;
@@ -1212,8 +1264,10 @@ struct SceneAssets {
 	int count(void) const;
 	bool add(const Entry &entry);
 	bool remove(int index);
-	const Entry* get(int index) const;
-	Entry* get(int index);
+	const Entry* get(int index) const; // Doesn't materialize, a pending entry only has its name.
+	Entry* get(int index); // Materializes the entry if it's still pending.
+	const Entry* peek(int index) const; // Doesn't materialize, for editor bookkeeping only.
+	Entry* peek(int index); // Doesn't materialize, for editor bookkeeping only.
 	const Entry* find(const std::string &name, int* index /* nullable */) const;
 	const Entry* fuzzy(const std::string &name, int* index /* nullable */, std::string &gotName) const;
 	int indexOf(const std::string &name) const;
@@ -1266,6 +1320,14 @@ struct AssetsBundle {
 
 	void clone(AssetsBundle* other, FontGetter getFont, CodeGetter getCode) const;
 	void clone(CodeAssets* other, CodeGetter getCode) const;
+	void snapshot(AssetsBundle* other, CodeGetter getCode /* nullable */) const; // For compiling on another thread, shares the payloads rather than duplicating them.
+	/**
+	 * @brief Materializes all pending entries; call it on the main thread.
+	 *
+	 * @param[in] parallel Whether to deserialize the renderer-free categories
+	 *   on a work queue. Maps and scenes are always done on the calling thread.
+	 */
+	void materialize(bool parallel);
 
 	static std::string nameOf(Categories category);
 };
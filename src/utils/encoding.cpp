@@ -474,6 +474,50 @@ bool Base64::toBytes(class Bytes* val, const std::string &str) {
 	return true;
 }
 
+bool Base64::toBytes(class Bytes* val, const char* str, size_t len) {
+	// Same as `b64_decode_ex`, but looks up a table instead of searching per
+	// character, and decodes into the target buffer directly.
+	struct Table {
+		Byte values[256];
+
+		Table() {
+			for (int i = 0; i < 256; ++i)
+				values[i] = 0xff;
+			for (int i = 0; i < 64; ++i)
+				values[(Byte)b64_table[i]] = (Byte)i;
+		}
+	};
+	static const Table TABLE;
+
+	Bytes::Collection buf(len / 4 * 3 + 3);
+	Byte* begin = &buf.front();
+	Byte* ptr = begin;
+	UInt32 quad = 0;
+	int n = 0;
+	for (size_t i = 0; i < len; ++i) {
+		const Byte v = TABLE.values[(Byte)str[i]];
+		if (v == 0xff)
+			break;
+
+		quad = (quad << 6) | v;
+		if (++n == 4) {
+			*ptr++ = (Byte)(quad >> 16);
+			*ptr++ = (Byte)(quad >> 8);
+			*ptr++ = (Byte)quad;
+			quad = 0;
+			n = 0;
+		}
+	}
+	if (n > 0) {
+		quad <<= 6 * (4 - n);
+		for (int i = 0; i < n - 1; ++i)
+			*ptr++ = (Byte)(quad >> (16 - i * 8));
+	}
+	val->writeBytes(begin, ptr - begin);
+
+	return true;
+}
+
 bool Base64::fromBytes(std::string &val, const class Bytes* buf) {
 	val.clear();
 
@@ -556,3 +600,212 @@ bool Lz4::fromBytes(class Bytes* val, const class Bytes* src) {
 }
 
 /* ===========================================================================} */
+
+/*
+** {===========================================================================
+** RLE
+*/
+
+#ifndef ENCODING_RLE_VERSION
+#	define ENCODING_RLE_VERSION 1
+#endif /* ENCODING_RLE_VERSION */
+#ifndef ENCODING_RLE_MIN_RUN
+#	define ENCODING_RLE_MIN_RUN 3
+#endif /* ENCODING_RLE_MIN_RUN */
+#ifndef ENCODING_RLE_MAX_COUNT
+#	define ENCODING_RLE_MAX_COUNT (1024 * 1024 * 16)
+#endif /* ENCODING_RLE_MAX_COUNT */
+
+enum class RlePackings : Byte {
+	INDICES_2BPP = 2,
+	BYTES = 8,
+	VARINTS = 32
+};
+
+bool Rle::toValues(Values &val, const char* str, size_t len) {
+	// Prepare.
+	val.clear();
+
+	Bytes::Ptr bytes(Bytes::create());
+	if (!Base64::toBytes(bytes.get(), str, len))
+		return false;
+
+	const Byte* ptr = bytes->pointer();
+	const Byte* end = ptr + bytes->count();
+	auto readVarint = [&ptr, end] (UInt64 &ret) -> bool {
+		ret = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (ptr >= end)
+				return false;
+			const Byte b = *ptr++;
+			ret |= (UInt64)(b & 0x7f) << shift;
+			if (!(b & 0x80))
+				return true;
+		}
+
+		return false;
+	};
+
+	// Read the header.
+	if (end - ptr < 2)
+		return false;
+	if (*ptr++ != ENCODING_RLE_VERSION)
+		return false;
+	const RlePackings packing = (RlePackings)*ptr++;
+	if (packing != RlePackings::INDICES_2BPP && packing != RlePackings::BYTES && packing != RlePackings::VARINTS)
+		return false;
+	UInt64 count = 0;
+	if (!readVarint(count) || count > ENCODING_RLE_MAX_COUNT)
+		return false;
+	val.resize((size_t)count);
+
+	// Expand the runs.
+	auto readUnit = [&ptr, end, packing, &readVarint] (UInt32 &ret) -> bool {
+		if (packing == RlePackings::VARINTS) {
+			UInt64 u = 0;
+			if (!readVarint(u) || u > 0xffffffff)
+				return false;
+			ret = (UInt32)u;
+
+			return true;
+		}
+		if (ptr >= end)
+			return false;
+		ret = *ptr++;
+
+		return true;
+	};
+	size_t pos = 0;
+	auto put = [&val, &pos, packing] (UInt32 unit) -> void {
+		switch (packing) {
+		case RlePackings::INDICES_2BPP:
+			for (int k = 0; k < 4 && pos < val.size(); ++k)
+				val[pos++] = (int)((unit >> (k * 2)) & 0x03);
+
+			break;
+		case RlePackings::BYTES:
+			val[pos++] = (int)unit;
+
+			break;
+		case RlePackings::VARINTS:
+			val[pos++] = (int)((unit >> 1) ^ (~(unit & 1) + 1));
+
+			break;
+		}
+	};
+	const UInt64 units = packing == RlePackings::INDICES_2BPP ? (count + 3) / 4 : count;
+	UInt64 n = 0;
+	while (n < units) {
+		UInt64 ctrl = 0;
+		if (!readVarint(ctrl))
+			return false;
+		const UInt64 m = (ctrl >> 1) + 1;
+		if (m > units - n)
+			return false;
+		UInt32 unit = 0;
+		if (ctrl & 1) {
+			if (!readUnit(unit))
+				return false;
+			for (UInt64 k = 0; k < m; ++k)
+				put(unit);
+		} else {
+			for (UInt64 k = 0; k < m; ++k) {
+				if (!readUnit(unit))
+					return false;
+				put(unit);
+			}
+		}
+		n += m;
+	}
+
+	// Finish.
+	return pos == val.size();
+}
+
+bool Rle::fromValues(std::string &val, const Values &data) {
+	// Prepare.
+	typedef std::vector<UInt32> Units;
+
+	val.clear();
+
+	// Determine the packing.
+	RlePackings packing = RlePackings::INDICES_2BPP;
+	for (int v : data) {
+		if (v < 0 || v > 255) {
+			packing = RlePackings::VARINTS;
+
+			break;
+		} else if (v > 3) {
+			packing = RlePackings::BYTES;
+		}
+	}
+
+	// Pack the values into units.
+	Units units;
+	switch (packing) {
+	case RlePackings::INDICES_2BPP:
+		units.resize((data.size() + 3) / 4, 0);
+		for (size_t i = 0; i < data.size(); ++i)
+			units[i / 4] |= (UInt32)data[i] << ((i % 4) * 2);
+
+		break;
+	case RlePackings::BYTES:
+		units.assign(data.begin(), data.end());
+
+		break;
+	case RlePackings::VARINTS:
+		units.reserve(data.size());
+		for (int v : data)
+			units.push_back(((UInt32)v << 1) ^ (UInt32)(v >> 31));
+
+		break;
+	}
+
+	// Write the header.
+	Bytes::Ptr bytes(Bytes::create());
+	auto writeVarint = [&bytes] (UInt64 v) -> void {
+		while (v >= 0x80) {
+			bytes->writeByte((Byte)((v & 0x7f) | 0x80));
+			v >>= 7;
+		}
+		bytes->writeByte((Byte)v);
+	};
+	auto writeUnit = [&bytes, packing, &writeVarint] (UInt32 u) -> void {
+		if (packing == RlePackings::VARINTS)
+			writeVarint(u);
+		else
+			bytes->writeByte((Byte)u);
+	};
+	bytes->writeUInt8(ENCODING_RLE_VERSION);
+	bytes->writeUInt8((UInt8)packing);
+	writeVarint(data.size());
+
+	// Encode the units as runs and literals.
+	size_t literal = 0;
+	auto flush = [&units, &literal, &writeVarint, &writeUnit] (size_t end) -> void {
+		if (literal >= end)
+			return;
+
+		writeVarint((UInt64)(end - literal - 1) << 1);
+		for (; literal < end; ++literal)
+			writeUnit(units[literal]);
+	};
+	for (size_t i = 0; i < units.size(); ) {
+		size_t j = i + 1;
+		while (j < units.size() && units[j] == units[i])
+			++j;
+		if (j - i >= ENCODING_RLE_MIN_RUN) {
+			flush(i);
+			writeVarint(((UInt64)(j - i - 1) << 1) | 1);
+			writeUnit(units[i]);
+			literal = j;
+		}
+		i = j;
+	}
+	flush(units.size());
+
+	// Finish.
+	return Base64::fromBytes(val, bytes.get());
+}
+
+/* ===========================================================================} */
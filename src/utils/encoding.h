@@ -11,6 +11,7 @@
 
 #include "../gbbasic.h"
 #include <string>
+#include <vector>
 
 /*
 ** {===========================================================================
@@ -135,6 +136,12 @@ public:
 	 * @param[out] val
 	 */
 	static bool toBytes(class Bytes* val, const std::string &str);
+	/**
+	 * @brief Decodes base64 string to bytes.
+	 *
+	 * @param[out] val
+	 */
+	static bool toBytes(class Bytes* val, const char* str, size_t len);
 	/**
 	 * @brief Encodes bytes to base64 string.
 	 *
@@ -171,4 +178,37 @@ public:
 
 /* ===========================================================================} */
 
+/*
+** {===========================================================================
+** RLE
+*/
+
+/**
+ * @brief Run-length encoding utilities for planes of pixels or cels.
+ *
+ * @details Encoded text is base64 of a versioned byte stream. Values in the
+ *   range of [0, 3] are packed as 2-bit indices, values in [0, 255] as bytes,
+ *   others as zigzag varints; the packed units are then run-length encoded.
+ */
+class Rle {
+public:
+	typedef std::vector<int> Values;
+
+public:
+	/**
+	 * @brief Decodes run-length encoded base64 text to values.
+	 *
+	 * @param[out] val
+	 */
+	static bool toValues(Values &val, const char* str, size_t len);
+	/**
+	 * @brief Encodes values to run-length encoded base64 text.
+	 *
+	 * @param[out] val
+	 */
+	static bool fromValues(std::string &val, const Values &data);
+};
+
+/* ===========================================================================} */
+
 #endif /* __ENCODING_H__ */
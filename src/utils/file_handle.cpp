@@ -9,6 +9,14 @@
 #include "bytes.h"
 #include "encoding.h"
 #include "file_handle.h"
+#if defined GBBASIC_OS_WIN
+#	include <Windows.h>
+#elif !defined GBBASIC_OS_HTML
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif /* Platform macro. */
 
 /*
 ** {===========================================================================
@@ -516,3 +524,131 @@ void File::destroy(File* ptr) {
 }
 
 /* ===========================================================================} */
+
+/*
+** {===========================================================================
+** File mapping
+*/
+
+class FileMappingImpl : public FileMapping {
+private:
+	const char* _data = nullptr;
+	size_t _size = 0;
+#if defined GBBASIC_OS_WIN
+	HANDLE _file = INVALID_HANDLE_VALUE;
+	HANDLE _mapping = nullptr;
+#endif /* GBBASIC_OS_WIN */
+
+public:
+	FileMappingImpl() {
+	}
+	virtual ~FileMappingImpl() override {
+		close();
+	}
+
+	virtual unsigned type(void) const override {
+		return TYPE();
+	}
+
+	virtual const char* data(void) const override {
+		return _data;
+	}
+	virtual size_t size(void) const override {
+		return _size;
+	}
+
+	virtual bool open(const char* path) override {
+		close();
+
+#if defined GBBASIC_OS_WIN
+		const std::wstring wstr = Unicode::toWide(path);
+		_file = CreateFileW(wstr.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER len;
+		if (!GetFileSizeEx(_file, &len) || len.QuadPart <= 0) { // Empty file cannot be mapped.
+			close();
+
+			return false;
+		}
+
+		_mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!_mapping) {
+			close();
+
+			return false;
+		}
+
+		_data = (const char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!_data) {
+			close();
+
+			return false;
+		}
+		_size = (size_t)len.QuadPart;
+
+		return true;
+#elif defined GBBASIC_OS_HTML
+		(void)path;
+
+		return false;
+#else /* Platform macro. */
+		const std::string osstr = Unicode::toOs(path);
+		const int fd = ::open(osstr.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) { // Empty file cannot be mapped.
+			::close(fd);
+
+			return false;
+		}
+
+		void* ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // The mapping keeps its own reference to the file.
+		if (ptr == MAP_FAILED)
+			return false;
+
+		_data = (const char*)ptr;
+		_size = (size_t)st.st_size;
+
+		return true;
+#endif /* Platform macro. */
+	}
+	virtual bool close(void) override {
+		const bool result = !!_data;
+
+#if defined GBBASIC_OS_WIN
+		if (_data)
+			UnmapViewOfFile(_data);
+		if (_mapping)
+			CloseHandle(_mapping);
+		if (_file != INVALID_HANDLE_VALUE)
+			CloseHandle(_file);
+		_mapping = nullptr;
+		_file = INVALID_HANDLE_VALUE;
+#elif !defined GBBASIC_OS_HTML
+		if (_data)
+			munmap((void*)_data, _size);
+#endif /* Platform macro. */
+		_data = nullptr;
+		_size = 0;
+
+		return result;
+	}
+};
+
+FileMapping* FileMapping::create(void) {
+	FileMappingImpl* result = new FileMappingImpl();
+
+	return result;
+}
+
+void FileMapping::destroy(FileMapping* ptr) {
+	FileMappingImpl* impl = static_cast<FileMappingImpl*>(ptr);
+	delete impl;
+}
+
+/* ===========================================================================} */
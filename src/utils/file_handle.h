@@ -40,4 +40,35 @@ public:
 
 /* ===========================================================================} */
 
+/*
+** {===========================================================================
+** File mapping
+*/
+
+/**
+ * @brief Read-only memory mapping of a whole file. Not supported by all
+ *   platforms, `open(...)` fails in that case, then read the file instead.
+ */
+class FileMapping : public virtual Object {
+public:
+	typedef std::shared_ptr<FileMapping> Ptr;
+
+public:
+	GBBASIC_CLASS_TYPE('F', 'M', 'A', 'P')
+
+	/**
+	 * @brief Gets the mapped content, valid until closed.
+	 */
+	virtual const char* data(void) const = 0;
+	virtual size_t size(void) const = 0;
+
+	virtual bool open(const char* path) = 0;
+	virtual bool close(void) = 0;
+
+	static FileMapping* create(void);
+	static void destroy(FileMapping* ptr);
+};
+
+/* ===========================================================================} */
+
 #endif /* __FILE_H__ */
@@ -344,6 +344,29 @@ bool Path::existsFile(const char* path) {
 	return (stat(osstr.c_str(), &buf) == 0) && ((buf.st_mode & S_IFDIR) == 0);
 }
 
+bool Path::stampFile(const char* path, long long* size, long long* modified) {
+	if (size)
+		*size = 0;
+	if (modified)
+		*modified = 0;
+
+	if (!path || !(*path))
+		return false;
+
+	const std::string osstr = Unicode::toOs(path);
+
+	struct stat buf;
+	if (stat(osstr.c_str(), &buf) != 0 || (buf.st_mode & S_IFDIR) != 0)
+		return false;
+
+	if (size)
+		*size = (long long)buf.st_size;
+	if (modified)
+		*modified = (long long)buf.st_mtime;
+
+	return true;
+}
+
 bool Path::existsDirectory(const char* path) {
 	if (!path || !(*path))
 		return false;
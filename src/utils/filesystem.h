@@ -59,6 +59,11 @@ public:
 
 	static size_t countFile(const char* path);
 	static bool existsFile(const char* path);
+	/**
+	 * @param[out] size In bytes.
+	 * @param[out] modified Last modification time, in seconds since epoch.
+	 */
+	static bool stampFile(const char* path, long long* size /* nullable */, long long* modified /* nullable */);
 	static bool existsDirectory(const char* path);
 	static bool copyFile(const char* src, const char* dst);
 	static bool copyDirectory(const char* src, const char* dst);
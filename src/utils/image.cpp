@@ -7,6 +7,7 @@
 */
 
 #include "bytes.h"
+#include "encoding.h"
 #include "image.h"
 #include "plus.h"
 #define STB_IMAGE_IMPLEMENTATION
@@ -49,6 +50,40 @@ static const Byte IMAGE_COLORED_HEADER_BYTES[] = IMAGE_COLORED_HEADER;
 
 /* ===========================================================================} */
 
+/*
+** {===========================================================================
+** Utilities
+*/
+
+/**
+ * @brief Lookup tables of the channel values scaled as blending with
+ *   `col * f + col_ * (1.0f - f)`, indexed by alpha then channel value.
+ */
+struct ImageBlending {
+	Byte source[256][256];
+	Byte destination[256][256];
+
+	ImageBlending() {
+		for (int a = 0; a < 256; ++a) {
+			const float f = Math::clamp((float)a / 255, 0.0f, 1.0f);
+			const Real f0 = f;
+			const Real f1 = 1.0f - f;
+			for (int c = 0; c < 256; ++c) {
+				source[a][c] = (Byte)Math::clamp(c * f0, (Real)0.0f, (Real)255.0f);
+				destination[a][c] = (Byte)Math::clamp(c * f1, (Real)0.0f, (Real)255.0f);
+			}
+		}
+	}
+
+	static const ImageBlending &instance(void) {
+		static const ImageBlending result;
+
+		return result;
+	}
+};
+
+/* ===========================================================================} */
+
 /*
 ** {===========================================================================
 ** Image
@@ -569,6 +604,61 @@ public:
 
 		return true;
 	}
+	virtual const Byte* row(int y) const override {
+		if (y < 0 || y >= _height || !_pixels)
+			return nullptr;
+
+		return &_pixels[y * _width * _channels];
+	}
+	virtual bool get(int x, int y, int w, int h, Byte* val) const override {
+		if (!val || !_pixels)
+			return false;
+
+		if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > _width || y + h > _height)
+			return false;
+
+		const int n = w * _channels;
+		for (int j = 0; j < h; ++j)
+			memcpy(val + j * n, &_pixels[(x + (y + j) * _width) * _channels], n);
+
+		return true;
+	}
+	virtual bool set(int x, int y, int w, int h, const Byte* val) override {
+		if (!val || !_pixels)
+			return false;
+
+		if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > _width || y + h > _height)
+			return false;
+
+		// The surface is created upon `_pixels`, so it sees the writes as well.
+		bool blank = _blank;
+		if (_palettedBits) {
+			const int limit = 1 << _palettedBits;
+			for (int j = 0; j < h; ++j) {
+				const Byte* src = val + j * w;
+				Byte* dst = &_pixels[x + (y + j) * _width];
+				for (int i = 0; i < w; ++i) {
+					const Byte idx = src[i];
+					if (idx >= limit)
+						continue;
+
+					dst[i] = idx;
+					blank &= idx == _transparentIndex;
+				}
+			}
+		} else {
+			const int n = w * _channels;
+			for (int j = 0; j < h; ++j) {
+				const Byte* src = val + j * n;
+				memcpy(&_pixels[(x + (y + j) * _width) * _channels], src, n);
+				for (int i = 3; i < n && blank; i += _channels)
+					blank = src[i] == 0;
+			}
+		}
+		_blank = blank;
+
+		return true;
+	}
 
 	virtual Image* quantized2Bpp(void) const override {
 		Indexed::Ptr palette = Indexed::Ptr(Indexed::create(GBBASIC_PALETTE_PER_GROUP_COUNT));
@@ -610,14 +700,31 @@ public:
 		return quantizeLinear(colors, colorCount);
 	}
 	virtual bool realize(void) override {
-		return realize(
-			[this] (int /* x */, int /* y */, Byte idx) -> Colour {
-				Colour col;
-				_palette->get(idx, col);
+		if (!_palettedBits)
+			return true;
+		if (!_palette)
+			return false;
 
-				return col;
-			}
-		);
+		Colour lookup[256];
+		for (int i = 0; i < (int)GBBASIC_COUNTOF(lookup); ++i)
+			_palette->get(i, lookup[i]);
+
+		const int size = _width * _height;
+		Colour* trueColPixels = (Colour*)malloc(size * sizeof(Colour));
+
+		for (int k = 0; k < size; ++k)
+			trueColPixels[k] = lookup[_pixels[k]];
+
+		free(_pixels);
+		_pixels = (Byte*)trueColPixels;
+
+		_palette = nullptr;
+		_palettedBits = 0;
+		_channels = 4;
+
+		surface(nullptr);
+
+		return true;
 	}
 	virtual bool realize(PaletteResolver resolve) override {
 		if (!_palettedBits)
@@ -628,13 +735,11 @@ public:
 		const int size = _width * _height;
 		Colour* trueColPixels = (Colour*)malloc(size * sizeof(Colour));
 
-		for (int k = 0; k < size; ++k) {
-			const std::div_t div = std::div(k, _width);
-			const int x = div.rem;
-			const int y = div.quot;
-			const Byte idx = _pixels[k];
-			const Colour col = resolve(x, y, idx);
-			trueColPixels[k] = col;
+		for (int y = 0, k = 0; y < _height; ++y) {
+			for (int x = 0; x < _width; ++x, ++k) {
+				const Byte idx = _pixels[k];
+				trueColPixels[k] = resolve(x, y, idx);
+			}
 		}
 
 		free(_pixels);
@@ -811,6 +916,76 @@ public:
 			w = dst->width();
 		if (h == 0)
 			h = dst->height();
+
+		// Go through the rows directly, with the same result as plotting one by one.
+		ImageImpl* dst_ = static_cast<ImageImpl*>(dst);
+		if (_palettedBits && dst_->_palettedBits) {
+			int x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+			blitRange(w, sx, _width, x, dst_->_width, hFlip, x0, x1);
+			blitRange(h, sy, _height, y, dst_->_height, vFlip, y0, y1);
+			const int limit = 1 << dst_->_palettedBits;
+			bool blank = dst_->_blank;
+			for (int y_ = y0; y_ < y1; ++y_) {
+				const Byte* src = &_pixels[(sy + y_) * _width + sx];
+				Byte* dst__ = &dst_->_pixels[(vFlip ? y + (h - y_ - 1) : y + y_) * dst_->_width];
+				for (int x_ = x0; x_ < x1; ++x_) {
+					const Byte idx = src[x_];
+					if (idx >= limit)
+						continue;
+
+					dst__[hFlip ? x + (w - x_ - 1) : x + x_] = idx;
+					blank &= idx == dst_->_transparentIndex;
+				}
+			}
+			dst_->_blank = blank;
+
+			return true;
+		} else if (_palettedBits) {
+			return true; // A colored destination takes no index.
+		} else if (dst_->_palettedBits) {
+			return true; // A paletted destination takes no color.
+		} else if (_channels == 4 && dst_->_channels == 4) {
+			int x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+			blitRange(w, 0, w, x, dst_->_width, hFlip, x0, x1); // Pixels out of the source are cleared rather than clipped.
+			blitRange(h, 0, h, y, dst_->_height, vFlip, y0, y1);
+			const ImageBlending &blending = ImageBlending::instance();
+			bool blank = dst_->_blank;
+			for (int y_ = y0; y_ < y1; ++y_) {
+				const int sy_ = sy + y_;
+				const Byte* src = sy_ >= 0 && sy_ < _height ? &_pixels[sy_ * _width * 4] : nullptr;
+				Byte* dst__ = &dst_->_pixels[(vFlip ? y + (h - y_ - 1) : y + y_) * dst_->_width * 4];
+				for (int x_ = x0; x_ < x1; ++x_) {
+					const int sx_ = sx + x_;
+					Byte* col_ = &dst__[(hFlip ? x + (w - x_ - 1) : x + x_) * 4]; // RGBA.
+					if (!src || sx_ < 0 || sx_ >= _width) {
+						col_[0] = col_[1] = col_[2] = 255;
+						col_[3] = 0;
+
+						continue;
+					}
+
+					const Byte* col = &src[sx_ * 4]; // RGBA.
+					Byte alpha_ = col[3];
+					if (alpha < 255) {
+						alpha_ = (Byte)(((float)alpha_ / 255) * ((float)alpha / 255) * 255);
+					}
+					if (alpha_ < 255) {
+						const Byte* f0 = blending.source[alpha_];
+						const Byte* f1 = blending.destination[alpha_];
+						for (int c = 0; c < 4; ++c)
+							col_[c] = (Byte)Math::min(f0[col[c]] + f1[col_[c]], 255);
+					} else {
+						memcpy(col_, col, 4);
+					}
+					if (col_[3] > 0)
+						blank = false;
+				}
+			}
+			dst_->_blank = blank;
+
+			return true;
+		}
+
 		for (int y_ = 0; y_ < h; ++y_) {
 			const int sy_ = sy + y_;
 			const int dy_ = vFlip ?
@@ -1148,25 +1323,31 @@ public:
 		jvaldepth.SetInt(_palettedBits);
 		val.AddMember(jstrdetpth, jvaldepth, doc.GetAllocator());
 
-		rapidjson::Value jstrdata;
-		jstrdata.SetString("data", doc.GetAllocator());
-		rapidjson::Value jvaldata;
-		jvaldata.SetArray();
+		Rle::Values values;
+		values.reserve(_width * _height);
 		for (int j = 0; j < _height; ++j) {
 			for (int i = 0; i < _width; ++i) {
 				if (_palettedBits) {
 					int idx = 0;
 					get(i, j, idx);
 
-					jvaldata.PushBack(idx, doc.GetAllocator());
+					values.push_back(idx);
 				} else {
 					Colour col;
 					get(i, j, col);
 
-					jvaldata.PushBack(col.toRGBA(), doc.GetAllocator());
+					values.push_back((int)col.toRGBA());
 				}
 			}
 		}
+		std::string str;
+		if (!Rle::fromValues(str, values))
+			return false;
+
+		rapidjson::Value jstrdata;
+		jstrdata.SetString("data", doc.GetAllocator());
+		rapidjson::Value jvaldata;
+		jvaldata.SetString(str.c_str(), (rapidjson::SizeType)str.length(), doc.GetAllocator());
 		val.AddMember(jstrdata, jvaldata, doc.GetAllocator());
 
 		return true;
@@ -1198,7 +1379,35 @@ public:
 			return false;
 
 		rapidjson::Value::ConstMemberIterator jdata = val.FindMember("data");
-		if (jdata != val.MemberEnd() && jdata->value.IsArray()) {
+		if (jdata != val.MemberEnd() && jdata->value.IsString()) {
+			Rle::Values values;
+			if (!Rle::toValues(values, jdata->value.GetString(), jdata->value.GetStringLength()))
+				return false;
+			if ((int)values.size() != width * height)
+				return false;
+
+			if (_palettedBits) {
+				const int maxIndex = (1 << _palettedBits) - 1;
+				for (int idx = 0; idx < width * height; ++idx) { // Fresh from `fromBlank(...)`, no surface to sync.
+					const int index = values[idx];
+					if (index < 0 || index > maxIndex)
+						continue;
+
+					_pixels[idx] = (Byte)index;
+					if (index != _transparentIndex)
+						_blank = false;
+				}
+			} else {
+				int idx = 0;
+				for (int j = 0; j < height; ++j) {
+					for (int i = 0; i < width; ++i) {
+						Colour col;
+						col.fromRGBA((UInt32)values[idx++]);
+						set(i, j, col);
+					}
+				}
+			}
+		} else if (jdata != val.MemberEnd() && jdata->value.IsArray()) { // Legacy format, one element per pixel.
 			rapidjson::Value::ConstArray data = jdata->value.GetArray();
 			int idx = 0;
 			for (int j = 0; j < height; ++j) {
@@ -1297,16 +1506,46 @@ private:
 		_quantizationAlphaWeight = 4;
 	}
 
+	/**
+	 * @brief Clips a blitting span to the offsets `[begin, end)` which are inside
+	 *   both the source and the destination.
+	 */
+	static void blitRange(int n, int s, int srcLen, int d, int dstLen, bool flip, int &begin, int &end) {
+		begin = Math::max(0, -s);
+		end = Math::min(n, srcLen - s);
+		if (flip) {
+			begin = Math::max(begin, d + n - dstLen);
+			end = Math::min(end, d + n);
+		} else {
+			begin = Math::max(begin, -d);
+			end = Math::min(end, dstLen - d);
+		}
+	}
+
 	bool quantizeNearest(const Colour* colors, int colorCount) {
 		if (_palettedBits)
 			return true;
 
+		struct Match {
+			UInt32 key = 0;
+			int index = -1;
+		};
+
 		const int size = _width * _height;
 		const Colour* const palette = colors;
 		Byte* palettedPixels = (Byte*)malloc(size * sizeof(Byte));
+		Match matches[256]; // Images tend to repeat a few colors, remember the recent matches.
 
 		for (int k = 0; k < size; ++k) {
 			const Colour c = ((Colour*)_pixels)[k];
+			const UInt32 key = c.toRGBA();
+			Match &match = matches[(UInt32)(key * 2654435761u) >> 24];
+			if (match.index >= 0 && match.key == key) {
+				palettedPixels[k] = (Byte)match.index;
+
+				continue;
+			}
+
 			int bestd = std::numeric_limits<int>::max(), best = -1;
 			for (int i = 0; i < colorCount; ++i) {
 				const int red = (int)palette[i].r - (int)c.r;
@@ -1326,6 +1565,8 @@ private:
 			if (best == -1)
 				best = 0;
 			palettedPixels[k] = (Byte)best;
+			match.key = key;
+			match.index = best;
 		}
 
 		free(_pixels);
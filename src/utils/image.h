@@ -95,6 +95,27 @@ public:
 	 */
 	virtual bool get(int x, int y, int &index) const = 0;
 	virtual bool set(int x, int y, int index) = 0;
+	/**
+	 * @brief Gets a row of pixels for bulk reading, `width() * channels()`
+	 *   bytes, one index per byte if paletted, otherwise RGBA.
+	 *
+	 * @return `nullptr` if out of bounds.
+	 */
+	virtual const Byte* row(int y) const = 0;
+	/**
+	 * @brief Reads an area of pixels in bulk, in the same layout as `row(...)`.
+	 *
+	 * @param[out] val `w * h * channels()` bytes.
+	 * @return `false` if the area is not fully inside the image.
+	 */
+	virtual bool get(int x, int y, int w, int h, Byte* val) const = 0;
+	/**
+	 * @brief Writes an area of pixels in bulk, in the same layout as `row(...)`;
+	 *   indices out of the palette are skipped as with `set(x, y, index)`.
+	 *
+	 * @return `false` if the area is not fully inside the image.
+	 */
+	virtual bool set(int x, int y, int w, int h, const Byte* val) = 0;
 
 	virtual Image* quantized2Bpp(void) const = 0;
 
@@ -6,6 +6,7 @@
 ** For the latest info, see https://paladin-t.github.io/kits/gbb/
 */
 
+#include "encoding.h"
 #include "map.h"
 #include "renderer.h"
 #include <SDL.h>
@@ -623,16 +624,17 @@ public:
 		val.AddMember(jstrw, jvalw, doc.GetAllocator());
 		val.AddMember(jstrh, jvalh, doc.GetAllocator());
 
+		Cels cels(_width * _height);
+		if (!cels.empty())
+			data(&cels.front(), cels.size());
+		std::string str;
+		if (!Rle::fromValues(str, cels))
+			return false;
+
 		rapidjson::Value jstrdata;
 		jstrdata.SetString("data", doc.GetAllocator());
 		rapidjson::Value jvaldata;
-		jvaldata.SetArray();
-		Cels cels(_width * _height);
-		if (!cels.empty()) {
-			data(&cels.front(), cels.size());
-			for (int cel : cels)
-				jvaldata.PushBack(cel, doc.GetAllocator());
-		}
+		jvaldata.SetString(str.c_str(), (rapidjson::SizeType)str.length(), doc.GetAllocator());
 		val.AddMember(jstrdata, jvaldata, doc.GetAllocator());
 
 		return true;
@@ -685,16 +687,25 @@ public:
 		const int mapHeight = jh->value.GetInt();
 
 		rapidjson::Value::ConstMemberIterator jdata = val.FindMember("data");
-		if (jdata == val.MemberEnd() || !jdata->value.IsArray())
+		if (jdata == val.MemberEnd())
 			return false;
 
-		rapidjson::Value::ConstArray data = jdata->value.GetArray();
 		Cels cels;
-		for (rapidjson::SizeType i = 0; i < data.Size() && (int)i < mapWidth * mapHeight; ++i) {
-			if (data[i].IsInt())
-				cels.push_back(data[i].GetInt());
-			else
-				cels.push_back(0);
+		if (jdata->value.IsString()) {
+			if (!Rle::toValues(cels, jdata->value.GetString(), jdata->value.GetStringLength()))
+				return false;
+			if ((int)cels.size() != mapWidth * mapHeight)
+				return false;
+		} else if (jdata->value.IsArray()) { // Legacy format, one element per cel.
+			rapidjson::Value::ConstArray data = jdata->value.GetArray();
+			for (rapidjson::SizeType i = 0; i < data.Size() && (int)i < mapWidth * mapHeight; ++i) {
+				if (data[i].IsInt())
+					cels.push_back(data[i].GetInt());
+				else
+					cels.push_back(0);
+			}
+		} else {
+			return false;
 		}
 
 		Tiles tiles_(texture, Math::Vec2i(tileCountX, tileCountY));
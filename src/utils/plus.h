@@ -17,6 +17,7 @@
 #	include <atomic>
 #endif /* GBBASIC_MULTITHREAD_ENABLED */
 #include <mutex>
+#include <vector>
 
 /*
 ** {===========================================================================
@@ -229,6 +230,61 @@ public:
 	}
 };
 
+/**
+ * @brief Single-producer single-consumer ring buffer, it is lock-free when
+ *   multithreading is enabled. The slots are allocated once and reused in
+ *   place, the producer fills the slot returned by `acquire()` then calls
+ *   `commit()`, the consumer reads the slot returned by `front()` then calls
+ *   `pop()`.
+ */
+template<typename T> class RingBuffer : public NonCopyable {
+private:
+	std::vector<T> _slots;
+	Atomic<size_t> _head; // Written by the consumer.
+	Atomic<size_t> _tail; // Written by the producer.
+
+public:
+	RingBuffer(size_t capacity) : _slots(capacity + 1), _head(0), _tail(0) {
+	}
+
+	size_t capacity(void) const {
+		return _slots.size() - 1;
+	}
+	size_t count(void) const {
+		const size_t head = _head;
+		const size_t tail = _tail;
+
+		return (tail + _slots.size() - head) % _slots.size();
+	}
+	bool empty(void) const {
+		return (size_t)_head == (size_t)_tail;
+	}
+
+	T* acquire(void) {
+		const size_t tail = _tail;
+		if ((tail + 1) % _slots.size() == (size_t)_head)
+			return nullptr;
+
+		return &_slots[tail];
+	}
+	void commit(void) {
+		const size_t tail = _tail;
+		_tail = (tail + 1) % _slots.size();
+	}
+
+	T* front(void) {
+		const size_t head = _head;
+		if (head == (size_t)_tail)
+			return nullptr;
+
+		return &_slots[head];
+	}
+	void pop(void) {
+		const size_t head = _head;
+		_head = (head + 1) % _slots.size();
+	}
+};
+
 /**
  * @brief Variable guard.
  */
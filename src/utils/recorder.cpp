@@ -413,7 +413,7 @@ private:
 			while (!workQueue->allProcessed()) {
 				workQueue->update();
 
-				DateTime::sleep(STEP);
+				workQueue->wait(STEP);
 				Platform::idle();
 			}
 
@@ -445,7 +445,7 @@ private:
 			while (!workQueue->allProcessed()) {
 				workQueue->update();
 
-				DateTime::sleep(STEP);
+				workQueue->wait(STEP);
 				Platform::idle();
 			}
 			const int n = (int)imgArray.size();
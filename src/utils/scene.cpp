@@ -6,6 +6,7 @@
 ** For the latest info, see https://paladin-t.github.io/kits/gbb/
 */
 
+#include "encoding.h"
 #include "scene.h"
 
 /*
@@ -385,8 +386,11 @@ public:
 
 			Cels cels(ptr->width() * ptr->height());
 			ptr->data(&cels.front(), cels.size());
-			for (int cel : cels)
-				val.PushBack(cel, doc.GetAllocator());
+			std::string str;
+			if (!Rle::fromValues(str, cels))
+				return;
+
+			val.SetString(str.c_str(), (rapidjson::SizeType)str.length(), doc.GetAllocator());
 		};
 
 		val.SetObject();
@@ -509,7 +513,13 @@ public:
 
 		auto parse = [] (Cels &cels, const rapidjson::Value &val, int w, int h) -> void {
 			cels.clear();
-			rapidjson::Value::ConstArray data = val.GetArray();
+			if (val.IsString()) {
+				if (!Rle::toValues(cels, val.GetString(), val.GetStringLength()) || (int)cels.size() != w * h)
+					cels.clear();
+
+				return;
+			}
+			rapidjson::Value::ConstArray data = val.GetArray(); // Legacy format, one element per cel.
 			for (rapidjson::SizeType i = 0; i < data.Size() && (int)i < w * h; ++i) {
 				if (data[i].IsInt())
 					cels.push_back(data[i].GetInt());
@@ -533,11 +543,11 @@ public:
 		const int mapHeight = jh->value.GetInt();
 
 		rapidjson::Value::ConstMemberIterator jprops = val.FindMember("properties");
-		if (jprops == val.MemberEnd() || !jprops->value.IsArray())
+		if (jprops == val.MemberEnd() || (!jprops->value.IsArray() && !jprops->value.IsString()))
 			return false;
 
 		rapidjson::Value::ConstMemberIterator jactors = val.FindMember("actors");
-		if (jactors == val.MemberEnd() || !jactors->value.IsArray())
+		if (jactors == val.MemberEnd() || (!jactors->value.IsArray() && !jactors->value.IsString()))
 			return false;
 
 		rapidjson::Value::ConstMemberIterator jtriggers = val.FindMember("triggers");
@@ -581,8 +591,7 @@ public:
 
 		Cels celactors;
 		Map::Ptr actorsptr(Map::create(&actorsTiles, true));
-		if (jactors->value.IsArray())
-			parse(celactors, jactors->value, mapWidth, mapHeight);
+		parse(celactors, jactors->value, mapWidth, mapHeight);
 		if (celactors.empty()) {
 			if (!actorsptr->load(INVALID_ACTOR(), mapWidth, mapHeight))
 				return false;
@@ -12,6 +12,9 @@
 #include "work_queue.h"
 #include <list>
 #if WORK_QUEUE_THREAD_ENABLED
+#	include <atomic>
+#	include <condition_variable>
+#	include <deque>
 #	include <thread>
 #endif /* WORK_QUEUE_THREAD_ENABLED */
 
@@ -181,16 +184,30 @@ typedef std::list<WorkTask*> TaskList;
 #if WORK_QUEUE_THREAD_ENABLED
 typedef std::vector<std::thread> ThreadArray;
 
+typedef std::deque<WorkTask*> TaskDeque;
+
+/**
+ * @brief Per worker task deque. Tasks are pushed to the back, and both the
+ *   owner worker and the others take them from the front, oldest first.
+ */
+struct WorkQueueWorker : public NonCopyable {
+	Mutex lock;
+	TaskDeque tasks;
+};
+
+typedef std::vector<std::unique_ptr<WorkQueueWorker> > WorkerArray;
+
 struct WorkQueueParams {
 private:
 	class WorkQueueImpl* _workQueue = nullptr;
-	Mutex _requestLock;
+	Mutex _signalLock;
+	std::condition_variable_any _signal;
 	Mutex _responseLock;
-	Mutex _quitLock;
+	std::condition_variable_any _responded;
+	std::atomic<bool> _quit;
 
 public:
-	WorkQueueParams() {
-		_quitLock.lock();
+	WorkQueueParams() : _quit(false) {
 	}
 	~WorkQueueParams() {
 	}
@@ -202,58 +219,60 @@ public:
 		_workQueue = impl;
 	}
 
-	int lockRequest(void) {
-		_requestLock.lock();
-
-		return 0;
+	Mutex &responseLock(void) {
+		return _responseLock;
 	}
-	int unlockRequest(void) {
-		_requestLock.unlock();
-
-		return 0;
+	std::condition_variable_any &responded(void) {
+		return _responded;
 	}
-	int lockResponse(void) {
-		_responseLock.lock();
 
-		return 0;
+	/**
+	 * @brief Wakes up one idle worker, called after a task is scheduled.
+	 */
+	void notifyOne(void) {
+		LockGuard<decltype(_signalLock)> guard(_signalLock); // Avoid lost wakeup between checking and waiting.
+
+		_signal.notify_one();
 	}
-	int unlockResponse(void) {
-		_responseLock.unlock();
+	/**
+	 * @brief Blocks an idle worker until `ready` is true or quit is raised.
+	 */
+	template<typename Pred> void idle(Pred ready) {
+		std::unique_lock<decltype(_signalLock)> guard(_signalLock);
 
-		return 0;
+		_signal.wait(guard, [this, &ready] (void) -> bool { return _quit || ready(); });
 	}
 
 	void raiseQuit(void) {
-		_quitLock.unlock();
-	}
-	bool needQuit(void) {
-		if (_quitLock.tryLock()) {
-			_quitLock.unlock();
+		LockGuard<decltype(_signalLock)> guard(_signalLock);
 
-			return true;
-		} else {
-			return false;
-		}
+		_quit = true;
+		_signal.notify_all();
+	}
+	bool needQuit(void) const {
+		return _quit;
 	}
 };
 
 class WorkQueueImpl : public WorkQueueInternal {
 private:
-	WorkTask::RequestId _requestSeed = 0;
+	std::atomic<WorkTask::RequestId> _requestSeed;
 	WorkQueueParams* _params = nullptr;
 	int _threadCount = 0;
 	ThreadArray _threads;
-	TaskList _taskList;
+	WorkerArray _workers;
+	std::atomic<unsigned> _nextWorker;
+	std::atomic<long> _scheduled;
 	TaskList _responseList;
-	long _inQueue = 0;
+	std::atomic<long> _inQueue;
 
 public:
-	WorkQueueImpl() {
+	WorkQueueImpl() : _requestSeed(0), _nextWorker(0), _scheduled(0), _inQueue(0) {
 	}
 	virtual ~WorkQueueImpl() override {
 	}
 
-	virtual bool startup(const char* usage, int threadCount, bool rare) override {
+	virtual bool startup(const char* usage, int threadCount, bool /* rare */) override {
 		if (_params)
 			return false;
 
@@ -263,8 +282,10 @@ public:
 		_params->workQueue(this);
 		if (_threadCount <= 0)
 			_threadCount = (int)threadsCount();
+		for (int i = 0; i < _threadCount; ++i)
+			_workers.push_back(std::unique_ptr<WorkQueueWorker>(new WorkQueueWorker()));
 		for (int i = 0; i < _threadCount; ++i) {
-			_threads.push_back(std::thread(_threadProc, usage, rare, i, (void*)_params));
+			_threads.push_back(std::thread(_threadProc, usage, i, (void*)_params));
 		}
 
 		return true;
@@ -279,6 +300,27 @@ public:
 			_threads[i].join();
 		_threads.clear();
 
+		// Purge.
+		for (; ; ) {
+			WorkTask* task = pop();
+			if (task) {
+				task->dispose();
+				delete task;
+			} else {
+				break;
+			}
+		}
+		for (; ; ) {
+			WorkTask* task = popResult();
+			if (task) {
+				task->dispose();
+				delete task;
+			} else {
+				break;
+			}
+		}
+		_workers.clear();
+
 		delete _params;
 		_params = nullptr;
 
@@ -290,45 +332,40 @@ public:
 	}
 
 	virtual WorkTask::RequestId push(WorkTask* task) override {
-		_params->lockRequest();
-
-		if (++_requestSeed == 0)
-			++_requestSeed;
-		WorkTask::RequestId reqid = _requestSeed;
+		WorkTask::RequestId reqid = ++_requestSeed;
+		if (reqid == 0)
+			reqid = ++_requestSeed;
 		task->requestId(reqid);
-		_taskList.push_back(task);
 		if (task->handleRequest())
 			task->handleRequest()(task);
 
 		incInQueue();
 
-		_params->unlockRequest();
+		schedule(task, _nextWorker++ % (unsigned)_workers.size());
 
 		return reqid;
 	}
 	virtual WorkTask* pop(void) override {
-		_params->lockRequest();
-
-		WorkTask* result = nullptr;
-		if (!_taskList.empty()) {
-			result = _taskList.front();
-			_taskList.pop_front();
+		for (size_t i = 0; i < _workers.size(); ++i) {
+			WorkTask* result = take((int)i);
+			if (result)
+				return result;
 		}
 
-		_params->unlockRequest();
-
-		return result;
+		return nullptr;
 	}
 
 	virtual void pushResult(WorkTask* task) override {
-		_params->lockResponse();
+		{
+			LockGuard<Mutex> guard(_params->responseLock());
 
-		_responseList.push_back(task);
+			_responseList.push_back(task);
+		}
 
-		_params->unlockResponse();
+		_params->responded().notify_all();
 	}
 	virtual WorkTask* popResult(void) override {
-		_params->lockResponse();
+		LockGuard<Mutex> guard(_params->responseLock());
 
 		WorkTask* result = nullptr;
 		if (!_responseList.empty()) {
@@ -338,8 +375,6 @@ public:
 			decInQueue();
 		}
 
-		_params->unlockResponse();
-
 		return result;
 	}
 
@@ -370,6 +405,29 @@ public:
 		}
 	}
 
+	virtual bool wait(int timeoutMs) override {
+		if (!_params)
+			return false;
+
+		std::unique_lock<Mutex> guard(_params->responseLock());
+
+		auto ready = [this] (void) -> bool {
+			return !_responseList.empty() || allProcessed();
+		};
+		if (timeoutMs < 0)
+			_params->responded().wait(guard, ready);
+		else
+			_params->responded().wait_for(guard, std::chrono::milliseconds(timeoutMs), ready);
+
+		return !_responseList.empty();
+	}
+	virtual void await(void) override {
+		while (!allProcessed()) {
+			wait(-1);
+			update();
+		}
+	}
+
 private:
 	unsigned threadsCount(void) const {
 		return 1; // Constant number of threads.
@@ -385,7 +443,46 @@ private:
 		return --_inQueue;
 	}
 
-	static void* _threadProc(const char* usage, bool rare, int idx, void* params) {
+	void schedule(WorkTask* task, unsigned idx) {
+		WorkQueueWorker* worker = _workers[idx].get();
+		{
+			LockGuard<decltype(worker->lock)> guard(worker->lock);
+
+			worker->tasks.push_back(task);
+		}
+		++_scheduled;
+
+		_params->notifyOne();
+	}
+	WorkTask* take(int idx) {
+		WorkQueueWorker* worker = _workers[idx].get();
+		LockGuard<decltype(worker->lock)> guard(worker->lock);
+
+		if (worker->tasks.empty())
+			return nullptr;
+
+		WorkTask* result = worker->tasks.front(); // The oldest, to keep the push order.
+		worker->tasks.pop_front();
+		--_scheduled;
+
+		return result;
+	}
+	WorkTask* next(int idx) {
+		WorkTask* result = take(idx); // Take from its own deque first.
+		if (result)
+			return result;
+
+		const int n = (int)_workers.size();
+		for (int i = 1; i < n; ++i) { // Then steal from the others.
+			result = take((idx + i) % n);
+			if (result)
+				return result;
+		}
+
+		return nullptr;
+	}
+
+	static void* _threadProc(const char* usage, int idx, void* params) {
 		// Prepare.
 		char name[32];
 		snprintf(name, sizeof(name), "WORKER %s %d", usage, idx);
@@ -397,59 +494,16 @@ private:
 		WorkQueueImpl* que = par->workQueue();
 
 		// Run until quit.
-		constexpr const int STEP = 10;
-		constexpr const int MAX_STEP = 640;
-		const long long HALF_SEC = DateTime::fromSeconds(0.5);
-		int step = STEP;
-		long long lastActiveTimestamp = -1;
 		while (!par->needQuit()) {
-			WorkTask* task = que->pop();
+			WorkTask* task = que->next(idx);
 			if (task) {
-				if (rare) {
-					if (lastActiveTimestamp != -1)
-						lastActiveTimestamp = -1;
-					if (step > STEP)                            // If the step value is not the default value then
-						step = STEP;                            // reset to the default value.
-				}
-
 				task->operate()(task);
 				if (task->done())
 					que->pushResult(task);
 				else
-					que->push(task);
-			} else {
-				if (rare) {
-					const long long now = DateTime::ticks();
-					if (lastActiveTimestamp == -1)
-						lastActiveTimestamp = now;
-					if (now - lastActiveTimestamp > HALF_SEC) { // If has been free for 0.5f and
-						if (step < MAX_STEP)                    // the sleep interval is less than ~0.64s then
-							step *= 2;                          // double the sleep interval.
-						lastActiveTimestamp = now;
-					}
-				}
-
-				DateTime::sleep(step);
-			}
-		}
-
-		// Purge.
-		for (; ; ) {
-			WorkTask* task = que->pop();
-			if (task) {
-				task->dispose();
-				delete task;
+					que->schedule(task, (unsigned)idx);
 			} else {
-				break;
-			}
-		}
-		for (; ; ) {
-			WorkTask* task = que->popResult();
-			if (task) {
-				task->dispose();
-				delete task;
-			} else {
-				break;
+				par->idle([que] (void) -> bool { return que->_scheduled > 0; });
 			}
 		}
 
@@ -599,6 +653,14 @@ public:
 		}
 	}
 
+	virtual bool wait(int /* timeoutMs */) override {
+		return !_responseList.empty(); // Tasks are processed immediately on push.
+	}
+	virtual void await(void) override {
+		while (!allProcessed())
+			update();
+	}
+
 private:
 	long getInQueue(void) const {
 		return _inQueue;
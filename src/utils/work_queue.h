@@ -148,6 +148,15 @@ class WorkQueue {
 public:
 	virtual ~WorkQueue();
 
+	/**
+	 * @param[in] usage The usage name for debugging.
+	 * @param[in] threadCount Number of worker threads, `<= 0` for one. The
+	 *   tasks are dealt to the workers round-robin, each worker starts its own
+	 *   in push order, and an idle one takes the oldest task of the others; so
+	 *   with one worker they start strictly first in first out.
+	 * @param[in] rare Kept for compatibility; idle workers block on a condition
+	 *   variable instead of polling, so there is nothing to back off from.
+	 */
 	virtual bool startup(const char* usage, int threadCount, bool rare = false) = 0;
 	virtual bool shutdown(void) = 0;
 
@@ -163,6 +172,20 @@ public:
 
 	virtual void update(void) = 0;
 
+	/**
+	 * @brief Blocks until there is any processed task ready for `update()`, or
+	 *   until timeout.
+	 *
+	 * @param[in] timeoutMs Timeout in milliseconds, `< 0` for infinite.
+	 * @return `true` if there is any processed task.
+	 */
+	virtual bool wait(int timeoutMs = -1) = 0;
+	/**
+	 * @brief Blocks and updates until all pushed tasks are processed, returns
+	 *   right after the last one is done.
+	 */
+	virtual void await(void) = 0;
+
 	static WorkQueue* create(void);
 	static void destroy(WorkQueue* ptr);
 };
@@ -24,6 +24,53 @@ void get_chunk(UINT8 * dst, UINT8 bank, UINT8 * ptr, UINT8 size) NONBANKED {
     SWITCH_ROM_BANK(_save);
 }
 
+UINT8 * get_tile(UINT8 * dst, UINT8 bank, UINT8 * ptr) NONBANKED {
+    UINT8 _save = CURRENT_BANK;
+    SWITCH_ROM_BANK(bank);
+    UINT8 * src = ptr;
+    UINT8 * next = NULL;
+    if (*src == TILE_OP_REPEAT) {
+        next = src + 3;
+        src -= (UINT16)src[1] | ((UINT16)src[2] << 8);
+    }
+    UINT8 n = 16;
+    while (n) {
+        const UINT8 op = *src++;
+        UINT8 cnt = (op & 0x0F) + 1;
+        switch (op & 0xF0) {
+        case TILE_OP_LITERAL:
+            n -= cnt;
+            while (cnt--)
+                *dst++ = *src++;
+
+            break;
+        case TILE_OP_BYTE_RUN:
+            n -= cnt;
+            while (cnt--)
+                *dst++ = *src;
+            ++src;
+
+            break;
+        case TILE_OP_WORD_RUN:
+            n -= cnt << 1;
+            while (cnt--) {
+                *dst++ = src[0];
+                *dst++ = src[1];
+            }
+            src += 2;
+
+            break;
+        default:
+            n = 0;
+
+            break;
+        }
+    }
+    SWITCH_ROM_BANK(_save);
+
+    return next ? next : src;
+}
+
 void call_v_bbp_oldcall(UINT8 a, UINT8 b, UINT8 bank, UINT8 * ptr, v_bbp_fn_oldcall func) NONBANKED {
     UINT8 _save = CURRENT_BANK;
     SWITCH_ROM_BANK(bank);
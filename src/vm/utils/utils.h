@@ -31,8 +31,15 @@
 #define ASSET_SOURCE_DATA                          2
 #define ASSET_SOURCE_FAR                           3
 
+#define TILE_COMPRESSED_FLAG                       0x8000 // Set in a far tiles pointer by the compiler for compressed tiles.
+#define TILE_OP_LITERAL                            0x00   // Followed by the bytes; count minus 1 in the low nibble.
+#define TILE_OP_BYTE_RUN                           0x10   // Followed by a byte to repeat; count minus 1 in the low nibble.
+#define TILE_OP_WORD_RUN                           0x20   // Followed by two bytes to repeat; count minus 1 in the low nibble.
+#define TILE_OP_REPEAT                             0xF0   // Followed by the 16-bit distance back to an earlier block.
+
 UINT8 get_uint8(UINT8 bank, UINT8 * ptr) NONBANKED;
 void get_chunk(UINT8 * dst, UINT8 bank, UINT8 * ptr, UINT8 size) NONBANKED;
+UINT8 * get_tile(UINT8 * dst, UINT8 bank, UINT8 * ptr) NONBANKED;
 inline INT8 get_int8(UINT8 bank, UINT8 * ptr) {
     union { INT8 val; UINT8 bytes[1]; } u;
     u.bytes[0] = get_uint8(bank, ptr);
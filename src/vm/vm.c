@@ -832,6 +832,9 @@ UINT16 script_memory[VM_HEAP_SIZE + (VM_MAX_CONTEXTS * VM_CONTEXT_STACK_SIZE)];
 // The contexts for executing scripts.
 SCRIPT_CTX CTXS[VM_MAX_CONTEXTS];
 SCRIPT_CTX * first_ctx, * free_ctxs;
+// The context being processed by `script_runner_update()`, it's exported
+// to be observable from the emulator.
+SCRIPT_CTX * executing_ctx;
 
 // The lock state.
 UINT8 vm_lock_state;
@@ -1011,36 +1014,36 @@ BOOLEAN script_detach_hthread(UINT8 ID) BANKED {
 // Processes all the contexts.
 UINT8 script_runner_update(void) NONBANKED {
     // Prepare.
-    static SCRIPT_CTX * old_ctx, * ctx;
+    static SCRIPT_CTX * old_ctx;
     BOOLEAN waitable = TRUE;
     UINT8 counter = INSTRUCTIONS_PER_QUANT;
 
     // If locked then execute the last context until it is unlocked or terminated.
-    if (!vm_lock_state) old_ctx = NULL, ctx = first_ctx;
+    if (!vm_lock_state) old_ctx = NULL, executing_ctx = first_ctx;
 
     // Iterate all the contexts.
-    while (ctx) {
+    while (executing_ctx) {
         // Prepare.
 #if VM_EXCEPTION_ENABLED
         vm_exception_code = EXCEPTION_CODE_NONE;
 #endif /* VM_EXCEPTION_ENABLED */
-        ctx->waitable = FALSE;
-        if ((ctx->terminated != FALSE) || (!VM_STEP(ctx))) {
+        executing_ctx->waitable = FALSE;
+        if ((executing_ctx->terminated != FALSE) || (!VM_STEP(executing_ctx))) {
             // Update the lock state.
-            vm_lock_state -= ctx->lock_count;
+            vm_lock_state -= executing_ctx->lock_count;
 
             // Update the handle if present.
-            if (ctx->hthread) *(ctx->hthread) |= (SCRIPT_TERMINATED | SCRIPT_FINISHED);
+            if (executing_ctx->hthread) *(executing_ctx->hthread) |= (SCRIPT_TERMINATED | SCRIPT_FINISHED);
 
             // The script is finished, remove from the linked list.
-            if (old_ctx) old_ctx->next = ctx->next;
-            if (first_ctx == ctx) first_ctx = ctx->next;
+            if (old_ctx) old_ctx->next = executing_ctx->next;
+            if (first_ctx == executing_ctx) first_ctx = executing_ctx->next;
 
             // Add the terminated context to the free contexts list.
-            ctx->next = free_ctxs, free_ctxs = ctx;
+            executing_ctx->next = free_ctxs, free_ctxs = executing_ctx;
 
             // Next context.
-            if (old_ctx) ctx = old_ctx->next; else ctx = first_ctx;
+            if (old_ctx) executing_ctx = old_ctx->next; else executing_ctx = first_ctx;
         } else {
             // Check exception.
 #if VM_EXCEPTION_ENABLED
@@ -1048,14 +1051,14 @@ UINT8 script_runner_update(void) NONBANKED {
 #endif /* VM_EXCEPTION_ENABLED */
 
             // Loop until waitable state or quant is expired.
-            if (!(ctx->waitable) && (counter--)) continue;
+            if (!(executing_ctx->waitable) && (counter--)) continue;
 
             // Exit while loop if the context switching is locked.
             if (vm_lock_state) break;
 
             // Switch to the next context.
-            waitable &= ctx->waitable;
-            old_ctx = ctx, ctx = ctx->next;
+            waitable &= executing_ctx->waitable;
+            old_ctx = executing_ctx, executing_ctx = executing_ctx->next;
             counter = INSTRUCTIONS_PER_QUANT;
         }
     }
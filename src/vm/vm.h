@@ -112,7 +112,7 @@ extern UINT16 script_memory[VM_HEAP_SIZE + (VM_MAX_CONTEXTS * VM_CONTEXT_STACK_S
 // `script_execute(...)`, `script_runner_update(...)` functions manipulate these
 // contexts.
 extern SCRIPT_CTX CTXS[VM_MAX_CONTEXTS];
-extern SCRIPT_CTX * first_ctx, * free_ctxs;
+extern SCRIPT_CTX * first_ctx, * free_ctxs, * executing_ctx;
 
 // Cursor of the data reading stream.
 extern UINT8 current_data_bank;
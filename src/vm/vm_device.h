@@ -31,7 +31,9 @@ BANKREF_EXTERN(VM_DEVICE_EXT)
 #define STREAMING_STATUS_BUSY          0x01
 // Streaming status: filled, program has finished writing.
 #define STREAMING_STATUS_FILLED        0x02
-// Streaming status: end-of-stream.
+// Streaming status: block published, see `STREAMING_BLOCK_ADDRESS_REG`.
+#define STREAMING_STATUS_BLOCK         0x04
+// Streaming status: end-of-stream, may be combined with a published block.
 #define STREAMING_STATUS_EOS           0x80
 
 // Register of the extension mark.
@@ -56,6 +58,12 @@ BANKREF_EXTERN(VM_DEVICE_EXT)
 #define TRANSFER_ADDRESS               0xFEB0
 // Size of the transfer area.
 #define TRANSFER_MAX_SIZE              0x40
+// Register of the address of the published streaming block, little-endian.
+#define STREAMING_BLOCK_ADDRESS_REG    0xFEF0
+// Register of the size of the published streaming block, little-endian.
+#define STREAMING_BLOCK_SIZE_REG       0xFEF2
+// Capacity of each streaming block, two blocks are filled in turn.
+#define STREAMING_BLOCK_SIZE           0x80
 
 /**< The device conventions. */
 
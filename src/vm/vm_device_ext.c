@@ -13,10 +13,29 @@ BANKREF(VM_DEVICE_EXT)
 
 /**< Streaming. */
 
+// The bytes are buffered, and handed over a block at a time; one block is
+// filled while the other one is being read by the device.
+static UINT8 stream_blocks[2][STREAMING_BLOCK_SIZE];
+static UINT8 stream_block_index;
+static UINT8 stream_block_size;
+
+static void stream_publish(UINT8 status) {
+    UINT8 * block = stream_blocks[stream_block_index];
+
+    *(UINT8 *)(STREAMING_STATUS_REG)            = STREAMING_STATUS_BUSY;
+    *(UINT8 *)(STREAMING_BLOCK_ADDRESS_REG)     = (UINT8)((UINT16)block);
+    *(UINT8 *)(STREAMING_BLOCK_ADDRESS_REG + 1) = (UINT8)((UINT16)block >> 8);
+    *(UINT8 *)(STREAMING_BLOCK_SIZE_REG)        = stream_block_size;
+    *(UINT8 *)(STREAMING_BLOCK_SIZE_REG + 1)    = 0;
+    *(UINT8 *)(STREAMING_STATUS_REG)            = status;
+
+    stream_block_index ^= 1;
+    stream_block_size = 0;
+}
+
 void vm_stream(SCRIPT_CTX * THIS, UINT8 status) OLDCALL BANKED {
-    UINT8 * reg  = (UINT8 *)STREAMING_STATUS_REG;
-    UINT8 * addr = (UINT8 *)STREAMING_ADDRESS;
-    UINT16 val   = 0;
+    UINT8 * reg = (UINT8 *)STREAMING_STATUS_REG;
+    UINT16 val  = 0;
 
     if (status == STREAMING_STATUS_FILLED)
         val = (UINT16)*(--THIS->stack_ptr);
@@ -24,8 +43,9 @@ void vm_stream(SCRIPT_CTX * THIS, UINT8 status) OLDCALL BANKED {
     if (!(device_type & DEVICE_TYPE_GBB)) // Ignore streaming if extension features are not supported.
         return;
 
-    // Check for streaming status.
-    if (*reg != STREAMING_STATUS_READY) {
+    // Check for streaming status, it only waits when both blocks are in use.
+    const BOOLEAN ready = *reg == STREAMING_STATUS_READY;
+    if (!ready && (status != STREAMING_STATUS_FILLED || stream_block_size == STREAMING_BLOCK_SIZE)) {
         // Still busy, wait for ready.
         if (status == STREAMING_STATUS_FILLED)
             *(THIS->stack_ptr++) = val; // Push back the value.
@@ -35,11 +55,16 @@ void vm_stream(SCRIPT_CTX * THIS, UINT8 status) OLDCALL BANKED {
     }
 
     if (status == STREAMING_STATUS_FILLED) { // Fill a byte.
-        *reg = STREAMING_STATUS_BUSY;
-        *addr = (UINT8)val;
-        *reg = STREAMING_STATUS_FILLED;
+        if (stream_block_size == STREAMING_BLOCK_SIZE) // Full, hand it over.
+            stream_publish(STREAMING_STATUS_BLOCK);
+        stream_blocks[stream_block_index][stream_block_size++] = (UINT8)val;
+        if (stream_block_size == STREAMING_BLOCK_SIZE && ready) // Hand it over as soon as possible.
+            stream_publish(STREAMING_STATUS_BLOCK);
     } else /* if (status == STREAMING_STATUS_EOS) */ { // Mark the status as end-of-stream.
-        *reg = STREAMING_STATUS_EOS;
+        if (stream_block_size)
+            stream_publish(STREAMING_STATUS_BLOCK | STREAMING_STATUS_EOS);
+        else
+            *reg = STREAMING_STATUS_EOS;
     }
 }
 
@@ -61,7 +61,7 @@ void effects_pulse_update(void) BANKED {
             const UINT8 bank0 = get_uint8 (effects_pulse_bank, ptr++);
             UINT8 * addr0     = get_ptr_be(effects_pulse_bank, ptr  ); ptr += 2;
             ptr += 3;
-            call_v_bbp_oldcall(t, n, bank0, addr0, set_bkg_data);
+            graphics_load_tiles(t, n, bank0, addr0, set_bkg_data);
         }
         FEATURE_EFFECT_PULSE_SET;
     } else {
@@ -71,7 +71,7 @@ void effects_pulse_update(void) BANKED {
             ptr += 3;
             const UINT8 bank1 = get_uint8 (effects_pulse_bank, ptr++);
             UINT8 * addr1     = get_ptr_be(effects_pulse_bank, ptr  ); ptr += 2;
-            call_v_bbp_oldcall(t, n, bank1, addr1, set_bkg_data);
+            graphics_load_tiles(t, n, bank1, addr1, set_bkg_data);
         }
         FEATURE_EFFECT_PULSE_CLEAR;
     }
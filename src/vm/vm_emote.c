@@ -6,6 +6,7 @@
 #endif /* __SDCC */
 
 #include "vm_emote.h"
+#include "vm_graphics.h"
 
 BANKREF(VM_EMOTE)
 
@@ -193,7 +194,7 @@ void emote_update(void) BANKED {
 }
 
 STATIC UINT8 emote_def(UINT16 x, UINT16 y, UINT8 base_tile, BOOLEAN mirrored, UINT8 pal, actor_t * ref_actor, UINT8 bank, UINT8 * ptr) {
-    call_v_bbp_oldcall(base_tile, EMOTE_SPRITE_TILE_COUNT, bank, ptr, set_sprite_data);
+    graphics_load_tiles(base_tile, EMOTE_SPRITE_TILE_COUNT, bank, ptr, set_sprite_data);
 
     if (ref_actor) {
         x += TO_SCREEN(ref_actor->position.x);
@@ -35,6 +35,22 @@ void graphics_init(void) BANKED {
     graphics_map_y = 0;
 }
 
+void graphics_load_tiles(UINT8 first, UINT8 n, UINT8 bank, UINT8 * ptr, v_bbp_fn_oldcall func) BANKED {
+    if (!((UINT16)ptr & TILE_COMPRESSED_FLAG)) {
+        call_v_bbp_oldcall(first, n, bank, ptr, func);
+
+        return;
+    }
+
+    // Unpack the compressed tiles one by one, `n` of 0 is for 256 as the raw way.
+    UINT8 tile[16];
+    ptr = (UINT8 *)((UINT16)ptr & ~TILE_COMPRESSED_FLAG);
+    do {
+        ptr = get_tile(tile, bank, ptr);
+        func(first++, 1, tile);
+    } while (--n);
+}
+
 void graphics_put_map(void) BANKED {
     const INT16 x = scene_camera_x - graphics_map_x + scene_camera_shake_x;
     const INT16 y = scene_camera_y - graphics_map_y + scene_camera_shake_y;
@@ -184,7 +200,7 @@ void vm_image(SCRIPT_CTX * THIS, UINT8 src) OLDCALL BANKED {
     default:                      func = NULL;         break;
     }
 
-    call_v_bbp_oldcall(first, n, bank, ptr, func);
+    graphics_load_tiles(first, n, bank, ptr, func);
     UINT8 k = first;
     for (UINT8 j = 0; j != h; ++j) {
         for (UINT8 i = 0; i != w; ++i) {
@@ -232,7 +248,7 @@ void vm_fill_tile(SCRIPT_CTX * THIS, UINT8 src, UINT8 layer) OLDCALL BANKED {
     default:                      func = NULL;            break;
     }
 
-    call_v_bbp_oldcall(first, n, bank, ptr, func);
+    graphics_load_tiles(first, n, bank, ptr, func);
     gui_tile_filled(layer, first, n, bank, ptr);
 }
 
@@ -16,6 +16,8 @@ void graphics_init(void) BANKED;
 
 void graphics_put_map(void) BANKED;
 
+void graphics_load_tiles(UINT8 first, UINT8 n, UINT8 bank, UINT8 * ptr, v_bbp_fn_oldcall func) BANKED;
+
 void vm_color(SCRIPT_CTX * THIS) OLDCALL BANKED;
 void vm_palette(SCRIPT_CTX * THIS, UINT8 nsargs) OLDCALL BANKED;
 void vm_rgb(SCRIPT_CTX * THIS) OLDCALL BANKED;
@@ -70,7 +70,7 @@ void gui_clear(UINT8 base_tile, UINT16 n) BANKED {
     if (gui_tiles_bank) {
         switch (GUI_CATEGORY_TYPE(gui_widget_category)) {
         case GUI_WIDGET_TYPE_LABEL:
-            call_v_bbp_oldcall(
+            graphics_load_tiles(
                 gui_base_tile, gui_width * gui_height,
                 gui_tiles_bank, gui_tiles_address,
                 set_bkg_data
@@ -78,7 +78,7 @@ void gui_clear(UINT8 base_tile, UINT16 n) BANKED {
 
             break;
         case GUI_WIDGET_TYPE_PROGRESSBAR:
-            call_v_bbp_oldcall(
+            graphics_load_tiles(
                 gui_base_tile, GUI_PROGRESSBAR_TILE_COUNT,
                 gui_tiles_bank, gui_tiles_address,
                 set_bkg_data
@@ -86,7 +86,7 @@ void gui_clear(UINT8 base_tile, UINT16 n) BANKED {
 
             break;
         case GUI_WIDGET_TYPE_MENU:
-            call_v_bbp_oldcall(
+            graphics_load_tiles(
                 gui_base_tile, gui_width * gui_height,
                 gui_tiles_bank, gui_tiles_address,
                 set_bkg_data
@@ -601,7 +601,7 @@ void vm_load_scene(SCRIPT_CTX * THIS) OLDCALL BANKED {
 
     // Fill the tiles.
     SHOW_BKG;
-    call_v_bbp_oldcall(map_base_tile, tiles_count, tiles_bank, tiles_ptr, set_bkg_data);
+    graphics_load_tiles(map_base_tile, tiles_count, tiles_bank, tiles_ptr, set_bkg_data);
     gui_tile_filled(GRAPHICS_LAYER_MAP, map_base_tile, tiles_count, tiles_bank, tiles_ptr);
 
     // Setup the scene.